@@ -0,0 +1,91 @@
+#ifndef __BenchData__
+#define __BenchData__
+
+#include <cstddef>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "MachineLearning/ModelRepresentation/TrainingSet.h"
+
+/* BENCH DATA */
+// Deterministic synthetic inputs shared by the benchmarks, so a result only
+// changes when the code under test does.
+
+namespace BenchData {
+
+const std::size_t NumFeatures = 8;
+
+// Standard-normal features; Output is a noisy linear response, or its sign
+// as a 0/1 label when bBinary is set.
+inline ModelRepresentation::TrainingSet MakeTrainingSet(std::size_t NumRows,
+                                                        ModelRepresentation::GeneralisedFeature::DataType Type,
+                                                        bool bBinary = false)
+{
+	std::mt19937_64 Generator(42);
+	std::normal_distribution<double> Normal(0.0, 1.0);
+
+	std::vector<ModelRepresentation::GeneralisedFeature> Features;
+	std::vector<std::vector<double>> Columns(NumFeatures, std::vector<double>(NumRows));
+	std::vector<double> Outputs(NumRows);
+	for (std::size_t Feature = 0; Feature < NumFeatures; Feature++) {
+		Features.emplace_back("x" + std::to_string(Feature), "", Type);
+	}
+
+	for (std::size_t Row = 0; Row < NumRows; Row++) {
+		double Response = 0.5;
+		for (std::size_t Feature = 0; Feature < NumFeatures; Feature++) {
+			Columns[Feature][Row] = Normal(Generator);
+			Response += (Feature + 1) * 0.25 * Columns[Feature][Row];
+		}
+		Response += 0.1 * Normal(Generator);
+		Outputs[Row] = bBinary ? (Response > 0.0 ? 1.0 : 0.0) : Response;
+	}
+	return ModelRepresentation::TrainingSet(std::move(Features), std::move(Columns), std::move(Outputs));
+}
+
+
+// NumWideFeatures columns, each non-zero (standard normal) with probability
+// Density: the shape of scraped one-hot and bag-of-words inputs.
+const std::size_t NumWideFeatures = 128;
+
+inline ModelRepresentation::TrainingSet MakeWideTrainingSet(std::size_t NumRows, double Density,
+                                                            ModelRepresentation::GeneralisedFeature::DataType Type)
+{
+	std::mt19937_64 Generator(42);
+	std::normal_distribution<double> Normal(0.0, 1.0);
+	std::bernoulli_distribution Present(Density);
+
+	std::vector<ModelRepresentation::GeneralisedFeature> Features;
+	std::vector<std::vector<double>> Columns(NumWideFeatures, std::vector<double>(NumRows, 0.0));
+	std::vector<double> Outputs(NumRows);
+	for (std::size_t Feature = 0; Feature < NumWideFeatures; Feature++) {
+		Features.emplace_back("w" + std::to_string(Feature), "", Type);
+	}
+
+	for (std::size_t Row = 0; Row < NumRows; Row++) {
+		double Response = 0.5 + 0.1 * Normal(Generator);
+		for (std::size_t Feature = 0; Feature < NumWideFeatures; Feature++) {
+			if (Present(Generator)) {
+				Columns[Feature][Row] = Normal(Generator);
+				Response += 0.01 * static_cast<double>(Feature) * Columns[Feature][Row];
+			}
+		}
+		Outputs[Row] = Response;
+	}
+	return ModelRepresentation::TrainingSet(std::move(Features), std::move(Columns), std::move(Outputs));
+}
+
+
+inline std::vector<double> MakeTheta(double Scale = 0.1, std::size_t Count = NumFeatures)
+{
+	std::vector<double> Theta(Count + 1);
+	for (std::size_t Index = 0; Index < Theta.size(); Index++) {
+		Theta[Index] = Scale * static_cast<double>(Index);
+	}
+	return Theta;
+}
+
+} // namespace BenchData
+
+#endif // __BenchData__
@@ -0,0 +1,59 @@
+#!/usr/bin/env python3
+"""Compare two learnscrape_bench JSON result files.
+
+    python3 bench/CompareResults.py <baseline.json> <candidate.json> [--threshold 0.10]
+
+Prints the relative change in real time per benchmark. Exits with status 1
+when any benchmark is slower than the baseline by more than the threshold,
+so a CI job can fail on a regression. When the files were written with
+repetitions, the median aggregate is compared.
+"""
+
+import argparse
+import json
+import sys
+
+
+def load(path):
+    with open(path) as handle:
+        entries = json.load(handle)["benchmarks"]
+    medians = {e["run_name"]: e for e in entries if e.get("aggregate_name") == "median"}
+    if medians:
+        return {name: e["real_time"] for name, e in medians.items()}
+    return {e["name"]: e["real_time"] for e in entries if e.get("run_type", "iteration") == "iteration"}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("baseline")
+    parser.add_argument("candidate")
+    parser.add_argument("--threshold", type=float, default=0.10,
+                        help="relative slowdown that counts as a regression (default 0.10)")
+    args = parser.parse_args()
+
+    baseline = load(args.baseline)
+    candidate = load(args.candidate)
+
+    regressions = 0
+    width = max((len(name) for name in candidate), default=0)
+    for name in sorted(candidate):
+        if name not in baseline:
+            print(f"{name:<{width}}  new")
+            continue
+        change = candidate[name] / baseline[name] - 1.0
+        flag = ""
+        if change > args.threshold:
+            flag = "  REGRESSION"
+            regressions += 1
+        print(f"{name:<{width}}  {change:+7.1%}{flag}")
+    for name in sorted(set(baseline) - set(candidate)):
+        print(f"{name:<{width}}  removed")
+
+    if regressions:
+        print(f"{regressions} benchmark(s) slower by more than {args.threshold:.0%}", file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
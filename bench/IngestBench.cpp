@@ -0,0 +1,69 @@
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include "BenchData.h"
+#include "MachineLearning/ModelRepresentation/TrainingSet.h"
+
+using ModelRepresentation::GeneralisedFeature;
+using ModelRepresentation::TrainingSet;
+
+namespace {
+
+// A CSV of NumRows rows and BenchData::NumFeatures + 1 columns, removed
+// when the benchmark finishes.
+class TemporaryCsv {
+private:
+	std::string Path;
+
+public:
+	explicit TemporaryCsv(std::size_t NumRows)
+		: Path("learnscrape_bench_" + std::to_string(NumRows) + ".csv")
+	{
+		std::mt19937_64 Generator(7);
+		std::uniform_real_distribution<double> Uniform(-100.0, 100.0);
+		std::ofstream File(Path);
+		for (std::size_t Feature = 0; Feature < BenchData::NumFeatures; Feature++) {
+			File << "x" << Feature << " [unit],";
+		}
+		File << "y\n";
+
+		char Cell[32];
+		for (std::size_t Row = 0; Row < NumRows; Row++) {
+			for (std::size_t Column = 0; Column <= BenchData::NumFeatures; Column++) {
+				std::snprintf(Cell, sizeof(Cell), "%.6f", Uniform(Generator));
+				File << Cell << (Column < BenchData::NumFeatures ? ',' : '\n');
+			}
+		}
+	}
+
+	~TemporaryCsv() { std::remove(Path.c_str()); }
+
+	const std::string& GetPath() const { return Path; }
+};
+
+} // namespace
+
+
+// Rows x storage type.
+static void BM_LoadCsv(benchmark::State& State)
+{
+	const TemporaryCsv Csv(static_cast<std::size_t>(State.range(0)));
+	const auto Type = static_cast<GeneralisedFeature::DataType>(State.range(1));
+	std::ifstream Probe(Csv.GetPath(), std::ios::binary | std::ios::ate);
+	const int64_t FileBytes = static_cast<int64_t>(Probe.tellg());
+
+	for (auto _ : State) {
+		const TrainingSet Set = TrainingSet::LoadCsv(Csv.GetPath(), Type);
+		benchmark::DoNotOptimize(Set.GetOutputs());
+	}
+	State.SetItemsProcessed(State.iterations() * State.range(0));
+	State.SetBytesProcessed(State.iterations() * FileBytes);
+}
+BENCHMARK(BM_LoadCsv)
+	->ArgsProduct({{10000, 100000, 1000000}, {0, 1}})
+	->ArgNames({"rows", "storage"})
+	->Unit(benchmark::kMillisecond);
@@ -0,0 +1,163 @@
+#include <map>
+#include <tuple>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "BenchData.h"
+#include "MachineLearning/LinearRegression/CostFunction.h"
+#include "MachineLearning/LogisticRegression/CostFunction.h"
+#include "MachineLearning/LogisticRegression/SigmoidFunction.h"
+#include "MachineLearning/MeansClustering/CentroidAssignment.h"
+
+using ModelRepresentation::GeneralisedFeature;
+using ModelRepresentation::TrainingSet;
+using ModelRepresentation::TrainingView;
+
+namespace {
+
+// Benchmarks are run one after another, so building each set once is enough.
+const TrainingSet& CachedSet(std::size_t NumRows, GeneralisedFeature::DataType Type, bool bBinary)
+{
+	static std::map<std::tuple<std::size_t, GeneralisedFeature::DataType, bool>, TrainingSet> Sets;
+	const auto Key = std::make_tuple(NumRows, Type, bBinary);
+	auto Found = Sets.find(Key);
+	if (Found == Sets.end()) {
+		Found = Sets.emplace(Key, BenchData::MakeTrainingSet(NumRows, Type, bBinary)).first;
+	}
+	return Found->second;
+}
+
+
+GeneralisedFeature::DataType StorageArgument(const benchmark::State& State)
+{
+	return static_cast<GeneralisedFeature::DataType>(State.range(1));
+}
+
+
+void SetThroughput(benchmark::State& State, const TrainingSet& Set)
+{
+	State.SetItemsProcessed(State.iterations() * static_cast<int64_t>(Set.GetNumExamples()));
+	State.SetBytesProcessed(State.iterations() * static_cast<int64_t>(Set.GetNumExamples() * Set.GetBytesPerExample()));
+}
+
+
+// Rows x storage type (0 = float64, 1 = float32, 2 = bfloat16).
+void KernelArguments(benchmark::internal::Benchmark* Bench)
+{
+	for (int64_t Rows : {4096, 65536, 1 << 20}) {
+		for (int64_t Type : {0, 1, 2}) {
+			Bench->Args({Rows, Type});
+		}
+	}
+	Bench->ArgNames({"rows", "storage"})->Unit(benchmark::kMicrosecond);
+}
+
+} // namespace
+
+
+static void BM_LinearCostGradient(benchmark::State& State)
+{
+	const TrainingSet& Set = CachedSet(State.range(0), StorageArgument(State), false);
+	const TrainingView View(Set);
+	const std::vector<double> Theta = BenchData::MakeTheta();
+
+	for (auto _ : State) {
+		benchmark::DoNotOptimize(LinearRegression::ComputeCostGradient(View, Theta, 0.1));
+	}
+	SetThroughput(State, Set);
+}
+BENCHMARK(BM_LinearCostGradient)->Apply(KernelArguments);
+
+
+static void BM_LinearCost(benchmark::State& State)
+{
+	const TrainingSet& Set = CachedSet(State.range(0), StorageArgument(State), false);
+	const TrainingView View(Set);
+	const std::vector<double> Theta = BenchData::MakeTheta();
+
+	for (auto _ : State) {
+		benchmark::DoNotOptimize(LinearRegression::ComputeCost(View, Theta, 0.1));
+	}
+	SetThroughput(State, Set);
+}
+BENCHMARK(BM_LinearCost)->Apply(KernelArguments);
+
+
+static void BM_LogisticCostGradient(benchmark::State& State)
+{
+	const TrainingSet& Set = CachedSet(State.range(0), StorageArgument(State), true);
+	const TrainingView View(Set);
+	const std::vector<double> Theta = BenchData::MakeTheta();
+
+	for (auto _ : State) {
+		benchmark::DoNotOptimize(LogisticRegression::ComputeCostGradient(View, Theta, 0.1));
+	}
+	SetThroughput(State, Set);
+}
+BENCHMARK(BM_LogisticCostGradient)->Apply(KernelArguments);
+
+
+// Wide 5%-dense inputs stored dense (0) or in the CSR block (3).
+static void BM_WideLinearCostGradient(benchmark::State& State)
+{
+	const TrainingSet Set = BenchData::MakeWideTrainingSet(State.range(0), 0.05, StorageArgument(State));
+	const TrainingView View(Set);
+	const std::vector<double> Theta = BenchData::MakeTheta(0.01, BenchData::NumWideFeatures);
+
+	for (auto _ : State) {
+		benchmark::DoNotOptimize(LinearRegression::ComputeCostGradient(View, Theta, 0.1));
+	}
+	SetThroughput(State, Set);
+}
+BENCHMARK(BM_WideLinearCostGradient)
+	->ArgsProduct({{65536, 1 << 18}, {0, 3}})
+	->ArgNames({"rows", "storage"})
+	->Unit(benchmark::kMicrosecond);
+
+
+static void BM_Sigmoid(benchmark::State& State)
+{
+	const std::size_t Count = static_cast<std::size_t>(State.range(0));
+	std::vector<double> Source(Count);
+	for (std::size_t Index = 0; Index < Count; Index++) {
+		Source[Index] = -8.0 + 16.0 * static_cast<double>(Index) / static_cast<double>(Count);
+	}
+	std::vector<double> Values(Count);
+
+	for (auto _ : State) {
+		State.PauseTiming();
+		Values = Source;
+		State.ResumeTiming();
+		LogisticRegression::Sigmoid(Values.data(), Count);
+		benchmark::ClobberMemory();
+	}
+	State.SetItemsProcessed(State.iterations() * static_cast<int64_t>(Count));
+}
+BENCHMARK(BM_Sigmoid)->RangeMultiplier(16)->Range(4096, 1 << 20)->ArgName("values")->Unit(benchmark::kMicrosecond);
+
+
+// Rows x clusters x storage type.
+static void BM_AssignCentroids(benchmark::State& State)
+{
+	const TrainingSet& Set = CachedSet(State.range(0), static_cast<GeneralisedFeature::DataType>(State.range(2)), false);
+	const TrainingView View(Set);
+	const std::size_t NumClusters = static_cast<std::size_t>(State.range(1));
+
+	std::vector<double> Centroids(NumClusters * Set.GetNumFeatures());
+	for (std::size_t Cluster = 0; Cluster < NumClusters; Cluster++) {
+		for (std::size_t Feature = 0; Feature < Set.GetNumFeatures(); Feature++) {
+			Centroids[Cluster * Set.GetNumFeatures() + Feature] = Set.GetValue(Feature, Cluster);
+		}
+	}
+	std::vector<std::size_t> Assignment;
+
+	for (auto _ : State) {
+		benchmark::DoNotOptimize(MeansClustering::AssignCentroids(View, Centroids, NumClusters, Assignment));
+	}
+	SetThroughput(State, Set);
+}
+BENCHMARK(BM_AssignCentroids)
+	->ArgsProduct({{65536, 1 << 20}, {8, 32}, {0, 1}})
+	->ArgNames({"rows", "clusters", "storage"})
+	->Unit(benchmark::kMicrosecond);
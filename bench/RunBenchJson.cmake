@@ -0,0 +1,30 @@
+# Script behind the bench_json target. The label is resolved here, when the
+# target runs, rather than at configure time, so results land under the
+# commit that was actually built even if cmake was not re-run after it.
+
+if(BENCH_LABEL STREQUAL "" AND GIT_EXECUTABLE)
+  execute_process(
+    COMMAND ${GIT_EXECUTABLE} rev-parse --short HEAD
+    WORKING_DIRECTORY ${SOURCE_DIRECTORY}
+    OUTPUT_VARIABLE BENCH_LABEL
+    OUTPUT_STRIP_TRAILING_WHITESPACE
+    ERROR_QUIET
+  )
+endif()
+if(BENCH_LABEL STREQUAL "")
+  set(BENCH_LABEL latest)
+endif()
+
+set(BENCH_FILE ${BENCH_OUTPUT_DIRECTORY}/${BENCH_LABEL}.json)
+message(STATUS "Writing benchmark results to ${BENCH_FILE}")
+execute_process(
+  COMMAND ${BENCH_EXECUTABLE}
+    --benchmark_out=${BENCH_FILE}
+    --benchmark_out_format=json
+    --benchmark_repetitions=5
+    --benchmark_report_aggregates_only=true
+  RESULT_VARIABLE BENCH_STATUS
+)
+if(NOT BENCH_STATUS EQUAL 0)
+  message(FATAL_ERROR "Benchmark run failed (${BENCH_STATUS})")
+endif()
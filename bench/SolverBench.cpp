@@ -0,0 +1,138 @@
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "NumericalAlgorithms/InterpolationAlgorithms/CubicSpline.h"
+#include "NumericalAlgorithms/OptimisationAlgorithms/ConjugateGradients.h"
+#include "NumericalAlgorithms/OptimisationAlgorithms/SteepestDescent.h"
+
+using OptimisationAlgorithms::SolverOptions;
+using OptimisationAlgorithms::SolverResult;
+using OptimisationAlgorithms::SparseMatrix;
+using OptimisationAlgorithms::SymmetricMatrix;
+
+namespace {
+
+// Same inputs as the standalone optimisation program: the banded test matrix
+// with b and the starting x drawn uniformly from [0, 1).
+const double BandDecay = 0.5;
+
+std::vector<double> UniformVector(std::size_t Size, unsigned Seed)
+{
+	std::mt19937_64 Generator(Seed);
+	std::uniform_real_distribution<double> Uniform(0.0, 1.0);
+	std::vector<double> Values(Size);
+	for (double& Value : Values) {
+		Value = Uniform(Generator);
+	}
+	return Values;
+}
+
+
+template <typename Solver>
+void RunSolver(benchmark::State& State, Solver Solve)
+{
+	const std::size_t Size = static_cast<std::size_t>(State.range(0));
+	const SymmetricMatrix A = SymmetricMatrix::Banded(Size, BandDecay);
+	const std::vector<double> B = UniformVector(Size, 1);
+	const std::vector<double> Start = UniformVector(Size, 2);
+	std::vector<double> X;
+	SolverResult Result{0, 0.0, false};
+
+	for (auto _ : State) {
+		X = Start;
+		Result = Solve(A, B, X, SolverOptions());
+		benchmark::DoNotOptimize(X.data());
+	}
+	if (!Result.bConverged) {
+		State.SkipWithError("solver did not converge");
+	}
+	State.counters["solver_iterations"] = static_cast<double>(Result.Iterations);
+	// One dense mat-vec per iteration dominates.
+	State.SetBytesProcessed(State.iterations() * static_cast<int64_t>(Result.Iterations * Size * Size * sizeof(double)));
+}
+
+} // namespace
+
+
+static void BM_SteepestDescent(benchmark::State& State)
+{
+	RunSolver(State, OptimisationAlgorithms::SolveSteepestDescent);
+}
+BENCHMARK(BM_SteepestDescent)->Arg(101)->Arg(401)->Arg(1601)->ArgName("n")->Unit(benchmark::kMicrosecond);
+
+
+static void BM_ConjugateGradients(benchmark::State& State)
+{
+	RunSolver(State, OptimisationAlgorithms::SolveConjugateGradients);
+}
+BENCHMARK(BM_ConjugateGradients)->Arg(101)->Arg(401)->Arg(1601)->ArgName("n")->Unit(benchmark::kMicrosecond);
+
+
+// The banded matrix with entries below 1e-12 dropped: about 80 per row.
+static void BM_ConjugateGradientsSparse(benchmark::State& State)
+{
+	const std::size_t Size = static_cast<std::size_t>(State.range(0));
+	const SparseMatrix A = SparseMatrix::FromDense(SymmetricMatrix::Banded(Size, BandDecay), 1.0e-12);
+	const std::vector<double> B = UniformVector(Size, 1);
+	const std::vector<double> Start = UniformVector(Size, 2);
+	std::vector<double> X;
+	SolverResult Result{0, 0.0, false};
+
+	for (auto _ : State) {
+		X = Start;
+		Result = OptimisationAlgorithms::SolveConjugateGradients(A, B, X, SolverOptions());
+		benchmark::DoNotOptimize(X.data());
+	}
+	if (!Result.bConverged) {
+		State.SkipWithError("solver did not converge");
+	}
+	State.counters["solver_iterations"] = static_cast<double>(Result.Iterations);
+	State.counters["nonzeros"] = static_cast<double>(A.GetNumNonZeros());
+}
+BENCHMARK(BM_ConjugateGradientsSparse)->Arg(401)->Arg(1601)->ArgName("n")->Unit(benchmark::kMicrosecond);
+
+
+static void BM_SymmetricTridiagonal(benchmark::State& State)
+{
+	const std::size_t Size = static_cast<std::size_t>(State.range(0));
+	const std::vector<double> Diagonal(Size, 4.0);
+	const std::vector<double> OffDiagonal(Size - 1, 1.0);
+	const std::vector<double> B = UniformVector(Size, 3);
+	std::vector<double> X;
+
+	for (auto _ : State) {
+		X = B;
+		InterpolationAlgorithms::SolveSymmetricTridiagonal(Diagonal, OffDiagonal, X);
+		benchmark::DoNotOptimize(X.data());
+	}
+	State.SetItemsProcessed(State.iterations() * static_cast<int64_t>(Size));
+}
+BENCHMARK(BM_SymmetricTridiagonal)->RangeMultiplier(16)->Range(1024, 1 << 20)->ArgName("n")->Unit(benchmark::kMicrosecond);
+
+
+// Fit sin(x) on [0, 2 pi] with n knots, then evaluate at 4n points.
+static void BM_CubicSplineSine(benchmark::State& State)
+{
+	const std::size_t Size = static_cast<std::size_t>(State.range(0));
+	const double Pi = std::acos(-1.0);
+	const double Spacing = 2.0 * Pi / static_cast<double>(Size - 1);
+	std::vector<double> Values(Size);
+	for (std::size_t Index = 0; Index < Size; Index++) {
+		Values[Index] = std::sin(static_cast<double>(Index) * Spacing);
+	}
+	const std::size_t NumQueries = 4 * Size;
+
+	for (auto _ : State) {
+		const InterpolationAlgorithms::CubicSpline Spline(0.0, Spacing, Values);
+		double Sum = 0.0;
+		for (std::size_t Query = 0; Query < NumQueries; Query++) {
+			Sum += Spline.Evaluate(2.0 * Pi * static_cast<double>(Query) / static_cast<double>(NumQueries));
+		}
+		benchmark::DoNotOptimize(Sum);
+	}
+	State.SetItemsProcessed(State.iterations() * static_cast<int64_t>(NumQueries));
+}
+BENCHMARK(BM_CubicSplineSine)->Arg(10)->Arg(1000)->Arg(100000)->ArgName("n")->Unit(benchmark::kMicrosecond);
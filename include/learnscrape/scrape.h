@@ -1,4 +1,18 @@
 #ifndef __scrape__
 #define __scrape__
 
+// scrape.h
+// Public entry point for the web-scraping half of the library: the HTTP
+// client, the retrying page fetcher, record extraction, the on-disk page
+// cache and the concurrent pipeline that turns a URL list into a
+// TrainingSet. This C++ path replaces the Ruby prototype in
+// src/netvoyager.rb, which is deliberately left unchanged and does not use
+// the page cache.
+
+#include "WebScraping/HttpClient.h"
+#include "WebScraping/PageCache.h"
+#include "WebScraping/PageFetcher.h"
+#include "WebScraping/RecordExtraction.h"
+#include "WebScraping/ScrapePipeline.h"
+
 #endif // __scrape__
@@ -0,0 +1,142 @@
+#ifndef __ConcurrentQueue__
+#define __ConcurrentQueue__
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+/* CONCURRENT QUEUE */
+// Bounded multi-producer multi-consumer queue (Vyukov's ring). Each cell
+// carries a sequence number telling producers and consumers whether it is
+// free or full on their lap, so a push or pop is one compare-and-swap on the
+// shared position plus a release store on the cell: pipeline stages hand
+// items over without a lock. The bound gives back-pressure; callers that
+// find the queue full or empty decide how to wait (see QueueBackoff).
+
+namespace CoreUtilities {
+
+template <typename ElementType>
+class BoundedQueue {
+private:
+	struct Cell {
+		std::atomic<std::size_t> Sequence;
+		ElementType Value;
+	};
+
+	std::unique_ptr<Cell[]> Cells;
+	std::size_t Mask;
+	alignas(64) std::atomic<std::size_t> PushPosition;
+	alignas(64) std::atomic<std::size_t> PopPosition;
+
+public:
+	// Capacity is rounded up to a power of two.
+	explicit BoundedQueue(std::size_t Capacity);
+	BoundedQueue(const BoundedQueue&) = delete;
+	BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+	std::size_t GetCapacity() const { return Mask + 1; }
+
+	// Move Value in and return true, or leave it untouched if the queue is full.
+	bool TryPush(ElementType&& Value);
+	// Move the oldest element into Out and return true, or false if empty.
+	bool TryPop(ElementType& Out);
+};
+
+
+// Spin briefly, then yield, then sleep: for a thread polling a queue that
+// is momentarily full or empty. Reset() after each success.
+class QueueBackoff {
+private:
+	unsigned Attempts = 0;
+
+public:
+	void Reset() { Attempts = 0; }
+	void Wait()
+	{
+		if (Attempts < 16) {
+			std::this_thread::yield();
+		} else {
+			std::this_thread::sleep_for(std::chrono::microseconds(Attempts < 64 ? 50 : 500));
+		}
+		Attempts++;
+	}
+};
+
+
+/*============================================================================*/
+// TEMPLATE DEFINITIONS
+/*============================================================================*/
+
+template <typename ElementType>
+BoundedQueue<ElementType>::BoundedQueue(std::size_t Capacity)
+	: PushPosition(0), PopPosition(0)
+{
+	if (Capacity == 0) {
+		throw std::invalid_argument("BoundedQueue: capacity must be positive");
+	}
+	std::size_t Size = 1;
+	while (Size < Capacity) {
+		Size <<= 1;
+	}
+	Cells.reset(new Cell[Size]);
+	Mask = Size - 1;
+	for (std::size_t Index = 0; Index < Size; Index++) {
+		Cells[Index].Sequence.store(Index, std::memory_order_relaxed);
+	}
+}
+
+
+template <typename ElementType>
+bool BoundedQueue<ElementType>::TryPush(ElementType&& Value)
+{
+	std::size_t Position = PushPosition.load(std::memory_order_relaxed);
+	for (;;) {
+		Cell& Target = Cells[Position & Mask];
+		const std::size_t Sequence = Target.Sequence.load(std::memory_order_acquire);
+		const std::ptrdiff_t Lap = static_cast<std::ptrdiff_t>(Sequence) - static_cast<std::ptrdiff_t>(Position);
+
+		if (Lap == 0) {
+			if (PushPosition.compare_exchange_weak(Position, Position + 1, std::memory_order_relaxed)) {
+				Target.Value = std::move(Value);
+				Target.Sequence.store(Position + 1, std::memory_order_release);
+				return true;
+			}
+		} else if (Lap < 0) {
+			return false;
+		} else {
+			Position = PushPosition.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+
+template <typename ElementType>
+bool BoundedQueue<ElementType>::TryPop(ElementType& Out)
+{
+	std::size_t Position = PopPosition.load(std::memory_order_relaxed);
+	for (;;) {
+		Cell& Source = Cells[Position & Mask];
+		const std::size_t Sequence = Source.Sequence.load(std::memory_order_acquire);
+		const std::ptrdiff_t Lap = static_cast<std::ptrdiff_t>(Sequence) - static_cast<std::ptrdiff_t>(Position + 1);
+
+		if (Lap == 0) {
+			if (PopPosition.compare_exchange_weak(Position, Position + 1, std::memory_order_relaxed)) {
+				Out = std::move(Source.Value);
+				Source.Sequence.store(Position + Mask + 1, std::memory_order_release);
+				return true;
+			}
+		} else if (Lap < 0) {
+			return false;
+		} else {
+			Position = PopPosition.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+} // namespace CoreUtilities
+
+#endif // __ConcurrentQueue__
@@ -0,0 +1,435 @@
+#include "CoreUtilities/InferenceServer.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "CoreUtilities/ReportGeneration.h"
+#include "CoreUtilities/TaskScheduler.h"
+
+namespace CoreUtilities {
+
+namespace {
+
+const std::size_t HeaderBytes = 2 * sizeof(std::uint32_t);
+const std::size_t ReadChunkBytes = 64 * 1024;
+const int PollTimeoutMilliseconds = 100;
+const std::size_t ParallelBatchRows = 4096;
+
+
+sockaddr_un SocketAddress(const std::string& Path)
+{
+	sockaddr_un Address;
+	std::memset(&Address, 0, sizeof(Address));
+	Address.sun_family = AF_UNIX;
+	if (Path.size() >= sizeof(Address.sun_path)) {
+		throw std::runtime_error("InferenceServer: socket path too long: " + Path);
+	}
+	std::strncpy(Address.sun_path, Path.c_str(), sizeof(Address.sun_path) - 1);
+	return Address;
+}
+
+
+void AppendHeader(std::vector<char>& Buffer, std::uint32_t First, std::uint32_t Second)
+{
+	const std::size_t Offset = Buffer.size();
+	Buffer.resize(Offset + HeaderBytes);
+	std::memcpy(&Buffer[Offset], &First, sizeof(First));
+	std::memcpy(&Buffer[Offset + sizeof(First)], &Second, sizeof(Second));
+}
+
+
+bool SendAll(int Descriptor, const char* Data, std::size_t Size)
+{
+	while (Size > 0) {
+		const ssize_t Sent = ::send(Descriptor, Data, Size, MSG_NOSIGNAL);
+		if (Sent < 0 && errno == EINTR) {
+			continue;
+		}
+		if (Sent <= 0) {
+			return false;
+		}
+		Data += Sent;
+		Size -= static_cast<std::size_t>(Sent);
+	}
+	return true;
+}
+
+
+bool ReceiveAll(int Descriptor, char* Data, std::size_t Size)
+{
+	while (Size > 0) {
+		const ssize_t Received = ::recv(Descriptor, Data, Size, 0);
+		if (Received < 0 && errno == EINTR) {
+			continue;
+		}
+		if (Received <= 0) {
+			return false;
+		}
+		Data += Received;
+		Size -= static_cast<std::size_t>(Received);
+	}
+	return true;
+}
+
+} // namespace
+
+
+/*============================================================================*/
+// INFERENCE SERVER
+/*============================================================================*/
+
+InferenceServer::InferenceServer(const ModelRepresentation::MappedModel& InModel, std::string InSocketPath,
+                                 InferenceServerOptions InOptions)
+	: Model(InModel),
+	  SocketPath(std::move(InSocketPath)),
+	  Options(InOptions),
+	  ListenDescriptor(-1),
+	  InputLimit(HeaderBytes + sizeof(double) * InOptions.MaxBatchRows * InModel.GetNumFeatures()),
+	  OutputLimit(HeaderBytes + sizeof(double) * InOptions.MaxBatchRows),
+	  BatchInputs(InOptions.MaxBatchRows * InModel.GetNumFeatures()),
+	  BatchOutputs(InOptions.MaxBatchRows),
+	  bStopping(false)
+{
+	const sockaddr_un Address = SocketAddress(SocketPath);
+
+	ListenDescriptor = ::socket(AF_UNIX, SOCK_STREAM, 0);
+	if (ListenDescriptor < 0) {
+		throw std::runtime_error("InferenceServer: cannot create socket");
+	}
+	::unlink(SocketPath.c_str());
+	if (::bind(ListenDescriptor, reinterpret_cast<const sockaddr*>(&Address), sizeof(Address)) != 0 ||
+	    ::listen(ListenDescriptor, Options.Backlog) != 0) {
+		::close(ListenDescriptor);
+		throw std::runtime_error("InferenceServer: cannot listen on " + SocketPath + ": " + std::strerror(errno));
+	}
+	::fcntl(ListenDescriptor, F_SETFL, O_NONBLOCK);
+}
+
+
+InferenceServer::~InferenceServer()
+{
+	for (Client& Connection : Clients) {
+		::close(Connection.Descriptor);
+	}
+	if (ListenDescriptor >= 0) {
+		::close(ListenDescriptor);
+		::unlink(SocketPath.c_str());
+	}
+}
+
+
+void InferenceServer::AcceptClients()
+{
+	for (;;) {
+		const int Descriptor = ::accept(ListenDescriptor, nullptr, nullptr);
+		if (Descriptor < 0) {
+			return;
+		}
+		::fcntl(Descriptor, F_SETFL, O_NONBLOCK);
+
+		Client Connection;
+		Connection.Descriptor = Descriptor;
+		Connection.Input.resize(ReadChunkBytes);
+		Connection.InputUsed = 0;
+		Connection.DiscardBytes = 0;
+		Connection.bInputClosed = false;
+		Connection.Output.reserve(OutputLimit);
+		Connection.OutputSent = 0;
+		Connection.bOutputBlocked = false;
+		Connection.bClosing = false;
+		Clients.push_back(std::move(Connection));
+	}
+}
+
+
+bool InferenceServer::ReadClient(Client& Connection)
+{
+	while (Connection.InputUsed < InputLimit) {
+		if (Connection.Input.size() - Connection.InputUsed < ReadChunkBytes) {
+			Connection.Input.resize(std::min(Connection.InputUsed + ReadChunkBytes, InputLimit));
+		}
+		const ssize_t Received = ::recv(Connection.Descriptor, &Connection.Input[Connection.InputUsed],
+		                                Connection.Input.size() - Connection.InputUsed, 0);
+		if (Received > 0) {
+			Connection.InputUsed += static_cast<std::size_t>(Received);
+			continue;
+		}
+		if (Received == 0) {
+			// Half-closed: what is buffered is still answered.
+			Connection.bInputClosed = true;
+			return true;
+		}
+		if (errno == EAGAIN || errno == EWOULDBLOCK) {
+			return true;
+		}
+		if (errno != EINTR) {
+			return false;
+		}
+	}
+	return true;
+}
+
+
+bool InferenceServer::WriteClient(Client& Connection)
+{
+	while (Connection.OutputSent < Connection.Output.size()) {
+		const ssize_t Sent = ::send(Connection.Descriptor, &Connection.Output[Connection.OutputSent],
+		                            Connection.Output.size() - Connection.OutputSent, MSG_NOSIGNAL);
+		if (Sent > 0) {
+			Connection.OutputSent += static_cast<std::size_t>(Sent);
+			continue;
+		}
+		if (Sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+			return true;
+		}
+		if (Sent < 0 && errno == EINTR) {
+			continue;
+		}
+		return false;
+	}
+
+	// Fully flushed: keep the capacity for the next response.
+	Connection.Output.clear();
+	Connection.OutputSent = 0;
+	return true;
+}
+
+
+bool InferenceServer::GatherBatch(std::size_t& BatchRows)
+{
+	const std::size_t NumFeatures = Model.GetNumFeatures();
+	bool bMoreBuffered = false;
+
+	Pending.clear();
+	BatchRows = 0;
+
+	for (std::size_t Index = 0; Index < Clients.size(); Index++) {
+		Client& Connection = Clients[Index];
+		// Drop the flushed front so the responses below fit the reserved
+		// buffer without reallocating.
+		if (Connection.OutputSent > 0) {
+			Connection.Output.erase(Connection.Output.begin(), Connection.Output.begin() + Connection.OutputSent);
+			Connection.OutputSent = 0;
+		}
+		std::size_t Unsent = Connection.Output.size();
+		Connection.bOutputBlocked = false;
+
+		std::size_t Consumed = static_cast<std::size_t>(std::min<std::uint64_t>(Connection.DiscardBytes,
+		                                                                        Connection.InputUsed));
+		Connection.DiscardBytes -= Consumed;
+		bool bDeferred = false;
+
+		while (!Connection.bClosing && Connection.DiscardBytes == 0 && Connection.InputUsed - Consumed >= HeaderBytes) {
+			std::uint32_t NumRows, RequestFeatures;
+			std::memcpy(&NumRows, &Connection.Input[Consumed], sizeof(NumRows));
+			std::memcpy(&RequestFeatures, &Connection.Input[Consumed + sizeof(NumRows)], sizeof(RequestFeatures));
+
+			// Judge the request on its header alone, so a bad one is never buffered.
+			const bool bTooLarge = NumRows > Options.MaxBatchRows;
+			const bool bMismatch = !bTooLarge && RequestFeatures != NumFeatures;
+			const std::size_t ResponseBytes = HeaderBytes + (bTooLarge || bMismatch ? 0 : sizeof(double) * NumRows);
+			if (Unsent + ResponseBytes > OutputLimit) {
+				// Wait until the client reads what it already has.
+				Connection.bOutputBlocked = true;
+				bDeferred = true;
+				break;
+			}
+
+			if (bTooLarge) {
+				Pending.push_back({Index, 0, 0, InferenceStatus::TooLarge});
+				Connection.bClosing = true;
+				break;
+			}
+			const std::uint64_t BodyBytes = std::uint64_t(sizeof(double)) * NumRows * RequestFeatures;
+			if (bMismatch) {
+				Pending.push_back({Index, NumRows, 0, InferenceStatus::FeatureMismatch});
+				Unsent += ResponseBytes;
+				Consumed += HeaderBytes;
+				const std::uint64_t Buffered = std::min<std::uint64_t>(BodyBytes, Connection.InputUsed - Consumed);
+				Consumed += static_cast<std::size_t>(Buffered);
+				Connection.DiscardBytes = BodyBytes - Buffered;
+				continue;
+			}
+
+			if (Connection.InputUsed - Consumed < HeaderBytes + BodyBytes) {
+				break;
+			}
+			if (BatchRows + NumRows > Options.MaxBatchRows) {
+				bMoreBuffered = true;
+				bDeferred = true;
+				break;
+			}
+
+			std::memcpy(&BatchInputs[BatchRows * NumFeatures], &Connection.Input[Consumed + HeaderBytes], BodyBytes);
+			Pending.push_back({Index, NumRows, BatchRows, InferenceStatus::Ok});
+			Unsent += ResponseBytes;
+			BatchRows += NumRows;
+			Consumed += HeaderBytes + BodyBytes;
+		}
+
+		if (Consumed > 0) {
+			std::memmove(Connection.Input.data(), &Connection.Input[Consumed], Connection.InputUsed - Consumed);
+			Connection.InputUsed -= Consumed;
+		}
+		// Every complete request from a half-closed client is now answered;
+		// close once the responses are flushed.
+		if (Connection.bInputClosed && !bDeferred) {
+			Connection.bClosing = true;
+		}
+	}
+	return bMoreBuffered;
+}
+
+
+void InferenceServer::EvaluateBatch(std::size_t BatchRows)
+{
+	const std::size_t NumFeatures = Model.GetNumFeatures();
+	LEARNSCRAPE_SCOPED_TIMER(ReportPhase::Inference);
+	LEARNSCRAPE_RECORD_VOLUME(ReportPhase::Inference, BatchRows, BatchRows * (NumFeatures + 1) * sizeof(double));
+
+	if (BatchRows < ParallelBatchRows) {
+		Model.Predict(BatchInputs.data(), BatchRows, BatchOutputs.data());
+		return;
+	}
+	TaskScheduler::Get().ParallelFor(0, BatchRows, ParallelBatchRows / 4, [&](std::size_t Begin, std::size_t End) {
+		Model.Predict(&BatchInputs[Begin * NumFeatures], End - Begin, &BatchOutputs[Begin]);
+	});
+}
+
+
+void InferenceServer::ScatterResponses()
+{
+	for (const PendingRequest& Request : Pending) {
+		std::vector<char>& Output = Clients[Request.ClientIndex].Output;
+		const bool bOk = (Request.Status == InferenceStatus::Ok);
+
+		AppendHeader(Output, static_cast<std::uint32_t>(Request.NumRows), static_cast<std::uint32_t>(Request.Status));
+		if (bOk) {
+			const std::size_t Offset = Output.size();
+			Output.resize(Offset + sizeof(double) * Request.NumRows);
+			std::memcpy(&Output[Offset], &BatchOutputs[Request.BatchOffset], sizeof(double) * Request.NumRows);
+		}
+	}
+}
+
+
+void InferenceServer::Serve()
+{
+	std::vector<pollfd> Descriptors;
+	bool bMoreBuffered = false;
+
+	while (!bStopping.load()) {
+		Descriptors.clear();
+		Descriptors.push_back({ListenDescriptor, POLLIN, 0});
+		for (const Client& Connection : Clients) {
+			// A full input buffer, or a client not reading its responses, is
+			// left in the socket until the batch loop catches up.
+			const bool bReadable = !Connection.bInputClosed && !Connection.bOutputBlocked &&
+			                       Connection.InputUsed < InputLimit;
+			const short Events = (bReadable ? POLLIN : 0) | (Connection.OutputSent < Connection.Output.size() ? POLLOUT : 0);
+			Descriptors.push_back({Connection.Descriptor, Events, 0});
+		}
+
+		const int Ready = ::poll(Descriptors.data(), Descriptors.size(), bMoreBuffered ? 0 : PollTimeoutMilliseconds);
+		if (Ready < 0 && errno != EINTR) {
+			throw std::runtime_error(std::string("InferenceServer: poll failed: ") + std::strerror(errno));
+		}
+
+		if (Ready > 0 && (Descriptors[0].revents & POLLIN)) {
+			AcceptClients();
+		}
+		for (std::size_t Index = 1; Ready > 0 && Index < Descriptors.size(); Index++) {
+			if ((Descriptors[Index].events & POLLIN) && (Descriptors[Index].revents & (POLLIN | POLLHUP | POLLERR))) {
+				if (!ReadClient(Clients[Index - 1])) {
+					Clients[Index - 1].bClosing = true;
+				}
+			}
+		}
+
+		std::size_t BatchRows = 0;
+		bMoreBuffered = GatherBatch(BatchRows);
+		if (BatchRows > 0) {
+			EvaluateBatch(BatchRows);
+		}
+		ScatterResponses();
+
+		for (Client& Connection : Clients) {
+			if (!WriteClient(Connection)) {
+				Connection.bClosing = true;
+				Connection.Output.clear();
+			}
+			// Its responses are gone, so its waiting request fits now.
+			if (Connection.bOutputBlocked && Connection.Output.empty()) {
+				bMoreBuffered = true;
+			}
+		}
+
+		// Drop closed clients once their final responses have been flushed.
+		Clients.erase(std::remove_if(Clients.begin(), Clients.end(), [](const Client& Connection) {
+			if (Connection.bClosing && Connection.OutputSent >= Connection.Output.size()) {
+				::close(Connection.Descriptor);
+				return true;
+			}
+			return false;
+		}), Clients.end());
+	}
+}
+
+
+/*============================================================================*/
+// INFERENCE CLIENT
+/*============================================================================*/
+
+InferenceClient::InferenceClient(const std::string& SocketPath)
+{
+	const sockaddr_un Address = SocketAddress(SocketPath);
+
+	Descriptor = ::socket(AF_UNIX, SOCK_STREAM, 0);
+	if (Descriptor < 0 ||
+	    ::connect(Descriptor, reinterpret_cast<const sockaddr*>(&Address), sizeof(Address)) != 0) {
+		if (Descriptor >= 0) {
+			::close(Descriptor);
+		}
+		throw std::runtime_error("InferenceClient: cannot connect to " + SocketPath);
+	}
+}
+
+
+InferenceClient::~InferenceClient()
+{
+	::close(Descriptor);
+}
+
+
+InferenceStatus InferenceClient::Predict(const double* Inputs, std::size_t NumRows, std::size_t NumFeatures,
+                                         std::vector<double>& Outputs)
+{
+	std::vector<char> Request;
+	AppendHeader(Request, static_cast<std::uint32_t>(NumRows), static_cast<std::uint32_t>(NumFeatures));
+	if (!SendAll(Descriptor, Request.data(), Request.size()) ||
+	    !SendAll(Descriptor, reinterpret_cast<const char*>(Inputs), sizeof(double) * NumRows * NumFeatures)) {
+		throw std::runtime_error("InferenceClient: connection lost");
+	}
+
+	std::uint32_t Header[2];
+	if (!ReceiveAll(Descriptor, reinterpret_cast<char*>(Header), sizeof(Header))) {
+		throw std::runtime_error("InferenceClient: connection lost");
+	}
+	const InferenceStatus Status = static_cast<InferenceStatus>(Header[1]);
+	Outputs.resize(Status == InferenceStatus::Ok ? Header[0] : 0);
+	if (!Outputs.empty() && !ReceiveAll(Descriptor, reinterpret_cast<char*>(Outputs.data()), sizeof(double) * Outputs.size())) {
+		throw std::runtime_error("InferenceClient: connection lost");
+	}
+	return Status;
+}
+
+} // namespace CoreUtilities
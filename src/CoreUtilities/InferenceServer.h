@@ -0,0 +1,125 @@
+#ifndef __InferenceServer__
+#define __InferenceServer__
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "MachineLearning/ModelRepresentation/ModelFile.h"
+
+/* INFERENCE SERVER */
+// Long-running prediction service for a memory-mapped model, reached over a
+// local Unix stream socket so callers avoid a process start per prediction.
+//
+//   Request : uint32 NumRows, uint32 NumFeatures, double Inputs[NumRows * NumFeatures]
+//   Response: uint32 NumRows, uint32 Status,      double Outputs[NumRows]
+//
+// Inputs are raw feature values, row-major, in native byte order. Every
+// poll round gathers all complete requests from all connected clients into
+// one batch, evaluates it in a single pass and scatters the responses. The
+// batch buffers are allocated once up front, and each client's response
+// buffer once when it connects.
+//
+// A request is checked as soon as its header arrives: a wrong feature count
+// is answered at once and its body discarded unread, and an oversized row
+// count is answered and the connection closed. A client never has more
+// than one largest-possible request buffered; reading from it pauses until
+// the batch loop catches up. Likewise a client never has more than one
+// largest-possible response waiting to be sent; until it reads them, its
+// further requests are neither read nor batched. A client that half-closes
+// its end still gets answers to every complete request it sent.
+
+namespace CoreUtilities {
+
+enum class InferenceStatus : std::uint32_t {
+	Ok = 0,
+	FeatureMismatch = 1,
+	TooLarge = 2
+};
+
+struct InferenceServerOptions {
+	// Largest batch evaluated at once; a single request may not exceed it.
+	std::size_t MaxBatchRows = 65536;
+	int Backlog = 64;
+};
+
+
+class InferenceServer {
+private:
+	struct Client {
+		int Descriptor;
+		std::vector<char> Input;
+		std::size_t InputUsed;
+		// Body bytes of a rejected request still to be dropped as they arrive.
+		std::uint64_t DiscardBytes;
+		bool bInputClosed;
+		std::vector<char> Output;
+		std::size_t OutputSent;
+		// A request is waiting for the client to read its responses.
+		bool bOutputBlocked;
+		bool bClosing;
+	};
+
+	struct PendingRequest {
+		std::size_t ClientIndex;
+		std::size_t NumRows;
+		std::size_t BatchOffset;
+		InferenceStatus Status;
+	};
+
+	const ModelRepresentation::MappedModel& Model;
+	std::string SocketPath;
+	InferenceServerOptions Options;
+	int ListenDescriptor;
+	// Per-client input cap: the header and body of a MaxBatchRows request.
+	std::size_t InputLimit;
+	// Per-client cap on unsent responses: one MaxBatchRows response.
+	std::size_t OutputLimit;
+	std::vector<Client> Clients;
+	std::vector<PendingRequest> Pending;
+	std::vector<double> BatchInputs;
+	std::vector<double> BatchOutputs;
+	std::atomic<bool> bStopping;
+
+	void AcceptClients();
+	bool ReadClient(Client& Connection);
+	bool WriteClient(Client& Connection);
+	bool GatherBatch(std::size_t& BatchRows);
+	void EvaluateBatch(std::size_t BatchRows);
+	void ScatterResponses();
+
+public:
+	// Binds and listens on SocketPath, replacing a stale socket file.
+	// Throws std::runtime_error if the socket cannot be created.
+	InferenceServer(const ModelRepresentation::MappedModel& InModel, std::string InSocketPath,
+	                InferenceServerOptions InOptions = InferenceServerOptions());
+	InferenceServer(const InferenceServer&) = delete;
+	InferenceServer& operator=(const InferenceServer&) = delete;
+	~InferenceServer();
+
+	// Serve requests until Stop() is called; safe to call Stop() from a
+	// signal handler or another thread.
+	void Serve();
+	void Stop() { bStopping.store(true); }
+};
+
+
+class InferenceClient {
+private:
+	int Descriptor;
+
+public:
+	explicit InferenceClient(const std::string& SocketPath);
+	InferenceClient(const InferenceClient&) = delete;
+	InferenceClient& operator=(const InferenceClient&) = delete;
+	~InferenceClient();
+
+	InferenceStatus Predict(const double* Inputs, std::size_t NumRows, std::size_t NumFeatures,
+	                        std::vector<double>& Outputs);
+};
+
+} // namespace CoreUtilities
+
+#endif // __InferenceServer__
@@ -0,0 +1,324 @@
+#include "CoreUtilities/PlotCreation.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace CoreUtilities {
+
+namespace {
+
+const std::size_t WriterBufferBytes = 1 << 20;
+// Longest "%.9g" rendering of a double plus its separator.
+const std::size_t MaxCsvCellBytes = 32;
+const char PlotMagic[8] = {'L', 'S', 'P', 'L', 'O', 'T', '\0', '\0'};
+
+} // namespace
+
+
+/*============================================================================*/
+// PLOT WRITER
+/*============================================================================*/
+
+PlotWriter::PlotWriter(const std::string& Path, PlotFormat InFormat, const std::vector<std::string>& ColumnNames)
+	: File(Path, std::ios::binary | std::ios::trunc),
+	  Format(InFormat),
+	  NumColumns(ColumnNames.size()),
+	  Buffer(WriterBufferBytes),
+	  Used(0)
+{
+	if (!File) {
+		throw std::runtime_error("PlotCreation: cannot write " + Path);
+	}
+	if (NumColumns == 0) {
+		throw std::invalid_argument("PlotCreation: a plot needs at least one column");
+	}
+
+	if (Format == PlotFormat::Csv) {
+		for (std::size_t Column = 0; Column < NumColumns; Column++) {
+			File << (Column ? "," : "") << ColumnNames[Column];
+		}
+		File << '\n';
+	} else {
+		const std::uint32_t Header[2] = {static_cast<std::uint32_t>(NumColumns), 0};
+		File.write(PlotMagic, sizeof(PlotMagic));
+		File.write(reinterpret_cast<const char*>(Header), sizeof(Header));
+		for (const std::string& Name : ColumnNames) {
+			const std::uint32_t Length = static_cast<std::uint32_t>(Name.size());
+			File.write(reinterpret_cast<const char*>(&Length), sizeof(Length));
+			File.write(Name.data(), Length);
+		}
+	}
+}
+
+
+PlotWriter::~PlotWriter()
+{
+	try {
+		Flush();
+	} catch (const std::exception&) {
+		// Destructors must not throw; call Flush() first to see write errors.
+	}
+}
+
+
+void PlotWriter::Reserve(std::size_t Bytes)
+{
+	if (Used + Bytes > Buffer.size()) {
+		Flush();
+	}
+}
+
+
+void PlotWriter::WriteRow(const double* Values)
+{
+	if (Format == PlotFormat::Binary) {
+		const std::size_t Bytes = NumColumns * sizeof(double);
+		Reserve(Bytes);
+		std::memcpy(Buffer.data() + Used, Values, Bytes);
+		Used += Bytes;
+		return;
+	}
+
+	Reserve(NumColumns * MaxCsvCellBytes);
+	for (std::size_t Column = 0; Column < NumColumns; Column++) {
+		const int Written = std::snprintf(Buffer.data() + Used, MaxCsvCellBytes, "%.9g", Values[Column]);
+		Used += static_cast<std::size_t>(Written);
+		Buffer[Used++] = (Column + 1 < NumColumns) ? ',' : '\n';
+	}
+}
+
+
+void PlotWriter::Flush()
+{
+	if (Used > 0) {
+		File.write(Buffer.data(), static_cast<std::streamsize>(Used));
+		Used = 0;
+	}
+	File.flush();
+	if (!File) {
+		throw std::runtime_error("PlotCreation: write failed");
+	}
+}
+
+
+/*============================================================================*/
+// CONVERGENCE CURVE
+/*============================================================================*/
+
+ConvergenceCurve::ConvergenceCurve(std::size_t InWidth)
+	: Width(InWidth), PointsPerBucket(1), NumPoints(0)
+{
+	if (Width < 2 || Width % 2 != 0) {
+		throw std::invalid_argument("ConvergenceCurve: width must be even and at least 2");
+	}
+	Buckets.reserve(Width);
+}
+
+
+void ConvergenceCurve::Halve()
+{
+	for (std::size_t Index = 0; Index < Width / 2; Index++) {
+		const Bucket& Left = Buckets[2 * Index];
+		const Bucket& Right = Buckets[2 * Index + 1];
+		Buckets[Index] = {Left.FirstPoint, std::min(Left.Minimum, Right.Minimum),
+		                  std::max(Left.Maximum, Right.Maximum), Right.Last};
+	}
+	Buckets.resize(Width / 2);
+	PointsPerBucket *= 2;
+}
+
+
+void ConvergenceCurve::Add(double Value)
+{
+	if (NumPoints % PointsPerBucket == 0) {
+		if (Buckets.size() == Width) {
+			Halve();
+		}
+		// Halving leaves NumPoints on a bucket boundary, so a new bucket starts either way.
+		Buckets.push_back({NumPoints, Value, Value, Value});
+	} else {
+		Bucket& Current = Buckets.back();
+		Current.Minimum = std::min(Current.Minimum, Value);
+		Current.Maximum = std::max(Current.Maximum, Value);
+		Current.Last = Value;
+	}
+	NumPoints++;
+}
+
+
+void ConvergenceCurve::Write(PlotWriter& Writer) const
+{
+	for (const Bucket& Entry : Buckets) {
+		const double Row[4] = {static_cast<double>(Entry.FirstPoint), Entry.Minimum, Entry.Maximum, Entry.Last};
+		Writer.WriteRow(Row);
+	}
+}
+
+
+/*============================================================================*/
+// RESIDUAL HISTOGRAM
+/*============================================================================*/
+
+ResidualHistogram::ResidualHistogram(std::size_t InNumBins, double InHalfWidth)
+	: NumBins(InNumBins), HalfWidth(InHalfWidth), NumValues(0), Counts(InNumBins, 0)
+{
+	if (NumBins == 0 || NumBins % 2 != 0) {
+		throw std::invalid_argument("ResidualHistogram: bin count must be even and non-zero");
+	}
+	if (!(HalfWidth >= 0.0) || !std::isfinite(HalfWidth)) {
+		throw std::invalid_argument("ResidualHistogram: half width must be finite and non-negative");
+	}
+}
+
+
+void ResidualHistogram::Widen()
+{
+	// Merge pairs outwards from the centre so bin NumBins/2 still starts at zero.
+	const std::size_t Centre = NumBins / 2;
+	for (std::size_t Index = 0; Index < Centre / 2; Index++) {
+		Counts[Centre + Index] = Counts[Centre + 2 * Index] + Counts[Centre + 2 * Index + 1];
+		Counts[Centre - 1 - Index] = Counts[Centre - 1 - 2 * Index] + Counts[Centre - 2 - 2 * Index];
+	}
+	if (Centre % 2 != 0) {
+		// Odd half: the outermost old bin has no partner and folds in alone.
+		Counts[Centre + Centre / 2] = Counts[NumBins - 1];
+		Counts[Centre - 1 - Centre / 2] = Counts[0];
+	}
+	const std::size_t Kept = (Centre + 1) / 2;
+	std::fill(Counts.begin() + Centre + Kept, Counts.end(), 0);
+	std::fill(Counts.begin(), Counts.begin() + Centre - Kept, 0);
+	HalfWidth *= 2.0;
+}
+
+
+void ResidualHistogram::Add(double Value)
+{
+	if (!std::isfinite(Value)) {
+		return;
+	}
+	if (HalfWidth == 0.0 && Value != 0.0) {
+		HalfWidth = std::exp2(std::ceil(std::log2(std::fabs(Value))));
+	}
+	while (HalfWidth > 0.0 && (Value >= HalfWidth || Value < -HalfWidth)) {
+		Widen();
+	}
+
+	std::size_t Bin = NumBins / 2;
+	if (HalfWidth > 0.0) {
+		const double Position = (Value + HalfWidth) * static_cast<double>(NumBins) / (2.0 * HalfWidth);
+		Bin = std::min(NumBins - 1, static_cast<std::size_t>(Position));
+	}
+	Counts[Bin]++;
+	NumValues++;
+}
+
+
+void ResidualHistogram::Add(const double* Values, std::size_t Count)
+{
+	for (std::size_t Index = 0; Index < Count; Index++) {
+		Add(Values[Index]);
+	}
+}
+
+
+void ResidualHistogram::Write(PlotWriter& Writer) const
+{
+	const double BinWidth = 2.0 * HalfWidth / static_cast<double>(NumBins);
+	for (std::size_t Bin = 0; Bin < NumBins; Bin++) {
+		const double Lower = -HalfWidth + static_cast<double>(Bin) * BinWidth;
+		const double Row[3] = {Lower, Lower + BinWidth, static_cast<double>(Counts[Bin])};
+		Writer.WriteRow(Row);
+	}
+}
+
+
+/*============================================================================*/
+// SCATTER SAMPLE
+/*============================================================================*/
+
+ScatterSample::ScatterSample(std::size_t InCapacity, unsigned Seed)
+	: Capacity(InCapacity), NumSeen(0), NextAccepted(0), Weight(0.0), Generator(Seed)
+{
+	if (Capacity == 0) {
+		throw std::invalid_argument("ScatterSample: capacity must be non-zero");
+	}
+	Truth.reserve(Capacity);
+	Prediction.reserve(Capacity);
+}
+
+
+double ScatterSample::Uniform()
+{
+	// (0, 1], so the logarithms below stay finite.
+	return 1.0 - std::generate_canonical<double, 53>(Generator);
+}
+
+
+void ScatterSample::ScheduleNext()
+{
+	const double Skip = std::floor(std::log(Uniform()) / std::log1p(-Weight));
+	const double Limit = static_cast<double>(std::numeric_limits<std::uint64_t>::max() / 2);
+	NextAccepted = NumSeen + static_cast<std::uint64_t>(std::min(Skip, Limit));
+}
+
+
+void ScatterSample::Add(double InTruth, double InPrediction)
+{
+	const std::uint64_t Index = NumSeen++;
+
+	if (Truth.size() < Capacity) {
+		Truth.push_back(InTruth);
+		Prediction.push_back(InPrediction);
+		if (Truth.size() == Capacity) {
+			Weight = std::exp(std::log(Uniform()) / static_cast<double>(Capacity));
+			ScheduleNext();
+		}
+		return;
+	}
+	if (Index != NextAccepted) {
+		return;
+	}
+
+	const std::size_t Slot = static_cast<std::size_t>(Generator() % Capacity);
+	Truth[Slot] = InTruth;
+	Prediction[Slot] = InPrediction;
+	Weight *= std::exp(std::log(Uniform()) / static_cast<double>(Capacity));
+	ScheduleNext();
+}
+
+
+void ScatterSample::Add(const double* InTruth, const double* InPrediction, std::size_t Count)
+{
+	std::size_t Index = 0;
+	for (; Index < Count && Truth.size() < Capacity; Index++) {
+		Add(InTruth[Index], InPrediction[Index]);
+	}
+
+	// Reservoir full: jump straight to the next accepted pair.
+	while (Index < Count) {
+		const std::uint64_t Skip = NextAccepted - NumSeen;
+		if (Skip >= Count - Index) {
+			NumSeen += Count - Index;
+			return;
+		}
+		Index += static_cast<std::size_t>(Skip);
+		NumSeen += Skip;
+		Add(InTruth[Index], InPrediction[Index]);
+		Index++;
+	}
+}
+
+
+void ScatterSample::Write(PlotWriter& Writer) const
+{
+	for (std::size_t Index = 0; Index < Truth.size(); Index++) {
+		const double Row[2] = {Truth[Index], Prediction[Index]};
+		Writer.WriteRow(Row);
+	}
+}
+
+} // namespace CoreUtilities
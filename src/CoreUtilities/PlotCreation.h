@@ -0,0 +1,152 @@
+#ifndef __PlotCreation__
+#define __PlotCreation__
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+/* PLOT CREATION */
+// Streaming plot data for training runs. Each series takes values one at a
+// time (or a block at a time) and keeps a bounded summary whatever the run
+// length. The summary is written through a buffered PlotWriter, so a 50M-row
+// run gives a plot file of a few MB.
+//
+//   ConvergenceCurve   loss per iteration, reduced to min/max/last per bucket
+//   ResidualHistogram  fixed bin count, zero-centred, widens as values arrive
+//   ScatterSample      uniform reservoir sample of (truth, prediction) pairs
+
+namespace CoreUtilities {
+
+enum class PlotFormat {
+	Csv,
+	Binary
+};
+
+
+// Rows of doubles written through a large in-memory buffer. Csv writes a
+// header line then "%.9g" cells. Binary writes the "LSPLOT" header (magic,
+// column count, length-prefixed names) followed by raw row-major float64
+// rows in host byte order.
+class PlotWriter {
+private:
+	std::ofstream File;
+	PlotFormat Format;
+	std::size_t NumColumns;
+	std::vector<char> Buffer;
+	std::size_t Used;
+
+	void Reserve(std::size_t Bytes);
+
+public:
+	PlotWriter(const std::string& Path, PlotFormat InFormat, const std::vector<std::string>& ColumnNames);
+	PlotWriter(const PlotWriter&) = delete;
+	PlotWriter& operator=(const PlotWriter&) = delete;
+	~PlotWriter();
+
+	std::size_t GetNumColumns() const { return NumColumns; }
+
+	// Values holds GetNumColumns() entries.
+	void WriteRow(const double* Values);
+	void Flush();
+};
+
+
+// Keeps at most Width buckets. When all are full, neighbouring pairs are
+// merged and each bucket then covers twice as many points, so every bucket
+// always spans the same number of points. Storing min and max per bucket
+// keeps spikes that plain subsampling would drop.
+class ConvergenceCurve {
+public:
+	struct Bucket {
+		std::uint64_t FirstPoint;
+		double Minimum;
+		double Maximum;
+		double Last;
+	};
+
+private:
+	std::size_t Width;
+	std::uint64_t PointsPerBucket;
+	std::uint64_t NumPoints;
+	std::vector<Bucket> Buckets;
+
+	void Halve();
+
+public:
+	explicit ConvergenceCurve(std::size_t InWidth = 2048);
+
+	void Add(double Value);
+
+	std::uint64_t GetNumPoints() const { return NumPoints; }
+	const std::vector<Bucket>& GetBuckets() const { return Buckets; }
+
+	// Columns: point, minimum, maximum, last.
+	void Write(PlotWriter& Writer) const;
+};
+
+
+// Equal-width bins covering [-HalfWidth, HalfWidth). HalfWidth starts at the
+// power of two above the first non-zero value. When a value falls outside
+// the range, HalfWidth doubles and neighbouring bins are merged, so no value
+// is ever clipped and no bin is ever split.
+class ResidualHistogram {
+private:
+	std::size_t NumBins;
+	double HalfWidth;
+	std::uint64_t NumValues;
+	std::vector<std::uint64_t> Counts;
+
+	void Widen();
+
+public:
+	// NumBins must be even and non-zero; InHalfWidth 0 picks it from the data.
+	explicit ResidualHistogram(std::size_t InNumBins = 256, double InHalfWidth = 0.0);
+
+	void Add(double Value);
+	void Add(const double* Values, std::size_t Count);
+
+	std::uint64_t GetNumValues() const { return NumValues; }
+	double GetHalfWidth() const { return HalfWidth; }
+	const std::vector<std::uint64_t>& GetCounts() const { return Counts; }
+
+	// Columns: lower edge, upper edge, count.
+	void Write(PlotWriter& Writer) const;
+};
+
+
+// Uniform sample of Capacity pairs over an unbounded stream. Uses Li's
+// Algorithm L: once the reservoir is full, the number of pairs to skip is
+// drawn directly, so a long stream costs O(Capacity log(N / Capacity))
+// random draws instead of one per pair.
+class ScatterSample {
+private:
+	std::size_t Capacity;
+	std::uint64_t NumSeen;
+	std::uint64_t NextAccepted;
+	double Weight;
+	std::mt19937_64 Generator;
+	std::vector<double> Truth;
+	std::vector<double> Prediction;
+
+	double Uniform();
+	void ScheduleNext();
+
+public:
+	explicit ScatterSample(std::size_t InCapacity = 20000, unsigned Seed = 0);
+
+	void Add(double InTruth, double InPrediction);
+	void Add(const double* InTruth, const double* InPrediction, std::size_t Count);
+
+	std::uint64_t GetNumSeen() const { return NumSeen; }
+	std::size_t GetNumSampled() const { return Truth.size(); }
+
+	// Columns: truth, prediction.
+	void Write(PlotWriter& Writer) const;
+};
+
+} // namespace CoreUtilities
+
+#endif // __PlotCreation__
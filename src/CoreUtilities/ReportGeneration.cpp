@@ -0,0 +1,294 @@
+#include "CoreUtilities/ReportGeneration.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+
+namespace CoreUtilities {
+
+namespace {
+
+const std::size_t NumPhases = static_cast<std::size_t>(ReportPhase::Count);
+const std::size_t NumCounters = static_cast<std::size_t>(ReportCounter::Count);
+
+const char* const PhaseNames[NumPhases] = {
+	"ingest", "cost_kernel", "normal_equation", "solver", "clustering", "kernel_rows", "inference", "fetch", "extraction",
+	"all_reduce"
+};
+
+const char* const CounterNames[NumCounters] = {
+	"optimiser_iterations", "cache_hits", "cache_misses", "fetch_retries"
+};
+
+
+struct PhaseRecord {
+	std::atomic<std::uint64_t> Calls{0};
+	std::atomic<std::uint64_t> Nanoseconds{0};
+	std::atomic<std::uint64_t> Rows{0};
+	std::atomic<std::uint64_t> Bytes{0};
+};
+
+// Written only by its owning thread; read by CaptureReport.
+struct ThreadRecord {
+	std::size_t Thread = 0;
+	std::array<PhaseRecord, NumPhases> Phases;
+	std::array<std::atomic<std::uint64_t>, NumCounters> Counters{};
+	std::atomic<std::uint64_t> Tasks{0};
+	std::atomic<std::uint64_t> BusyNanoseconds{0};
+};
+
+
+// Records outlive their threads so a report taken at exit sees everything.
+struct ThreadRegistry {
+	std::mutex Lock;
+	std::vector<std::unique_ptr<ThreadRecord>> Records;
+	const std::chrono::steady_clock::time_point Start = std::chrono::steady_clock::now();
+};
+
+ThreadRegistry& GetRegistry()
+{
+	static ThreadRegistry Registry;
+	return Registry;
+}
+
+// Construct the registry during static initialisation so WallSeconds covers the run.
+[[maybe_unused]] const ThreadRegistry& StartupRegistry = GetRegistry();
+
+
+ThreadRecord& GetThreadRecord()
+{
+	thread_local ThreadRecord* Record = []() {
+		ThreadRegistry& Registry = GetRegistry();
+		std::lock_guard<std::mutex> Guard(Registry.Lock);
+		Registry.Records.push_back(std::make_unique<ThreadRecord>());
+		Registry.Records.back()->Thread = Registry.Records.size() - 1;
+		return Registry.Records.back().get();
+	}();
+	return *Record;
+}
+
+
+void Add(std::atomic<std::uint64_t>& Value, std::uint64_t Amount)
+{
+	// Single writer: a relaxed load/store pair avoids a locked RMW.
+	Value.store(Value.load(std::memory_order_relaxed) + Amount, std::memory_order_relaxed);
+}
+
+
+std::uint64_t ElapsedNanoseconds(std::chrono::steady_clock::time_point Start)
+{
+	return static_cast<std::uint64_t>(
+		std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - Start).count());
+}
+
+
+double Seconds(std::uint64_t Nanoseconds)
+{
+	return static_cast<double>(Nanoseconds) * 1.0e-9;
+}
+
+
+double PerSecond(std::uint64_t Amount, std::uint64_t Nanoseconds)
+{
+	return Nanoseconds ? static_cast<double>(Amount) / Seconds(Nanoseconds) : 0.0;
+}
+
+} // namespace
+
+
+const char* GetPhaseName(ReportPhase Phase)
+{
+	return PhaseNames[static_cast<std::size_t>(Phase)];
+}
+
+
+const char* GetCounterName(ReportCounter Counter)
+{
+	return CounterNames[static_cast<std::size_t>(Counter)];
+}
+
+
+/*============================================================================*/
+// RECORDING
+/*============================================================================*/
+
+ScopedTimer::ScopedTimer(ReportPhase InPhase)
+	: Phase(InPhase), Start(std::chrono::steady_clock::now())
+{
+}
+
+
+ScopedTimer::~ScopedTimer()
+{
+	PhaseRecord& Record = GetThreadRecord().Phases[static_cast<std::size_t>(Phase)];
+	Add(Record.Calls, 1);
+	Add(Record.Nanoseconds, ElapsedNanoseconds(Start));
+}
+
+
+ScopedBusyTimer::ScopedBusyTimer()
+	: Start(std::chrono::steady_clock::now())
+{
+}
+
+
+ScopedBusyTimer::~ScopedBusyTimer()
+{
+	ThreadRecord& Record = GetThreadRecord();
+	Add(Record.Tasks, 1);
+	Add(Record.BusyNanoseconds, ElapsedNanoseconds(Start));
+}
+
+
+void RecordPhaseVolume(ReportPhase Phase, std::uint64_t Rows, std::uint64_t Bytes)
+{
+	PhaseRecord& Record = GetThreadRecord().Phases[static_cast<std::size_t>(Phase)];
+	Add(Record.Rows, Rows);
+	Add(Record.Bytes, Bytes);
+}
+
+
+void IncrementCounter(ReportCounter Counter, std::uint64_t Amount)
+{
+	Add(GetThreadRecord().Counters[static_cast<std::size_t>(Counter)], Amount);
+}
+
+
+/*============================================================================*/
+// REPORTING
+/*============================================================================*/
+
+ReportSnapshot CaptureReport()
+{
+	ThreadRegistry& Registry = GetRegistry();
+
+	ReportSnapshot Snapshot;
+#ifdef LEARNSCRAPE_INSTRUMENTATION
+	Snapshot.bInstrumented = true;
+#else
+	Snapshot.bInstrumented = false;
+#endif
+	Snapshot.WallSeconds = Seconds(ElapsedNanoseconds(Registry.Start));
+
+	for (std::size_t Phase = 0; Phase < NumPhases; Phase++) {
+		Snapshot.Phases.push_back({PhaseNames[Phase], 0, 0, 0, 0});
+	}
+	for (std::size_t Counter = 0; Counter < NumCounters; Counter++) {
+		Snapshot.Counters.emplace_back(CounterNames[Counter], 0);
+	}
+
+	std::lock_guard<std::mutex> Guard(Registry.Lock);
+	for (const std::unique_ptr<ThreadRecord>& Record : Registry.Records) {
+		for (std::size_t Phase = 0; Phase < NumPhases; Phase++) {
+			PhaseSummary& Summary = Snapshot.Phases[Phase];
+			Summary.Calls += Record->Phases[Phase].Calls.load(std::memory_order_relaxed);
+			Summary.Nanoseconds += Record->Phases[Phase].Nanoseconds.load(std::memory_order_relaxed);
+			Summary.Rows += Record->Phases[Phase].Rows.load(std::memory_order_relaxed);
+			Summary.Bytes += Record->Phases[Phase].Bytes.load(std::memory_order_relaxed);
+		}
+		for (std::size_t Counter = 0; Counter < NumCounters; Counter++) {
+			Snapshot.Counters[Counter].second += Record->Counters[Counter].load(std::memory_order_relaxed);
+		}
+		Snapshot.Threads.push_back({Record->Thread, Record->Tasks.load(std::memory_order_relaxed),
+		                            Record->BusyNanoseconds.load(std::memory_order_relaxed)});
+	}
+	return Snapshot;
+}
+
+
+void WriteJsonReport(const ReportSnapshot& Snapshot, std::ostream& Out)
+{
+	Out << std::setprecision(9);
+	Out << "{\n  \"instrumented\": " << (Snapshot.bInstrumented ? "true" : "false")
+	    << ",\n  \"wall_seconds\": " << Snapshot.WallSeconds << ",\n  \"phases\": [";
+
+	for (std::size_t Index = 0; Index < Snapshot.Phases.size(); Index++) {
+		const PhaseSummary& Phase = Snapshot.Phases[Index];
+		Out << (Index ? "," : "") << "\n    {\"name\": \"" << Phase.Name << "\", \"calls\": " << Phase.Calls
+		    << ", \"seconds\": " << Seconds(Phase.Nanoseconds) << ", \"rows\": " << Phase.Rows
+		    << ", \"bytes\": " << Phase.Bytes << ", \"rows_per_second\": " << PerSecond(Phase.Rows, Phase.Nanoseconds)
+		    << ", \"bytes_per_second\": " << PerSecond(Phase.Bytes, Phase.Nanoseconds) << "}";
+	}
+
+	Out << "\n  ],\n  \"counters\": {";
+	for (std::size_t Index = 0; Index < Snapshot.Counters.size(); Index++) {
+		Out << (Index ? "," : "") << "\n    \"" << Snapshot.Counters[Index].first << "\": " << Snapshot.Counters[Index].second;
+	}
+
+	std::uint64_t Hits = 0, Misses = 0;
+	for (const auto& Counter : Snapshot.Counters) {
+		Hits += (Counter.first == GetCounterName(ReportCounter::CacheHits)) ? Counter.second : 0;
+		Misses += (Counter.first == GetCounterName(ReportCounter::CacheMisses)) ? Counter.second : 0;
+	}
+	Out << "\n  },\n  \"cache_hit_rate\": " << ((Hits + Misses) ? static_cast<double>(Hits) / (Hits + Misses) : 0.0)
+	    << ",\n  \"threads\": [";
+
+	for (std::size_t Index = 0; Index < Snapshot.Threads.size(); Index++) {
+		const ThreadSummary& Thread = Snapshot.Threads[Index];
+		Out << (Index ? "," : "") << "\n    {\"thread\": " << Thread.Thread << ", \"tasks\": " << Thread.Tasks
+		    << ", \"busy_seconds\": " << Seconds(Thread.BusyNanoseconds) << "}";
+	}
+	Out << "\n  ]\n}\n";
+}
+
+
+void WriteHtmlReport(const ReportSnapshot& Snapshot, std::ostream& Out)
+{
+	std::uint64_t Longest = 1;
+	for (const PhaseSummary& Phase : Snapshot.Phases) {
+		Longest = std::max(Longest, Phase.Nanoseconds);
+	}
+
+	Out << std::setprecision(4);
+	Out << "<!DOCTYPE html>\n<html><head><meta charset=\"utf-8\"><title>learnscrape run report</title>\n"
+	    << "<style>body{font-family:sans-serif}td,th{padding:2px 8px;text-align:right}"
+	    << "td.name{text-align:left}.bar{background:#4a7;height:10px}</style></head><body>\n"
+	    << "<h1>learnscrape run report</h1>\n<p>Wall time " << Snapshot.WallSeconds << " s"
+	    << (Snapshot.bInstrumented ? "" : " &mdash; built without LEARNSCRAPE_INSTRUMENTATION") << "</p>\n";
+
+	Out << "<h2>Phases</h2>\n<table><tr><th>phase</th><th>calls</th><th>seconds</th><th>rows/s</th>"
+	    << "<th>MB/s</th><th></th></tr>\n";
+	for (const PhaseSummary& Phase : Snapshot.Phases) {
+		Out << "<tr><td class=\"name\">" << Phase.Name << "</td><td>" << Phase.Calls << "</td><td>"
+		    << Seconds(Phase.Nanoseconds) << "</td><td>" << PerSecond(Phase.Rows, Phase.Nanoseconds) << "</td><td>"
+		    << PerSecond(Phase.Bytes, Phase.Nanoseconds) * 1.0e-6 << "</td><td><div class=\"bar\" style=\"width:"
+		    << 300 * Phase.Nanoseconds / Longest << "px\"></div></td></tr>\n";
+	}
+
+	Out << "</table>\n<h2>Counters</h2>\n<table>\n";
+	for (const auto& Counter : Snapshot.Counters) {
+		Out << "<tr><td class=\"name\">" << Counter.first << "</td><td>" << Counter.second << "</td></tr>\n";
+	}
+
+	Out << "</table>\n<h2>Threads</h2>\n<table><tr><th>thread</th><th>tasks</th><th>busy s</th><th>busy %</th></tr>\n";
+	for (const ThreadSummary& Thread : Snapshot.Threads) {
+		Out << "<tr><td>" << Thread.Thread << "</td><td>" << Thread.Tasks << "</td><td>" << Seconds(Thread.BusyNanoseconds)
+		    << "</td><td>" << (Snapshot.WallSeconds > 0.0 ? 100.0 * Seconds(Thread.BusyNanoseconds) / Snapshot.WallSeconds : 0.0)
+		    << "</td></tr>\n";
+	}
+	Out << "</table>\n</body></html>\n";
+}
+
+
+void WriteReport(const std::string& Path)
+{
+	std::ofstream File(Path);
+	if (!File) {
+		throw std::runtime_error("ReportGeneration: cannot write " + Path);
+	}
+
+	const ReportSnapshot Snapshot = CaptureReport();
+	const bool bHtml = Path.size() >= 5 && Path.compare(Path.size() - 5, 5, ".html") == 0;
+	if (bHtml) {
+		WriteHtmlReport(Snapshot, File);
+	} else {
+		WriteJsonReport(Snapshot, File);
+	}
+}
+
+} // namespace CoreUtilities
@@ -0,0 +1,130 @@
+#ifndef __ReportGeneration__
+#define __ReportGeneration__
+
+#include <cstddef>
+#include <cstdint>
+#include <chrono>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/* REPORT GENERATION */
+// Low-overhead run instrumentation and the per-run report built from it.
+//
+// Hot paths record through the LEARNSCRAPE_* macros below, which compile to
+// nothing unless the build sets LEARNSCRAPE_INSTRUMENTATION (CMake option of
+// the same name). Each thread writes only to its own record of relaxed
+// atomics, registered once on first use, so recording never takes a lock;
+// CaptureReport() sums the records of every thread that has run.
+//
+// Phase times are inclusive (Solver contains the CostKernel calls it makes)
+// and summed over threads, so concurrent phases can exceed wall time.
+
+namespace CoreUtilities {
+
+enum class ReportPhase : std::size_t {
+	Ingest,
+	CostKernel,
+	NormalEquation,
+	Solver,
+	Clustering,
+	KernelRows,
+	Inference,
+	Fetch,
+	Extraction,
+	AllReduce,
+	Count
+};
+
+enum class ReportCounter : std::size_t {
+	OptimiserIterations,
+	CacheHits,
+	CacheMisses,
+	FetchRetries,
+	Count
+};
+
+const char* GetPhaseName(ReportPhase Phase);
+const char* GetCounterName(ReportCounter Counter);
+
+
+class ScopedTimer {
+private:
+	ReportPhase Phase;
+	std::chrono::steady_clock::time_point Start;
+
+public:
+	explicit ScopedTimer(ReportPhase InPhase);
+	ScopedTimer(const ScopedTimer&) = delete;
+	ScopedTimer& operator=(const ScopedTimer&) = delete;
+	~ScopedTimer();
+};
+
+// Time the calling thread spends executing scheduler tasks.
+class ScopedBusyTimer {
+private:
+	std::chrono::steady_clock::time_point Start;
+
+public:
+	ScopedBusyTimer();
+	ScopedBusyTimer(const ScopedBusyTimer&) = delete;
+	ScopedBusyTimer& operator=(const ScopedBusyTimer&) = delete;
+	~ScopedBusyTimer();
+};
+
+void RecordPhaseVolume(ReportPhase Phase, std::uint64_t Rows, std::uint64_t Bytes);
+void IncrementCounter(ReportCounter Counter, std::uint64_t Amount);
+
+
+struct PhaseSummary {
+	std::string Name;
+	std::uint64_t Calls;
+	std::uint64_t Nanoseconds;
+	std::uint64_t Rows;
+	std::uint64_t Bytes;
+};
+
+struct ThreadSummary {
+	std::size_t Thread;
+	std::uint64_t Tasks;
+	std::uint64_t BusyNanoseconds;
+};
+
+struct ReportSnapshot {
+	bool bInstrumented;
+	double WallSeconds;
+	std::vector<PhaseSummary> Phases;
+	std::vector<std::pair<std::string, std::uint64_t>> Counters;
+	std::vector<ThreadSummary> Threads;
+};
+
+ReportSnapshot CaptureReport();
+
+void WriteJsonReport(const ReportSnapshot& Snapshot, std::ostream& Out);
+void WriteHtmlReport(const ReportSnapshot& Snapshot, std::ostream& Out);
+
+// Capture and write to Path; ".html" selects HTML, anything else JSON.
+// Throws std::runtime_error if the file cannot be written.
+void WriteReport(const std::string& Path);
+
+} // namespace CoreUtilities
+
+
+#define LEARNSCRAPE_REPORT_CONCAT_INNER(Left, Right) Left##Right
+#define LEARNSCRAPE_REPORT_CONCAT(Left, Right) LEARNSCRAPE_REPORT_CONCAT_INNER(Left, Right)
+
+#ifdef LEARNSCRAPE_INSTRUMENTATION
+#define LEARNSCRAPE_SCOPED_TIMER(Phase) \
+	::CoreUtilities::ScopedTimer LEARNSCRAPE_REPORT_CONCAT(ScopedTimer, __LINE__)(Phase)
+#define LEARNSCRAPE_SCOPED_BUSY() \
+	::CoreUtilities::ScopedBusyTimer LEARNSCRAPE_REPORT_CONCAT(ScopedBusyTimer, __LINE__)
+#define LEARNSCRAPE_RECORD_VOLUME(Phase, Rows, Bytes) ::CoreUtilities::RecordPhaseVolume(Phase, Rows, Bytes)
+#define LEARNSCRAPE_COUNT(Counter, Amount) ::CoreUtilities::IncrementCounter(Counter, Amount)
+#else
+#define LEARNSCRAPE_SCOPED_TIMER(Phase) ((void)0)
+#define LEARNSCRAPE_SCOPED_BUSY() ((void)0)
+#define LEARNSCRAPE_RECORD_VOLUME(Phase, Rows, Bytes) ((void)0)
+#define LEARNSCRAPE_COUNT(Counter, Amount) ((void)0)
+#endif
+
+#endif // __ReportGeneration__
@@ -0,0 +1,473 @@
+#include "CoreUtilities/RingAllReduce.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "CoreUtilities/ReportGeneration.h"
+
+namespace CoreUtilities {
+
+namespace {
+
+const std::chrono::milliseconds ConnectRetryInterval(50);
+
+
+sockaddr_un SocketAddress(const std::string& Path)
+{
+	sockaddr_un Address;
+	std::memset(&Address, 0, sizeof(Address));
+	Address.sun_family = AF_UNIX;
+	if (Path.empty() || Path.size() >= sizeof(Address.sun_path)) {
+		throw std::invalid_argument("SocketEndpoint: bad socket path: " + Path);
+	}
+	std::strncpy(Address.sun_path, Path.c_str(), sizeof(Address.sun_path) - 1);
+	return Address;
+}
+
+
+// getaddrinfo for a TCP endpoint; the caller frees the list.
+addrinfo* ResolveTcp(const SocketEndpoint& Endpoint, bool bPassive)
+{
+	addrinfo Hints;
+	std::memset(&Hints, 0, sizeof(Hints));
+	Hints.ai_family = AF_UNSPEC;
+	Hints.ai_socktype = SOCK_STREAM;
+	Hints.ai_flags = bPassive ? AI_PASSIVE : 0;
+
+	addrinfo* Found = nullptr;
+	const std::string Port = std::to_string(Endpoint.Port);
+	const int Status = ::getaddrinfo(Endpoint.Address.empty() ? nullptr : Endpoint.Address.c_str(), Port.c_str(),
+	                                 &Hints, &Found);
+	if (Status != 0) {
+		throw std::runtime_error("cannot resolve " + Endpoint.ToString() + ": " + ::gai_strerror(Status));
+	}
+	return Found;
+}
+
+
+void DisableNagle(int Descriptor)
+{
+	const int Enable = 1;
+	::setsockopt(Descriptor, IPPROTO_TCP, TCP_NODELAY, &Enable, sizeof(Enable));
+}
+
+
+// One connection attempt; -1 with errno set on failure.
+int TryConnect(const SocketEndpoint& Endpoint)
+{
+	if (!Endpoint.bTcp) {
+		const sockaddr_un Address = SocketAddress(Endpoint.Address);
+		const int Descriptor = ::socket(AF_UNIX, SOCK_STREAM, 0);
+		if (Descriptor < 0) {
+			return -1;
+		}
+		if (::connect(Descriptor, reinterpret_cast<const sockaddr*>(&Address), sizeof(Address)) != 0) {
+			const int Error = errno;
+			::close(Descriptor);
+			errno = Error;
+			return -1;
+		}
+		return Descriptor;
+	}
+
+	addrinfo* Candidates = ResolveTcp(Endpoint, false);
+	int Descriptor = -1;
+	int Error = ECONNREFUSED;
+	for (const addrinfo* Candidate = Candidates; Candidate != nullptr && Descriptor < 0; Candidate = Candidate->ai_next) {
+		Descriptor = ::socket(Candidate->ai_family, Candidate->ai_socktype, Candidate->ai_protocol);
+		if (Descriptor >= 0 && ::connect(Descriptor, Candidate->ai_addr, Candidate->ai_addrlen) != 0) {
+			Error = errno;
+			::close(Descriptor);
+			Descriptor = -1;
+		}
+	}
+	::freeaddrinfo(Candidates);
+	if (Descriptor < 0) {
+		errno = Error;
+		return -1;
+	}
+	DisableNagle(Descriptor);
+	return Descriptor;
+}
+
+
+int ToMilliseconds(double Seconds)
+{
+	return static_cast<int>(std::min(Seconds * 1000.0, static_cast<double>(INT_MAX)));
+}
+
+} // namespace
+
+
+/*============================================================================*/
+// ENDPOINTS AND CONNECTIONS
+/*============================================================================*/
+
+SocketEndpoint SocketEndpoint::Parse(const std::string& Text)
+{
+	SocketEndpoint Endpoint;
+	if (Text.compare(0, 4, "tcp:") != 0) {
+		Endpoint.Address = (Text.compare(0, 5, "unix:") == 0) ? Text.substr(5) : Text;
+		if (Endpoint.Address.empty()) {
+			throw std::invalid_argument("SocketEndpoint: empty socket path");
+		}
+		return Endpoint;
+	}
+
+	const std::size_t Colon = Text.rfind(':');
+	if (Colon <= 3 || Colon + 1 == Text.size() ||
+	    Text.find_first_not_of("0123456789", Colon + 1) != std::string::npos || Text.size() - Colon > 6) {
+		throw std::invalid_argument("SocketEndpoint: expected tcp:<host>:<port>, got " + Text);
+	}
+	const unsigned long Port = std::stoul(Text.substr(Colon + 1));
+	if (Port > 65535) {
+		throw std::invalid_argument("SocketEndpoint: port out of range in " + Text);
+	}
+	Endpoint.bTcp = true;
+	Endpoint.Address = Text.substr(4, Colon - 4);
+	// [::1]:port form for IPv6 literals.
+	if (Endpoint.Address.size() >= 2 && Endpoint.Address.front() == '[' && Endpoint.Address.back() == ']') {
+		Endpoint.Address = Endpoint.Address.substr(1, Endpoint.Address.size() - 2);
+	}
+	Endpoint.Port = static_cast<std::uint16_t>(Port);
+	return Endpoint;
+}
+
+
+std::string SocketEndpoint::ToString() const
+{
+	if (!bTcp) {
+		return "unix:" + Address;
+	}
+	const bool bBracket = Address.find(':') != std::string::npos;
+	return "tcp:" + (bBracket ? "[" + Address + "]" : Address) + ":" + std::to_string(Port);
+}
+
+
+SocketConnection::SocketConnection(int InDescriptor)
+	: Descriptor(InDescriptor)
+{
+}
+
+
+SocketConnection::SocketConnection(SocketConnection&& Other) noexcept
+	: Descriptor(Other.Descriptor)
+{
+	Other.Descriptor = -1;
+}
+
+
+SocketConnection& SocketConnection::operator=(SocketConnection&& Other) noexcept
+{
+	std::swap(Descriptor, Other.Descriptor);
+	return *this;
+}
+
+
+SocketConnection::~SocketConnection()
+{
+	if (Descriptor >= 0) {
+		::close(Descriptor);
+	}
+}
+
+
+SocketConnection SocketConnection::Connect(const SocketEndpoint& Endpoint, double TimeoutSeconds)
+{
+	const auto Deadline = std::chrono::steady_clock::now() + std::chrono::duration<double>(TimeoutSeconds);
+	for (;;) {
+		const int Descriptor = TryConnect(Endpoint);
+		if (Descriptor >= 0) {
+			return SocketConnection(Descriptor);
+		}
+		// Nothing listening yet (or a full backlog): the peer may still be starting.
+		const int Error = errno;
+		const bool bRetry = Error == ENOENT || Error == ECONNREFUSED || Error == EAGAIN;
+		if (!bRetry || std::chrono::steady_clock::now() >= Deadline) {
+			throw std::runtime_error("cannot connect to " + Endpoint.ToString() + ": " + std::strerror(Error));
+		}
+		std::this_thread::sleep_for(ConnectRetryInterval);
+	}
+}
+
+
+void SocketConnection::SetTimeout(double Seconds)
+{
+	timeval Limit;
+	Limit.tv_sec = static_cast<time_t>(Seconds);
+	Limit.tv_usec = static_cast<suseconds_t>((Seconds - static_cast<double>(Limit.tv_sec)) * 1.0e6);
+	::setsockopt(Descriptor, SOL_SOCKET, SO_RCVTIMEO, &Limit, sizeof(Limit));
+	::setsockopt(Descriptor, SOL_SOCKET, SO_SNDTIMEO, &Limit, sizeof(Limit));
+}
+
+
+void SocketConnection::Send(const void* Data, std::size_t Size)
+{
+	const char* Bytes = static_cast<const char*>(Data);
+	while (Size > 0) {
+		const ssize_t Sent = ::send(Descriptor, Bytes, Size, MSG_NOSIGNAL);
+		if (Sent < 0 && errno == EINTR) {
+			continue;
+		}
+		if (Sent <= 0) {
+			const bool bTimedOut = errno == EAGAIN || errno == EWOULDBLOCK;
+			throw std::runtime_error(bTimedOut ? "socket send timed out"
+			                                   : std::string("socket send failed: ") + std::strerror(errno));
+		}
+		Bytes += Sent;
+		Size -= static_cast<std::size_t>(Sent);
+	}
+}
+
+
+void SocketConnection::Receive(void* Data, std::size_t Size)
+{
+	char* Bytes = static_cast<char*>(Data);
+	while (Size > 0) {
+		const ssize_t Received = ::recv(Descriptor, Bytes, Size, 0);
+		if (Received < 0 && errno == EINTR) {
+			continue;
+		}
+		if (Received == 0) {
+			throw std::runtime_error("connection closed by peer");
+		}
+		if (Received < 0) {
+			const bool bTimedOut = errno == EAGAIN || errno == EWOULDBLOCK;
+			throw std::runtime_error(bTimedOut ? "socket receive timed out"
+			                                   : std::string("socket receive failed: ") + std::strerror(errno));
+		}
+		Bytes += Received;
+		Size -= static_cast<std::size_t>(Received);
+	}
+}
+
+
+SocketListener::SocketListener(const SocketEndpoint& InEndpoint, int Backlog)
+	: Descriptor(-1), Endpoint(InEndpoint)
+{
+	if (!Endpoint.bTcp) {
+		const sockaddr_un Address = SocketAddress(Endpoint.Address);
+		Descriptor = ::socket(AF_UNIX, SOCK_STREAM, 0);
+		if (Descriptor >= 0) {
+			::unlink(Endpoint.Address.c_str());
+			if (::bind(Descriptor, reinterpret_cast<const sockaddr*>(&Address), sizeof(Address)) != 0 ||
+			    ::listen(Descriptor, Backlog) != 0) {
+				const int Error = errno;
+				::close(Descriptor);
+				throw std::runtime_error("cannot listen on " + Endpoint.ToString() + ": " + std::strerror(Error));
+			}
+		}
+	} else {
+		addrinfo* Candidates = ResolveTcp(Endpoint, true);
+		int Error = EADDRNOTAVAIL;
+		for (const addrinfo* Candidate = Candidates; Candidate != nullptr && Descriptor < 0; Candidate = Candidate->ai_next) {
+			Descriptor = ::socket(Candidate->ai_family, Candidate->ai_socktype, Candidate->ai_protocol);
+			if (Descriptor < 0) {
+				continue;
+			}
+			const int Enable = 1;
+			::setsockopt(Descriptor, SOL_SOCKET, SO_REUSEADDR, &Enable, sizeof(Enable));
+			if (::bind(Descriptor, Candidate->ai_addr, Candidate->ai_addrlen) != 0 || ::listen(Descriptor, Backlog) != 0) {
+				Error = errno;
+				::close(Descriptor);
+				Descriptor = -1;
+			}
+		}
+		::freeaddrinfo(Candidates);
+		if (Descriptor < 0) {
+			throw std::runtime_error("cannot listen on " + Endpoint.ToString() + ": " + std::strerror(Error));
+		}
+
+		sockaddr_storage Bound;
+		socklen_t BoundSize = sizeof(Bound);
+		if (::getsockname(Descriptor, reinterpret_cast<sockaddr*>(&Bound), &BoundSize) == 0) {
+			Endpoint.Port = ntohs(Bound.ss_family == AF_INET6 ? reinterpret_cast<const sockaddr_in6&>(Bound).sin6_port
+			                                                  : reinterpret_cast<const sockaddr_in&>(Bound).sin_port);
+		}
+	}
+	if (Descriptor < 0) {
+		throw std::runtime_error("cannot create socket for " + Endpoint.ToString());
+	}
+}
+
+
+SocketListener::~SocketListener()
+{
+	::close(Descriptor);
+	if (!Endpoint.bTcp) {
+		::unlink(Endpoint.Address.c_str());
+	}
+}
+
+
+SocketConnection SocketListener::Accept(double TimeoutSeconds)
+{
+	pollfd Waiting = {Descriptor, POLLIN, 0};
+	for (;;) {
+		const int Ready = ::poll(&Waiting, 1, ToMilliseconds(TimeoutSeconds));
+		if (Ready < 0 && errno == EINTR) {
+			continue;
+		}
+		if (Ready <= 0) {
+			throw std::runtime_error("no connection on " + Endpoint.ToString() + " within "
+			                         + std::to_string(TimeoutSeconds) + " s");
+		}
+		const int Accepted = ::accept(Descriptor, nullptr, nullptr);
+		if (Accepted < 0) {
+			if (errno == EINTR || errno == ECONNABORTED) {
+				continue;
+			}
+			throw std::runtime_error("accept failed on " + Endpoint.ToString() + ": " + std::strerror(errno));
+		}
+		if (Endpoint.bTcp) {
+			DisableNagle(Accepted);
+		}
+		return SocketConnection(Accepted);
+	}
+}
+
+
+/*============================================================================*/
+// RING ALL-REDUCE
+/*============================================================================*/
+
+RingAllReduce::RingAllReduce(std::size_t InRank, std::size_t InNumRanks, SocketListener& Listener,
+                             const SocketEndpoint& NextEndpoint, double InTimeoutSeconds)
+	: Rank(InRank), NumRanks(InNumRanks), TimeoutSeconds(InTimeoutSeconds)
+{
+	if (NumRanks == 0 || Rank >= NumRanks) {
+		throw std::invalid_argument("RingAllReduce: rank " + std::to_string(Rank) + " of "
+		                            + std::to_string(NumRanks));
+	}
+	if (NumRanks == 1) {
+		return;
+	}
+
+	// The successor listens before it can be named to us, so connecting
+	// first and accepting second cannot deadlock.
+	Next = SocketConnection::Connect(NextEndpoint, TimeoutSeconds);
+	Next.SetTimeout(TimeoutSeconds);
+	const std::uint64_t Identity = Rank;
+	Next.Send(&Identity, sizeof(Identity));
+
+	Previous = Listener.Accept(TimeoutSeconds);
+	Previous.SetTimeout(TimeoutSeconds);
+	std::uint64_t PreviousRank = 0;
+	Previous.Receive(&PreviousRank, sizeof(PreviousRank));
+	if (PreviousRank != (Rank + NumRanks - 1) % NumRanks) {
+		throw std::runtime_error("RingAllReduce: rank " + std::to_string(Rank) + " was joined by rank "
+		                         + std::to_string(PreviousRank));
+	}
+}
+
+
+void RingAllReduce::Exchange(const void* Out, std::size_t OutSize, void* In, std::size_t InSize)
+{
+	const char* Sending = static_cast<const char*>(Out);
+	char* Receiving = static_cast<char*>(In);
+
+	while (OutSize > 0 || InSize > 0) {
+		pollfd Waiting[2];
+		nfds_t Count = 0;
+		const nfds_t SendSlot = Count;
+		if (OutSize > 0) {
+			Waiting[Count++] = {Next.GetDescriptor(), POLLOUT, 0};
+		}
+		const nfds_t ReceiveSlot = Count;
+		if (InSize > 0) {
+			Waiting[Count++] = {Previous.GetDescriptor(), POLLIN, 0};
+		}
+
+		const int Ready = ::poll(Waiting, Count, ToMilliseconds(TimeoutSeconds));
+		if (Ready < 0 && errno == EINTR) {
+			continue;
+		}
+		if (Ready <= 0) {
+			throw std::runtime_error("RingAllReduce: rank " + std::to_string(Rank) + " timed out waiting for its neighbours");
+		}
+
+		if (OutSize > 0 && Waiting[SendSlot].revents != 0) {
+			const ssize_t Sent = ::send(Next.GetDescriptor(), Sending, OutSize, MSG_NOSIGNAL | MSG_DONTWAIT);
+			if (Sent < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+				throw std::runtime_error("RingAllReduce: rank " + std::to_string(Rank) + " lost its successor: "
+				                         + std::strerror(errno));
+			}
+			if (Sent > 0) {
+				Sending += Sent;
+				OutSize -= static_cast<std::size_t>(Sent);
+			}
+		}
+		if (InSize > 0 && Waiting[ReceiveSlot].revents != 0) {
+			const ssize_t Received = ::recv(Previous.GetDescriptor(), Receiving, InSize, MSG_DONTWAIT);
+			if (Received == 0 || (Received < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+				throw std::runtime_error("RingAllReduce: rank " + std::to_string(Rank) + " lost its predecessor");
+			}
+			if (Received > 0) {
+				Receiving += Received;
+				InSize -= static_cast<std::size_t>(Received);
+			}
+		}
+	}
+}
+
+
+void RingAllReduce::AllReduce(std::vector<double>& Values)
+{
+	if (NumRanks == 1) {
+		return;
+	}
+	LEARNSCRAPE_SCOPED_TIMER(ReportPhase::AllReduce);
+	LEARNSCRAPE_RECORD_VOLUME(ReportPhase::AllReduce, Values.size(),
+	                          2 * (NumRanks - 1) * Values.size() * sizeof(double) / NumRanks);
+
+	// Ranks that call out of step would otherwise pair up unrelated chunks.
+	const std::uint64_t Length = Values.size();
+	std::uint64_t PreviousLength = 0;
+	Exchange(&Length, sizeof(Length), &PreviousLength, sizeof(PreviousLength));
+	if (PreviousLength != Length) {
+		throw std::runtime_error("RingAllReduce: rank " + std::to_string(Rank) + " reduces " + std::to_string(Length)
+		                         + " values but its predecessor reduces " + std::to_string(PreviousLength));
+	}
+
+	const auto ChunkBegin = [&](std::size_t Chunk) { return Chunk * Values.size() / NumRanks; };
+	const auto ChunkSize = [&](std::size_t Chunk) { return ChunkBegin(Chunk + 1) - ChunkBegin(Chunk); };
+	Incoming.resize(Values.size() / NumRanks + 1);
+
+	// Reduce-scatter: pass partial sums forward, adding our own on arrival.
+	for (std::size_t Step = 0; Step + 1 < NumRanks; Step++) {
+		const std::size_t SendChunk = (Rank + NumRanks - Step) % NumRanks;
+		const std::size_t ReceiveChunk = (Rank + NumRanks - Step - 1) % NumRanks;
+		Exchange(Values.data() + ChunkBegin(SendChunk), ChunkSize(SendChunk) * sizeof(double),
+		         Incoming.data(), ChunkSize(ReceiveChunk) * sizeof(double));
+
+		double* Target = Values.data() + ChunkBegin(ReceiveChunk);
+		for (std::size_t Index = 0; Index < ChunkSize(ReceiveChunk); Index++) {
+			Target[Index] += Incoming[Index];
+		}
+	}
+
+	// All-gather: rank r now owns the finished chunk r + 1; circulate them.
+	for (std::size_t Step = 0; Step + 1 < NumRanks; Step++) {
+		const std::size_t SendChunk = (Rank + 1 + NumRanks - Step) % NumRanks;
+		const std::size_t ReceiveChunk = (Rank + NumRanks - Step) % NumRanks;
+		Exchange(Values.data() + ChunkBegin(SendChunk), ChunkSize(SendChunk) * sizeof(double),
+		         Values.data() + ChunkBegin(ReceiveChunk), ChunkSize(ReceiveChunk) * sizeof(double));
+	}
+}
+
+} // namespace CoreUtilities
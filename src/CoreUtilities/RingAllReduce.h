@@ -0,0 +1,125 @@
+#ifndef __RingAllReduce__
+#define __RingAllReduce__
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/* RING ALL-REDUCE */
+// Sums a vector of doubles across N cooperating processes so that each one
+// ends up holding the total. The processes form a ring: each holds a stream
+// connection to its successor and one from its predecessor. The vector is
+// cut into N chunks.
+// - Reduce-scatter: for N - 1 steps, every rank sends one chunk forward and
+//   adds the chunk arriving from behind. Rank r then holds the complete sum
+//   of chunk r + 1.
+// - All-gather: N - 1 more steps pass the finished chunks around the ring.
+// Each rank sends and receives 2 (N - 1) / N of the vector, so traffic per
+// rank stays flat as N grows. Each chunk is summed once, in one fixed
+// order, and then copied, so every rank ends with bit-identical results.
+// Values are sent in native byte order, so all ranks must share an
+// architecture.
+//
+// Endpoints are written "unix:<path>", "tcp:<host>:<port>" or as a bare
+// socket path. On one machine, Unix sockets are the cheaper choice.
+
+namespace CoreUtilities {
+
+struct SocketEndpoint {
+	bool bTcp = false;
+	// Socket path, or host for TCP.
+	std::string Address;
+	std::uint16_t Port = 0;
+
+	// Throws std::invalid_argument for a malformed endpoint.
+	static SocketEndpoint Parse(const std::string& Text);
+	std::string ToString() const;
+};
+
+
+// Blocking stream connection that owns its descriptor.
+class SocketConnection {
+private:
+	int Descriptor;
+
+public:
+	explicit SocketConnection(int InDescriptor = -1);
+	SocketConnection(SocketConnection&& Other) noexcept;
+	SocketConnection& operator=(SocketConnection&& Other) noexcept;
+	SocketConnection(const SocketConnection&) = delete;
+	SocketConnection& operator=(const SocketConnection&) = delete;
+	~SocketConnection();
+
+	// Retries while nothing is listening at Endpoint yet, so peers may start
+	// in any order. Throws std::runtime_error after TimeoutSeconds.
+	static SocketConnection Connect(const SocketEndpoint& Endpoint, double TimeoutSeconds);
+
+	int GetDescriptor() const { return Descriptor; }
+
+	// Bound every later Send / Receive; a stalled peer then raises an error
+	// instead of hanging the caller.
+	void SetTimeout(double Seconds);
+
+	// Throw std::runtime_error if the peer goes away or times out mid-message.
+	void Send(const void* Data, std::size_t Size);
+	void Receive(void* Data, std::size_t Size);
+};
+
+
+class SocketListener {
+private:
+	int Descriptor;
+	SocketEndpoint Endpoint;
+
+public:
+	// Binds and listens, replacing a stale socket file. A TCP port of 0
+	// takes any free port; GetEndpoint reports the one chosen. Throws
+	// std::runtime_error if the socket cannot be bound.
+	explicit SocketListener(const SocketEndpoint& InEndpoint, int Backlog = 64);
+	SocketListener(const SocketListener&) = delete;
+	SocketListener& operator=(const SocketListener&) = delete;
+	~SocketListener();
+
+	const SocketEndpoint& GetEndpoint() const { return Endpoint; }
+
+	// Throws std::runtime_error if nobody connects within TimeoutSeconds.
+	SocketConnection Accept(double TimeoutSeconds);
+};
+
+
+class RingAllReduce {
+private:
+	std::size_t Rank;
+	std::size_t NumRanks;
+	double TimeoutSeconds;
+	SocketConnection Next;
+	SocketConnection Previous;
+	std::vector<double> Incoming;
+
+	// Send Out to the successor while receiving In from the predecessor.
+	// Both directions progress together, so a ring of blocked senders
+	// cannot deadlock.
+	void Exchange(const void* Out, std::size_t OutSize, void* In, std::size_t InSize);
+
+public:
+	// Join the ring as Rank of NumRanks. Connects to the successor at
+	// NextEndpoint and accepts the predecessor on Listener, which must
+	// already be listening. A single rank opens no connections. Throws
+	// std::runtime_error if a neighbour does not appear within
+	// InTimeoutSeconds, which also bounds every later exchange.
+	RingAllReduce(std::size_t InRank, std::size_t InNumRanks, SocketListener& Listener,
+	              const SocketEndpoint& NextEndpoint, double InTimeoutSeconds = 300.0);
+
+	std::size_t GetRank() const { return Rank; }
+	std::size_t GetNumRanks() const { return NumRanks; }
+
+	// Replace Values by their element-wise sum over all ranks. Every rank
+	// must call this in the same order with vectors of the same length;
+	// otherwise it throws std::runtime_error.
+	void AllReduce(std::vector<double>& Values);
+};
+
+} // namespace CoreUtilities
+
+#endif // __RingAllReduce__
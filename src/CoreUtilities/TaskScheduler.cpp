@@ -0,0 +1,316 @@
+#include "CoreUtilities/TaskScheduler.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "CoreUtilities/ReportGeneration.h"
+
+namespace CoreUtilities {
+
+namespace {
+
+// Worker identity of the current thread: which pool it belongs to and its
+// queue index within that pool.
+thread_local const TaskScheduler* CurrentScheduler = nullptr;
+thread_local int CurrentWorkerIndex = -1;
+
+
+// Parse a sysfs CPU list such as "0-3,8-11" into individual CPU ids.
+std::vector<int> ParseCpuList(const std::string& CpuList)
+{
+	std::vector<int> Cpus;
+	std::stringstream Stream(CpuList);
+	std::string Range;
+
+	while (std::getline(Stream, Range, ',')) {
+		if (Range.empty()) {
+			continue;
+		}
+		const std::size_t Dash = Range.find('-');
+		const int First = std::atoi(Range.substr(0, Dash).c_str());
+		const int Last = (Dash == std::string::npos) ? First : std::atoi(Range.substr(Dash + 1).c_str());
+		for (int Cpu = First; Cpu <= Last; Cpu++) {
+			Cpus.push_back(Cpu);
+		}
+	}
+	return Cpus;
+}
+
+
+// CPUs ordered node by node, so that worker i and worker i+1 land on the
+// same NUMA node until it is full. Falls back to 0..n-1 without sysfs.
+std::vector<int> NumaOrderedCpus()
+{
+	std::vector<int> Cpus;
+
+	for (int Node = 0;; Node++) {
+		std::ifstream NodeList("/sys/devices/system/node/node" + std::to_string(Node) + "/cpulist");
+		if (!NodeList) {
+			break;
+		}
+		std::string Line;
+		std::getline(NodeList, Line);
+		const std::vector<int> NodeCpus = ParseCpuList(Line);
+		Cpus.insert(Cpus.end(), NodeCpus.begin(), NodeCpus.end());
+	}
+
+	if (Cpus.empty()) {
+		const unsigned NumCpus = std::max(1u, std::thread::hardware_concurrency());
+		for (unsigned Cpu = 0; Cpu < NumCpus; Cpu++) {
+			Cpus.push_back(static_cast<int>(Cpu));
+		}
+	}
+	return Cpus;
+}
+
+
+void PinCurrentThread(int Cpu)
+{
+#ifdef __linux__
+	cpu_set_t CpuSet;
+	CPU_ZERO(&CpuSet);
+	CPU_SET(Cpu, &CpuSet);
+	pthread_setaffinity_np(pthread_self(), sizeof(CpuSet), &CpuSet);
+#else
+	(void)Cpu;
+#endif
+}
+
+} // namespace
+
+
+/*============================================================================*/
+// TASK GROUP
+/*============================================================================*/
+
+TaskGroup::TaskGroup(TaskScheduler& InScheduler)
+	: Scheduler(InScheduler), Outstanding(0)
+{
+}
+
+
+TaskGroup::~TaskGroup()
+{
+	// Tasks reference the group; never let it go out of scope under them.
+	while (Outstanding.load(std::memory_order_acquire) != 0) {
+		if (!Scheduler.RunPendingTask()) {
+			std::this_thread::yield();
+		}
+	}
+}
+
+
+void TaskGroup::Run(std::function<void()> Task)
+{
+	Outstanding.fetch_add(1, std::memory_order_relaxed);
+
+	Scheduler.Push([this, Work = std::move(Task)]() {
+		try {
+			Work();
+		} catch (...) {
+			std::lock_guard<std::mutex> Guard(ErrorLock);
+			if (!FirstError) {
+				FirstError = std::current_exception();
+			}
+		}
+		Outstanding.fetch_sub(1, std::memory_order_release);
+	});
+}
+
+
+void TaskGroup::Wait()
+{
+	while (Outstanding.load(std::memory_order_acquire) != 0) {
+		if (!Scheduler.RunPendingTask()) {
+			std::this_thread::yield();
+		}
+	}
+
+	std::exception_ptr Error;
+	{
+		std::lock_guard<std::mutex> Guard(ErrorLock);
+		std::swap(Error, FirstError);
+	}
+	if (Error) {
+		std::rethrow_exception(Error);
+	}
+}
+
+
+/*============================================================================*/
+// TASK SCHEDULER
+/*============================================================================*/
+
+TaskScheduler::TaskScheduler(unsigned NumWorkers, bool bPinWorkers)
+	: PendingTasks(0), NextQueue(0), bStopping(false)
+{
+	if (NumWorkers == 0) {
+		NumWorkers = std::max(1u, std::thread::hardware_concurrency());
+	}
+
+	std::vector<int> CpuOrder;
+	if (bPinWorkers) {
+		CpuOrder = NumaOrderedCpus();
+	}
+
+	for (unsigned Index = 0; Index < NumWorkers; Index++) {
+		Queues.push_back(std::make_unique<WorkerQueue>());
+	}
+	for (unsigned Index = 0; Index < NumWorkers; Index++) {
+		const int Cpu = CpuOrder.empty() ? -1 : CpuOrder[Index % CpuOrder.size()];
+		Workers.emplace_back(&TaskScheduler::WorkerLoop, this, Index, Cpu);
+	}
+}
+
+
+TaskScheduler::~TaskScheduler()
+{
+	{
+		std::lock_guard<std::mutex> Guard(SleepLock);
+		bStopping = true;
+	}
+	WakeUp.notify_all();
+
+	for (std::thread& Worker : Workers) {
+		Worker.join();
+	}
+}
+
+
+TaskScheduler& TaskScheduler::Get()
+{
+	static TaskScheduler Instance = []() {
+		const char* ThreadsVariable = std::getenv("LEARNSCRAPE_NUM_THREADS");
+		const char* PinVariable = std::getenv("LEARNSCRAPE_PIN_WORKERS");
+		const int Threads = ThreadsVariable ? std::atoi(ThreadsVariable) : 0;
+		const bool bPin = PinVariable && std::string(PinVariable) == "1";
+		return TaskScheduler(Threads > 0 ? static_cast<unsigned>(Threads) : 0u, bPin);
+	}();
+	return Instance;
+}
+
+
+int TaskScheduler::GetCurrentWorker() const
+{
+	return (CurrentScheduler == this) ? CurrentWorkerIndex : -1;
+}
+
+
+std::size_t TaskScheduler::ResolveGrainSize(std::size_t Count, std::size_t GrainSize) const
+{
+	if (GrainSize > 0) {
+		return GrainSize;
+	}
+	const std::size_t TargetChunks = 4 * static_cast<std::size_t>(GetNumWorkers());
+	return std::max<std::size_t>(1, (Count + TargetChunks - 1) / TargetChunks);
+}
+
+
+void TaskScheduler::Push(Task&& Work)
+{
+	// Workers push onto their own deque (cache-hot, popped LIFO); outside
+	// threads spread their submissions round-robin.
+	const int Self = GetCurrentWorker();
+	const std::size_t QueueIndex = (Self >= 0)
+		? static_cast<std::size_t>(Self)
+		: NextQueue.fetch_add(1, std::memory_order_relaxed) % Queues.size();
+
+	{
+		std::lock_guard<std::mutex> Guard(Queues[QueueIndex]->Lock);
+		Queues[QueueIndex]->Tasks.push_back(std::move(Work));
+	}
+	PendingTasks.fetch_add(1, std::memory_order_release);
+
+	// Taking the sleep lock orders this notify after any worker's predicate
+	// check, so a worker about to sleep cannot miss the new task.
+	{
+		std::lock_guard<std::mutex> Guard(SleepLock);
+	}
+	WakeUp.notify_one();
+}
+
+
+bool TaskScheduler::TryPop(unsigned QueueIndex, Task& Out)
+{
+	WorkerQueue& Queue = *Queues[QueueIndex];
+	std::lock_guard<std::mutex> Guard(Queue.Lock);
+	if (Queue.Tasks.empty()) {
+		return false;
+	}
+	Out = std::move(Queue.Tasks.back());
+	Queue.Tasks.pop_back();
+	return true;
+}
+
+
+bool TaskScheduler::TrySteal(unsigned Thief, Task& Out)
+{
+	const unsigned NumQueues = static_cast<unsigned>(Queues.size());
+
+	for (unsigned Offset = 1; Offset <= NumQueues; Offset++) {
+		WorkerQueue& Victim = *Queues[(Thief + Offset) % NumQueues];
+		std::lock_guard<std::mutex> Guard(Victim.Lock);
+		if (!Victim.Tasks.empty()) {
+			Out = std::move(Victim.Tasks.front());
+			Victim.Tasks.pop_front();
+			return true;
+		}
+	}
+	return false;
+}
+
+
+bool TaskScheduler::RunPendingTask()
+{
+	if (PendingTasks.load(std::memory_order_acquire) == 0) {
+		return false;
+	}
+
+	Task Work;
+	const int Self = GetCurrentWorker();
+	const unsigned Start = (Self >= 0)
+		? static_cast<unsigned>(Self)
+		: static_cast<unsigned>(NextQueue.load(std::memory_order_relaxed) % Queues.size());
+
+	if ((Self >= 0 && TryPop(Start, Work)) || TrySteal(Start, Work)) {
+		PendingTasks.fetch_sub(1, std::memory_order_acq_rel);
+		LEARNSCRAPE_SCOPED_BUSY();
+		Work();
+		return true;
+	}
+	return false;
+}
+
+
+void TaskScheduler::WorkerLoop(unsigned WorkerIndex, int PinnedCpu)
+{
+	CurrentScheduler = this;
+	CurrentWorkerIndex = static_cast<int>(WorkerIndex);
+
+	if (PinnedCpu >= 0) {
+		PinCurrentThread(PinnedCpu);
+	}
+
+	for (;;) {
+		if (RunPendingTask()) {
+			continue;
+		}
+
+		std::unique_lock<std::mutex> Guard(SleepLock);
+		WakeUp.wait(Guard, [this]() {
+			return bStopping || PendingTasks.load(std::memory_order_acquire) != 0;
+		});
+		if (bStopping && PendingTasks.load(std::memory_order_acquire) == 0) {
+			return;
+		}
+	}
+}
+
+} // namespace CoreUtilities
@@ -0,0 +1,173 @@
+#ifndef __TaskScheduler__
+#define __TaskScheduler__
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/* TASK SCHEDULER */
+// Single work-stealing thread pool shared by every parallel kernel. Each
+// worker owns a deque: it pushes and pops its own tasks at the back while
+// idle workers steal from the front of the others. Threads that wait on a
+// TaskGroup keep executing queued tasks, so nested parallel sections do not
+// deadlock and the calling thread contributes to the work.
+
+namespace CoreUtilities {
+
+class TaskScheduler;
+
+// Tracks a batch of submitted tasks; the first exception thrown by any of
+// them is rethrown from Wait().
+class TaskGroup {
+private:
+	TaskScheduler& Scheduler;
+	std::atomic<std::size_t> Outstanding;
+	std::mutex ErrorLock;
+	std::exception_ptr FirstError;
+
+	friend class TaskScheduler;
+
+public:
+	explicit TaskGroup(TaskScheduler& InScheduler);
+	TaskGroup(const TaskGroup&) = delete;
+	TaskGroup& operator=(const TaskGroup&) = delete;
+	~TaskGroup();
+
+	void Run(std::function<void()> Task);
+	void Wait();
+};
+
+
+class TaskScheduler {
+public:
+	using Task = std::function<void()>;
+
+private:
+	struct WorkerQueue {
+		std::mutex Lock;
+		std::deque<Task> Tasks;
+	};
+
+	std::vector<std::unique_ptr<WorkerQueue>> Queues;
+	std::vector<std::thread> Workers;
+	std::atomic<std::size_t> PendingTasks;
+	std::atomic<std::size_t> NextQueue;
+	std::mutex SleepLock;
+	std::condition_variable WakeUp;
+	bool bStopping;
+
+	void WorkerLoop(unsigned WorkerIndex, int PinnedCpu);
+	bool TryPop(unsigned QueueIndex, Task& Out);
+	bool TrySteal(unsigned Thief, Task& Out);
+	void Push(Task&& Work);
+
+	friend class TaskGroup;
+
+public:
+	// NumWorkers == 0 selects std::thread::hardware_concurrency(). With
+	// bPinWorkers set, workers are bound to CPUs ordered node by node so
+	// consecutive workers share a NUMA node.
+	explicit TaskScheduler(unsigned NumWorkers = 0, bool bPinWorkers = false);
+	TaskScheduler(const TaskScheduler&) = delete;
+	TaskScheduler& operator=(const TaskScheduler&) = delete;
+	~TaskScheduler();
+
+	// Process-wide pool. Sized by LEARNSCRAPE_NUM_THREADS and pinned when
+	// LEARNSCRAPE_PIN_WORKERS=1; otherwise one worker per hardware thread.
+	static TaskScheduler& Get();
+
+	unsigned GetNumWorkers() const { return static_cast<unsigned>(Workers.size()); }
+
+	// Index of the calling worker in this pool, or -1 for outside threads.
+	int GetCurrentWorker() const;
+
+	// Execute one queued task if any is available; used by waiting threads.
+	bool RunPendingTask();
+
+	// Split [Begin, End) into chunks of at most GrainSize iterations and call
+	// Body(ChunkBegin, ChunkEnd) on each. GrainSize == 0 picks a chunk size
+	// giving roughly four chunks per worker.
+	template <typename BodyType>
+	void ParallelFor(std::size_t Begin, std::size_t End, std::size_t GrainSize, const BodyType& Body);
+
+	// Reduce Map(ChunkBegin, ChunkEnd) over the chunks of [Begin, End) with
+	// Combine. Partials are combined in chunk order so the result does not
+	// depend on which worker ran which chunk.
+	template <typename ValueType, typename MapType, typename CombineType>
+	ValueType ParallelReduce(std::size_t Begin, std::size_t End, std::size_t GrainSize,
+	                         ValueType Identity, const MapType& Map, const CombineType& Combine);
+
+	std::size_t ResolveGrainSize(std::size_t Count, std::size_t GrainSize) const;
+};
+
+
+/*============================================================================*/
+// TEMPLATE DEFINITIONS
+/*============================================================================*/
+
+template <typename BodyType>
+void TaskScheduler::ParallelFor(std::size_t Begin, std::size_t End, std::size_t GrainSize, const BodyType& Body)
+{
+	if (End <= Begin) {
+		return;
+	}
+
+	const std::size_t Grain = ResolveGrainSize(End - Begin, GrainSize);
+	if (End - Begin <= Grain) {
+		Body(Begin, End);
+		return;
+	}
+
+	TaskGroup Group(*this);
+	for (std::size_t ChunkBegin = Begin; ChunkBegin < End; ChunkBegin += Grain) {
+		const std::size_t ChunkEnd = std::min(End, ChunkBegin + Grain);
+		Group.Run([&Body, ChunkBegin, ChunkEnd]() { Body(ChunkBegin, ChunkEnd); });
+	}
+	Group.Wait();
+}
+
+
+template <typename ValueType, typename MapType, typename CombineType>
+ValueType TaskScheduler::ParallelReduce(std::size_t Begin, std::size_t End, std::size_t GrainSize,
+                                        ValueType Identity, const MapType& Map, const CombineType& Combine)
+{
+	if (End <= Begin) {
+		return Identity;
+	}
+
+	const std::size_t Grain = ResolveGrainSize(End - Begin, GrainSize);
+	if (End - Begin <= Grain) {
+		return Combine(Identity, Map(Begin, End));
+	}
+
+	const std::size_t NumChunks = (End - Begin + Grain - 1) / Grain;
+	std::vector<ValueType> Partials(NumChunks, Identity);
+
+	TaskGroup Group(*this);
+	for (std::size_t Chunk = 0; Chunk < NumChunks; Chunk++) {
+		const std::size_t ChunkBegin = Begin + Chunk * Grain;
+		const std::size_t ChunkEnd = std::min(End, ChunkBegin + Grain);
+		Group.Run([&Partials, &Map, Chunk, ChunkBegin, ChunkEnd]() {
+			Partials[Chunk] = Map(ChunkBegin, ChunkEnd);
+		});
+	}
+	Group.Wait();
+
+	ValueType Result = Identity;
+	for (std::size_t Chunk = 0; Chunk < NumChunks; Chunk++) {
+		Result = Combine(Result, Partials[Chunk]);
+	}
+	return Result;
+}
+
+} // namespace CoreUtilities
+
+#endif // __TaskScheduler__
@@ -0,0 +1,390 @@
+#include "MachineLearning/DistributedTraining/DataParallelTraining.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "CoreUtilities/TaskScheduler.h"
+#include "MachineLearning/LinearRegression/CostFunction.h"
+#include "MachineLearning/LinearRegression/NormalEquation.h"
+#include "MachineLearning/LogisticRegression/CostFunction.h"
+#include "NumericalAlgorithms/OptimisationAlgorithms/DistributedDescent.h"
+
+namespace DistributedTraining {
+
+using CoreUtilities::SocketConnection;
+using CoreUtilities::SocketEndpoint;
+using ModelRepresentation::KernelBlockSize;
+using ModelRepresentation::TrainingSet;
+using ModelRepresentation::TrainingView;
+
+namespace {
+
+// "LSDT" plus a protocol version, so a stray client is rejected up front.
+const std::uint64_t ProtocolMagic = 0x4c53445401ull;
+const std::uint64_t MaxEndpointLength = 4096;
+
+
+// Worker -> coordinator, followed by the worker's ring endpoint.
+struct JoinMessage {
+	std::uint64_t Magic;
+	std::uint64_t NumExamples;
+	std::uint64_t NumFeatures;
+	std::uint64_t EndpointLength;
+};
+
+// Coordinator -> worker, followed by the successor's ring endpoint.
+struct AssignmentMessage {
+	std::uint64_t Rank;
+	std::uint64_t NumRanks;
+	std::uint64_t TotalExamples;
+	std::uint64_t Method;
+	double LearningRate;
+	double Lambda;
+	std::uint64_t EndpointLength;
+};
+
+// Worker -> coordinator after every all-reduce; answered by one uint64,
+// non-zero to continue.
+struct ReportMessage {
+	std::uint64_t Steps;
+	double Cost;
+};
+
+
+// Send / Receive with the peer named in any error.
+void SendTo(SocketConnection& Connection, const void* Data, std::size_t Size, const std::string& Peer)
+{
+	try {
+		Connection.Send(Data, Size);
+	} catch (const std::runtime_error& Error) {
+		throw std::runtime_error(Peer + ": " + Error.what());
+	}
+}
+
+
+void ReceiveFrom(SocketConnection& Connection, void* Data, std::size_t Size, const std::string& Peer)
+{
+	try {
+		Connection.Receive(Data, Size);
+	} catch (const std::runtime_error& Error) {
+		throw std::runtime_error(Peer + ": " + Error.what());
+	}
+}
+
+
+std::string ReceiveText(SocketConnection& Connection, std::uint64_t Length, const std::string& Peer)
+{
+	if (Length == 0 || Length > MaxEndpointLength) {
+		throw std::runtime_error(Peer + ": bad endpoint length " + std::to_string(Length));
+	}
+	std::string Text(Length, '\0');
+	ReceiveFrom(Connection, &Text[0], Length, Peer);
+	return Text;
+}
+
+
+std::string WorkerName(std::size_t Rank)
+{
+	return "TrainingCoordinator: worker " + std::to_string(Rank);
+}
+
+
+// Sum Term(Feature, x) over every row, per feature.
+template <typename TermType>
+std::vector<double> SumColumns(const TrainingView& View, TermType&& Term)
+{
+	std::vector<double> Sums(View.GetNumFeatures(), 0.0);
+	CoreUtilities::TaskScheduler::Get().ParallelFor(0, Sums.size(), 1, [&](std::size_t Begin, std::size_t End) {
+		double Values[KernelBlockSize];
+		for (std::size_t Feature = Begin; Feature < End; Feature++) {
+			for (std::size_t Block = 0; Block < View.GetNumExamples(); Block += KernelBlockSize) {
+				const std::size_t BlockEnd = std::min(View.GetNumExamples(), Block + KernelBlockSize);
+				View.GatherColumn(Feature, Block, BlockEnd, Values);
+				for (std::size_t Index = 0; Index < BlockEnd - Block; Index++) {
+					Sums[Feature] += Term(Feature, Values[Index]);
+				}
+			}
+		}
+	});
+	return Sums;
+}
+
+
+// Two passes, as TrainingSet::Standardise takes them: the means first, then
+// the spread about them, each summed over the ring.
+void StandardiseAcrossShards(TrainingSet& Shard, CoreUtilities::RingAllReduce& Ring, double TotalExamples)
+{
+	const TrainingView View(Shard);
+	std::vector<double> Means = SumColumns(View, [](std::size_t, double Value) { return Value; });
+	Ring.AllReduce(Means);
+	for (double& Mean : Means) {
+		Mean /= TotalExamples;
+	}
+
+	std::vector<double> Deviations = SumColumns(View, [&Means](std::size_t Feature, double Value) {
+		return (Value - Means[Feature]) * (Value - Means[Feature]);
+	});
+	Ring.AllReduce(Deviations);
+	for (double& Deviation : Deviations) {
+		Deviation = std::sqrt(Deviation / TotalExamples);
+	}
+	Shard.Standardise(Means, Deviations);
+}
+
+
+// lambda/(2m) sum_{j>=1} theta_j^2, added once for the whole objective.
+double Penalty(const std::vector<double>& Theta, double Lambda, double TotalExamples, std::vector<double>* Gradient)
+{
+	double SumSquares = 0.0;
+	for (std::size_t Index = 1; Index < Theta.size(); Index++) {
+		SumSquares += Theta[Index] * Theta[Index];
+		if (Gradient) {
+			(*Gradient)[Index] += Lambda * Theta[Index] / TotalExamples;
+		}
+	}
+	return Lambda * SumSquares / (2.0 * TotalExamples);
+}
+
+
+// This shard's term of the objective. The local cost and gradient are
+// averages over the shard, so they are weighted by its share of the rows;
+// rank 0 adds the regularisation.
+double ShardTerm(TrainingMethod Method, const TrainingView& View, const std::vector<double>& Theta,
+                 double Lambda, double TotalExamples, bool bRegularise, std::vector<double>& Gradient)
+{
+	double Cost = 0.0;
+	if (View.GetNumExamples() > 0) {
+		const LinearRegression::CostGradient Local = (Method == TrainingMethod::LogisticDescent)
+			? LogisticRegression::ComputeCostGradient(View, Theta, 0.0)
+			: LinearRegression::ComputeCostGradient(View, Theta, 0.0);
+		const double Share = static_cast<double>(View.GetNumExamples()) / TotalExamples;
+		Cost = Local.Cost * Share;
+		for (std::size_t Index = 0; Index < Gradient.size(); Index++) {
+			Gradient[Index] = Local.Gradient[Index] * Share;
+		}
+	}
+	if (bRegularise && Lambda > 0.0) {
+		Cost += Penalty(Theta, Lambda, TotalExamples, &Gradient);
+	}
+	return Cost;
+}
+
+
+// Sum every shard's X^T X and X^T y and solve; the same on every rank.
+std::vector<double> SolveNormalEquation(const TrainingView& View, CoreUtilities::RingAllReduce& Ring,
+                                        std::size_t TotalExamples, double Lambda)
+{
+	const LinearRegression::NormalEquationSystem Local = LinearRegression::NormalEquationSystem::Accumulate(View);
+	const std::size_t GramSize = Local.GetGram().size();
+	std::vector<double> Packed(Local.GetGram());
+	Packed.insert(Packed.end(), Local.GetMoment().begin(), Local.GetMoment().end());
+	Ring.AllReduce(Packed);
+
+	const LinearRegression::NormalEquationSystem Total(TotalExamples,
+		std::vector<double>(Packed.begin(), Packed.begin() + GramSize),
+		std::vector<double>(Packed.begin() + GramSize, Packed.end()));
+	return Total.Solve(Lambda);
+}
+
+} // namespace
+
+
+/*============================================================================*/
+// COORDINATOR
+/*============================================================================*/
+
+TrainingCoordinator::TrainingCoordinator(const SocketEndpoint& Endpoint, std::size_t InNumWorkers,
+                                         DistributedOptions InOptions)
+	: Listener(Endpoint), NumWorkers(InNumWorkers), Options(InOptions)
+{
+	if (NumWorkers == 0) {
+		throw std::invalid_argument("TrainingCoordinator: need at least one worker");
+	}
+}
+
+
+void TrainingCoordinator::SetIterationObserver(ModelRepresentation::LearningModel::IterationObserver InObserver)
+{
+	Observer = std::move(InObserver);
+}
+
+
+std::size_t TrainingCoordinator::AssignRanks(DistributedResult& Result)
+{
+	Workers.clear();
+	std::vector<std::string> Endpoints;
+	std::uint64_t NumFeatures = 0;
+
+	for (std::size_t Rank = 0; Rank < NumWorkers; Rank++) {
+		SocketConnection Worker = Listener.Accept(Options.TimeoutSeconds);
+		Worker.SetTimeout(Options.TimeoutSeconds);
+		JoinMessage Join;
+		ReceiveFrom(Worker, &Join, sizeof(Join), WorkerName(Rank));
+		if (Join.Magic != ProtocolMagic) {
+			throw std::runtime_error(WorkerName(Rank) + ": not a learnscrape worker");
+		}
+		if (Rank > 0 && Join.NumFeatures != NumFeatures) {
+			throw std::runtime_error(WorkerName(Rank) + ": shard has " + std::to_string(Join.NumFeatures)
+			                         + " features, worker 0 has " + std::to_string(NumFeatures));
+		}
+		NumFeatures = Join.NumFeatures;
+		Endpoints.push_back(ReceiveText(Worker, Join.EndpointLength, WorkerName(Rank)));
+		Result.NumExamples += Join.NumExamples;
+		Workers.push_back(std::move(Worker));
+	}
+	if (Result.NumExamples == 0) {
+		throw std::runtime_error("TrainingCoordinator: the shards hold no rows");
+	}
+
+	for (std::size_t Rank = 0; Rank < NumWorkers; Rank++) {
+		const std::string& Next = Endpoints[(Rank + 1) % NumWorkers];
+		const AssignmentMessage Assignment = {Rank, NumWorkers, Result.NumExamples,
+		                                      static_cast<std::uint64_t>(Options.Method), Options.LearningRate,
+		                                      Options.Lambda, Next.size()};
+		SendTo(Workers[Rank], &Assignment, sizeof(Assignment), WorkerName(Rank));
+		SendTo(Workers[Rank], Next.data(), Next.size(), WorkerName(Rank));
+	}
+	Result.NumWorkers = NumWorkers;
+	return NumFeatures;
+}
+
+
+bool TrainingCoordinator::ShouldContinue(std::size_t Steps, double Cost, double PreviousCost) const
+{
+	if (Options.Method == TrainingMethod::NormalEquation || Steps >= Options.MaxIterations || !std::isfinite(Cost)) {
+		return false;
+	}
+	return Steps == 0 || std::fabs(PreviousCost - Cost) > Options.Tolerance * std::fabs(PreviousCost);
+}
+
+
+DistributedResult TrainingCoordinator::Run()
+{
+	DistributedResult Result;
+	Result.Method = Options.Method;
+	const std::size_t NumFeatures = AssignRanks(Result);
+
+	double PreviousCost = 0.0;
+	for (;;) {
+		ReportMessage First;
+		for (std::size_t Rank = 0; Rank < NumWorkers; Rank++) {
+			ReportMessage Report;
+			ReceiveFrom(Workers[Rank], &Report, sizeof(Report), WorkerName(Rank));
+			if (Rank == 0) {
+				First = Report;
+			} else if (std::memcmp(&Report, &First, sizeof(Report)) != 0) {
+				throw std::runtime_error(WorkerName(Rank) + ": reported cost " + std::to_string(Report.Cost)
+				                         + " after " + std::to_string(Report.Steps) + " steps, worker 0 "
+				                         + std::to_string(First.Cost) + " after " + std::to_string(First.Steps));
+			}
+		}
+		if (Observer) {
+			Observer(First.Steps, First.Cost);
+		}
+
+		const std::uint64_t Continue = ShouldContinue(First.Steps, First.Cost, PreviousCost) ? 1 : 0;
+		for (std::size_t Rank = 0; Rank < NumWorkers; Rank++) {
+			SendTo(Workers[Rank], &Continue, sizeof(Continue), WorkerName(Rank));
+		}
+		PreviousCost = First.Cost;
+		if (!Continue) {
+			Result.Cost = First.Cost;
+			Result.Iterations = First.Steps;
+			break;
+		}
+	}
+
+	Result.Theta.resize(NumFeatures + 1);
+	std::vector<double> Theta(NumFeatures + 1);
+	for (std::size_t Rank = 0; Rank < NumWorkers; Rank++) {
+		ReceiveFrom(Workers[Rank], Rank == 0 ? Result.Theta.data() : Theta.data(), Theta.size() * sizeof(double),
+		            WorkerName(Rank));
+		if (Rank > 0 && std::memcmp(Theta.data(), Result.Theta.data(), Theta.size() * sizeof(double)) != 0) {
+			throw std::runtime_error(WorkerName(Rank) + ": finished with a different theta from worker 0");
+		}
+	}
+	Workers.clear();
+	return Result;
+}
+
+
+/*============================================================================*/
+// WORKER
+/*============================================================================*/
+
+DistributedResult TrainShard(TrainingSet& Shard, const SocketEndpoint& Coordinator, const SocketEndpoint& RingEndpoint,
+                             double TimeoutSeconds, std::size_t* Rank)
+{
+	const std::string Peer = "TrainShard: coordinator " + Coordinator.ToString();
+
+	// Listen before joining, so the ring endpoint exists by the time the
+	// coordinator hands it to our predecessor.
+	CoreUtilities::SocketListener Listener(RingEndpoint);
+	SocketConnection Link = SocketConnection::Connect(Coordinator, TimeoutSeconds);
+	Link.SetTimeout(TimeoutSeconds);
+
+	const std::string Advertised = Listener.GetEndpoint().ToString();
+	const JoinMessage Join = {ProtocolMagic, Shard.GetNumExamples(), Shard.GetNumFeatures(), Advertised.size()};
+	SendTo(Link, &Join, sizeof(Join), Peer);
+	SendTo(Link, Advertised.data(), Advertised.size(), Peer);
+
+	AssignmentMessage Assignment;
+	ReceiveFrom(Link, &Assignment, sizeof(Assignment), Peer);
+	const SocketEndpoint Next = SocketEndpoint::Parse(ReceiveText(Link, Assignment.EndpointLength, Peer));
+	if (Assignment.Method > static_cast<std::uint64_t>(TrainingMethod::LogisticDescent)) {
+		throw std::runtime_error(Peer + ": unknown training method " + std::to_string(Assignment.Method));
+	}
+	const TrainingMethod Method = static_cast<TrainingMethod>(Assignment.Method);
+	if (Rank) {
+		*Rank = Assignment.Rank;
+	}
+
+	CoreUtilities::RingAllReduce Ring(Assignment.Rank, Assignment.NumRanks, Listener, Next, TimeoutSeconds);
+	const double TotalExamples = static_cast<double>(Assignment.TotalExamples);
+	StandardiseAcrossShards(Shard, Ring, TotalExamples);
+	const TrainingView View(Shard);
+
+	const auto Report = [&](std::size_t Steps, double Cost) {
+		const ReportMessage Message = {Steps, Cost};
+		SendTo(Link, &Message, sizeof(Message), Peer);
+		std::uint64_t Continue = 0;
+		ReceiveFrom(Link, &Continue, sizeof(Continue), Peer);
+		return Continue != 0;
+	};
+
+	DistributedResult Result;
+	Result.Method = Method;
+	Result.NumExamples = Assignment.TotalExamples;
+	Result.NumWorkers = Assignment.NumRanks;
+	Result.Theta.assign(Shard.GetNumFeatures() + 1, 0.0);
+
+	if (Method == TrainingMethod::NormalEquation) {
+		Result.Theta = SolveNormalEquation(View, Ring, Assignment.TotalExamples, Assignment.Lambda);
+		std::vector<double> Cost(1, 0.0);
+		if (View.GetNumExamples() > 0) {
+			Cost[0] = LinearRegression::ComputeCost(View, Result.Theta, 0.0) * View.GetNumExamples() / TotalExamples;
+		}
+		Ring.AllReduce(Cost);
+		Result.Cost = Cost[0] + Penalty(Result.Theta, Assignment.Lambda, TotalExamples, nullptr);
+		Report(0, Result.Cost);
+	} else {
+		const bool bRegularise = Assignment.Rank == 0;
+		const OptimisationAlgorithms::ShardObjective Objective =
+			[&](const std::vector<double>& Theta, std::vector<double>& Gradient) {
+				return ShardTerm(Method, View, Theta, Assignment.Lambda, TotalExamples, bRegularise, Gradient);
+			};
+		const OptimisationAlgorithms::DescentResult Descent = OptimisationAlgorithms::SolveDistributedDescent(
+			Ring, Objective, Result.Theta, Assignment.LearningRate, Report);
+		Result.Cost = Descent.Cost;
+		Result.Iterations = Descent.Iterations;
+	}
+
+	SendTo(Link, Result.Theta.data(), Result.Theta.size() * sizeof(double), Peer);
+	return Result;
+}
+
+} // namespace DistributedTraining
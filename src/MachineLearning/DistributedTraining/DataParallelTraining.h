@@ -0,0 +1,107 @@
+#ifndef __DataParallelTraining__
+#define __DataParallelTraining__
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "CoreUtilities/RingAllReduce.h"
+#include "MachineLearning/ModelRepresentation/LearningModel.h"
+#include "MachineLearning/ModelRepresentation/TrainingSet.h"
+
+/* DATA-PARALLEL TRAINING */
+// Trains one model on a data set whose rows are split across processes. A
+// job has one coordinator and N workers; each worker owns one shard.
+// - A worker first listens on its own ring endpoint, then joins the
+//   coordinator with that endpoint and its shard's size. The coordinator
+//   numbers workers in joining order and sends each one its rank and its
+//   successor's endpoint. The workers then link up as a
+//   CoreUtilities::RingAllReduce.
+// - The mean and deviation of every feature are summed over the ring, so
+//   all shards are standardised with the whole data set's statistics, as
+//   a single-process run would be.
+// - Normal equation: one all-reduce sums each shard's X^T X and X^T y, and
+//   every rank then solves the same system. Gradient descent (linear or
+//   logistic): each step all-reduces the cost and gradient, via
+//   OptimisationAlgorithms::SolveDistributedDescent.
+// - After each all-reduce, every worker reports the summed cost, and the
+//   coordinator checks that all ranks agree before deciding whether to go
+//   on. It stops at MaxIterations, when the relative change in cost falls
+//   below Tolerance, or when the cost is no longer finite.
+// - Finally every worker sends its theta, and the coordinator checks that
+//   they are identical.
+// Coordinator messages are fixed records of 8-byte fields in native byte
+// order. The whole job therefore runs on one machine or on a cluster that
+// shares one architecture.
+
+namespace DistributedTraining {
+
+enum class TrainingMethod : std::uint64_t {
+	NormalEquation = 0,
+	LinearDescent = 1,
+	LogisticDescent = 2
+};
+
+struct DistributedOptions {
+	TrainingMethod Method = TrainingMethod::NormalEquation;
+	double LearningRate = 0.1;
+	double Lambda = 0.0;
+	std::size_t MaxIterations = 2000;
+	// Relative change in cost below which descent stops; 0 always runs
+	// MaxIterations steps unless the cost stops changing exactly.
+	double Tolerance = 0.0;
+	// Longest the coordinator waits for any worker.
+	double TimeoutSeconds = 300.0;
+};
+
+struct DistributedResult {
+	TrainingMethod Method = TrainingMethod::NormalEquation;
+	std::vector<double> Theta;
+	double Cost = 0.0;
+	std::size_t Iterations = 0;
+	std::size_t NumExamples = 0;
+	std::size_t NumWorkers = 0;
+};
+
+
+class TrainingCoordinator {
+private:
+	CoreUtilities::SocketListener Listener;
+	std::size_t NumWorkers;
+	DistributedOptions Options;
+	std::vector<CoreUtilities::SocketConnection> Workers;
+	ModelRepresentation::LearningModel::IterationObserver Observer;
+
+	// Accept and rank every worker; returns the feature count they share.
+	std::size_t AssignRanks(DistributedResult& Result);
+	bool ShouldContinue(std::size_t Steps, double Cost, double PreviousCost) const;
+
+public:
+	// Listens on Endpoint for InNumWorkers workers. Throws
+	// std::runtime_error if it cannot listen.
+	TrainingCoordinator(const CoreUtilities::SocketEndpoint& Endpoint, std::size_t InNumWorkers,
+	                    DistributedOptions InOptions);
+
+	const CoreUtilities::SocketEndpoint& GetEndpoint() const { return Listener.GetEndpoint(); }
+	// Sees the summed cost of every step, in order.
+	void SetIterationObserver(ModelRepresentation::LearningModel::IterationObserver InObserver);
+
+	// Run one job to completion. Throws std::runtime_error if a worker
+	// fails, times out or disagrees with the others.
+	DistributedResult Run();
+};
+
+
+// Worker side: train on Shard as part of the job run by the coordinator at
+// Coordinator, accepting the ring predecessor on RingEndpoint. Shard is
+// standardised in place with the whole data set's statistics, so it can be
+// saved with the returned theta as a model file. Every worker returns the
+// same result; Rank, if given, receives this worker's rank. TimeoutSeconds
+// bounds each wait for the coordinator or a neighbour.
+DistributedResult TrainShard(ModelRepresentation::TrainingSet& Shard, const CoreUtilities::SocketEndpoint& Coordinator,
+                             const CoreUtilities::SocketEndpoint& RingEndpoint, double TimeoutSeconds = 300.0,
+                             std::size_t* Rank = nullptr);
+
+} // namespace DistributedTraining
+
+#endif // __DataParallelTraining__
@@ -0,0 +1,166 @@
+#include "MachineLearning/LinearRegression/CostFunction.h"
+
+#include <algorithm>
+
+#include "CoreUtilities/ReportGeneration.h"
+#include "CoreUtilities/TaskScheduler.h"
+#include "MachineLearning/LinearRegression/PredictionHypothesis.h"
+#include "MachineLearning/ModelRepresentation/FixedKernels.h"
+
+namespace LinearRegression {
+
+using ModelRepresentation::KernelBlockSize;
+using ModelRepresentation::TrainingView;
+
+namespace {
+
+const std::size_t CostGrainSize = 16 * KernelBlockSize;
+
+
+double RegularisationSum(const std::vector<double>& Theta)
+{
+	double Sum = 0.0;
+	for (std::size_t Index = 1; Index < Theta.size(); Index++) {
+		Sum += Theta[Index] * Theta[Index];
+	}
+	return Sum;
+}
+
+
+std::vector<double> AddPartials(std::vector<double> Left, const std::vector<double>& Right)
+{
+	for (std::size_t Index = 0; Index < Left.size(); Index++) {
+		Left[Index] += Right[Index];
+	}
+	return Left;
+}
+
+} // namespace
+
+
+void AccumulateGradientBlock(const TrainingView& View, std::size_t Begin, std::size_t End,
+                             const double* Residual, double* GradientSums)
+{
+	if (const ModelRepresentation::FixedKernelTable* Fixed = ModelRepresentation::FindFixedKernels(View)) {
+		Fixed->AccumulateGradient(View, Begin, End, Residual, GradientSums);
+		return;
+	}
+
+	const std::size_t Count = End - Begin;
+	const std::size_t* Rows = View.GetRows();
+
+	for (std::size_t Index = 0; Index < Count; Index++) {
+		GradientSums[0] += Residual[Index];
+	}
+
+	for (std::size_t Feature = 0; Feature < View.GetNumFeatures(); Feature++) {
+		if (View.GetSet().GetColumn(Feature).IsSparse()) {
+			continue;
+		}
+		GradientSums[Feature + 1] += View.GetSet().GetColumn(Feature).Visit([&](const auto* Column) {
+			double Sum = 0.0;
+			if (Rows == nullptr) {
+				const auto* Values = Column + Begin;
+				for (std::size_t Index = 0; Index < Count; Index++) {
+					Sum += Residual[Index] * ModelRepresentation::Widen(Values[Index]);
+				}
+			} else {
+				const std::size_t* Positions = Rows + Begin;
+				for (std::size_t Index = 0; Index < Count; Index++) {
+					Sum += Residual[Index] * ModelRepresentation::Widen(Column[Positions[Index]]);
+				}
+			}
+			return Sum;
+		});
+	}
+
+	View.VisitSparse(Begin, End, [&](std::size_t Index, std::uint32_t Feature, double Value) {
+		GradientSums[Feature + 1] += Residual[Index] * Value;
+	});
+}
+
+
+void FinaliseGradient(std::vector<double>& GradientSums, const std::vector<double>& Theta,
+                      double Lambda, std::size_t NumExamples)
+{
+	const double InverseCount = 1.0 / static_cast<double>(NumExamples);
+
+	GradientSums[0] *= InverseCount;
+	for (std::size_t Index = 1; Index < GradientSums.size(); Index++) {
+		GradientSums[Index] = (GradientSums[Index] + Lambda * Theta[Index]) * InverseCount;
+	}
+}
+
+
+CostGradient ComputeCostGradient(const TrainingView& View, const std::vector<double>& Theta, double Lambda)
+{
+	const std::size_t NumExamples = View.GetNumExamples();
+	const std::size_t NumParameters = Theta.size();
+	LEARNSCRAPE_SCOPED_TIMER(CoreUtilities::ReportPhase::CostKernel);
+	LEARNSCRAPE_RECORD_VOLUME(CoreUtilities::ReportPhase::CostKernel, NumExamples,
+	                          NumExamples * View.GetSet().GetBytesPerExample());
+
+	// Partials: [0] squared-residual sum, [1 ..] gradient sums.
+	std::vector<double> Totals = CoreUtilities::TaskScheduler::Get().ParallelReduce(
+		0, NumExamples, CostGrainSize, std::vector<double>(NumParameters + 1, 0.0),
+		[&](std::size_t Begin, std::size_t End) {
+			std::vector<double> Partial(NumParameters + 1, 0.0);
+			double Hypothesis[KernelBlockSize];
+			double Output[KernelBlockSize];
+
+			for (std::size_t Block = Begin; Block < End; Block += KernelBlockSize) {
+				const std::size_t BlockEnd = std::min(End, Block + KernelBlockSize);
+				const std::size_t Count = BlockEnd - Block;
+
+				EvaluateHypothesis(View, Theta, Block, BlockEnd, Hypothesis);
+				View.GatherOutputs(Block, BlockEnd, Output);
+
+				for (std::size_t Index = 0; Index < Count; Index++) {
+					Hypothesis[Index] -= Output[Index];
+					Partial[0] += Hypothesis[Index] * Hypothesis[Index];
+				}
+				AccumulateGradientBlock(View, Block, BlockEnd, Hypothesis, Partial.data() + 1);
+			}
+			return Partial;
+		},
+		AddPartials);
+
+	CostGradient Result;
+	Result.Cost = (Totals[0] + Lambda * RegularisationSum(Theta)) / (2.0 * NumExamples);
+	Result.Gradient.assign(Totals.begin() + 1, Totals.end());
+	FinaliseGradient(Result.Gradient, Theta, Lambda, NumExamples);
+	return Result;
+}
+
+
+double ComputeCost(const TrainingView& View, const std::vector<double>& Theta, double Lambda)
+{
+	const std::size_t NumExamples = View.GetNumExamples();
+	LEARNSCRAPE_SCOPED_TIMER(CoreUtilities::ReportPhase::CostKernel);
+	LEARNSCRAPE_RECORD_VOLUME(CoreUtilities::ReportPhase::CostKernel, NumExamples,
+	                          NumExamples * View.GetSet().GetBytesPerExample());
+
+	const double SquaredResiduals = CoreUtilities::TaskScheduler::Get().ParallelReduce(
+		0, NumExamples, CostGrainSize, 0.0,
+		[&](std::size_t Begin, std::size_t End) {
+			double Sum = 0.0;
+			double Hypothesis[KernelBlockSize];
+			double Output[KernelBlockSize];
+
+			for (std::size_t Block = Begin; Block < End; Block += KernelBlockSize) {
+				const std::size_t BlockEnd = std::min(End, Block + KernelBlockSize);
+				EvaluateHypothesis(View, Theta, Block, BlockEnd, Hypothesis);
+				View.GatherOutputs(Block, BlockEnd, Output);
+				for (std::size_t Index = 0; Index < BlockEnd - Block; Index++) {
+					const double Residual = Hypothesis[Index] - Output[Index];
+					Sum += Residual * Residual;
+				}
+			}
+			return Sum;
+		},
+		[](double Left, double Right) { return Left + Right; });
+
+	return (SquaredResiduals + Lambda * RegularisationSum(Theta)) / (2.0 * NumExamples);
+}
+
+} // namespace LinearRegression
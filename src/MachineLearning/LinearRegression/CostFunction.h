@@ -0,0 +1,38 @@
+#ifndef __LinearCostFunction__
+#define __LinearCostFunction__
+
+#include <cstddef>
+#include <vector>
+
+#include "MachineLearning/ModelRepresentation/TrainingSet.h"
+
+/* LINEAR REGRESSION COST FUNCTION */
+// J(theta) = 1/(2m) sum_i (h(x_i) - y_i)^2 + lambda/(2m) sum_{j>=1} theta_j^2
+// The intercept theta_0 is not regularised.
+
+namespace LinearRegression {
+
+struct CostGradient {
+	double Cost;
+	std::vector<double> Gradient;
+};
+
+CostGradient ComputeCostGradient(const ModelRepresentation::TrainingView& View,
+                                 const std::vector<double>& Theta, double Lambda);
+
+double ComputeCost(const ModelRepresentation::TrainingView& View,
+                   const std::vector<double>& Theta, double Lambda);
+
+// Add sum_i Residual[i] * x_ij over view positions [Begin, End) to
+// GradientSums[j + 1] for every feature j, and sum_i Residual[i] to
+// GradientSums[0]. Shared by every model whose gradient has this form.
+void AccumulateGradientBlock(const ModelRepresentation::TrainingView& View, std::size_t Begin, std::size_t End,
+                             const double* Residual, double* GradientSums);
+
+// Scale accumulated sums by 1/m and add the regularisation terms.
+void FinaliseGradient(std::vector<double>& GradientSums, const std::vector<double>& Theta,
+                      double Lambda, std::size_t NumExamples);
+
+} // namespace LinearRegression
+
+#endif // __LinearCostFunction__
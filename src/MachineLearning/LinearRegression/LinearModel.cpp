@@ -0,0 +1,62 @@
+#include "MachineLearning/LinearRegression/LinearModel.h"
+
+#include <cmath>
+#include <limits>
+#include <sstream>
+
+#include "CoreUtilities/ReportGeneration.h"
+#include "MachineLearning/LinearRegression/CostFunction.h"
+
+namespace LinearRegression {
+
+LinearModel::LinearModel(double InLearningRate, double InLambda)
+	: LearningRate(InLearningRate), Lambda(InLambda), IterationsTrained(0), Tolerance(0.0)
+{
+}
+
+
+void LinearModel::Train(const ModelRepresentation::TrainingView& View, std::size_t Iterations)
+{
+	LEARNSCRAPE_SCOPED_TIMER(CoreUtilities::ReportPhase::Solver);
+	if (Theta.size() != View.GetNumFeatures() + 1) {
+		Theta.assign(View.GetNumFeatures() + 1, 0.0);
+	}
+
+	double PreviousCost = 0.0;
+	for (std::size_t Iteration = 0; Iteration < Iterations; Iteration++) {
+		const CostGradient Step = ComputeCostGradient(View, Theta, Lambda);
+		if (!std::isfinite(Step.Cost) ||
+		    (Tolerance > 0.0 && Iteration > 0 && std::fabs(PreviousCost - Step.Cost) <= Tolerance * std::fabs(PreviousCost))) {
+			break;
+		}
+		PreviousCost = Step.Cost;
+		for (std::size_t Index = 0; Index < Theta.size(); Index++) {
+			Theta[Index] -= LearningRate * Step.Gradient[Index];
+		}
+		IterationsTrained++;
+		if (Observer) {
+			Observer(IterationsTrained, Step.Cost);
+		}
+		LEARNSCRAPE_COUNT(CoreUtilities::ReportCounter::OptimiserIterations, 1);
+	}
+}
+
+
+double LinearModel::ValidationLoss(const ModelRepresentation::TrainingView& View) const
+{
+	if (Theta.empty()) {
+		return std::numeric_limits<double>::infinity();
+	}
+	// ComputeCost halves the mean squared residual.
+	return 2.0 * ComputeCost(View, Theta, 0.0);
+}
+
+
+std::string LinearModel::Describe() const
+{
+	std::ostringstream Description;
+	Description << "linear(alpha=" << LearningRate << ", lambda=" << Lambda << ")";
+	return Description.str();
+}
+
+} // namespace LinearRegression
@@ -0,0 +1,44 @@
+#ifndef __LinearModel__
+#define __LinearModel__
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "MachineLearning/ModelRepresentation/LearningModel.h"
+
+/* LINEAR MODEL */
+// Linear regression fitted by batch gradient descent on the regularised
+// cost: theta := theta - alpha * grad J(theta).
+
+namespace LinearRegression {
+
+class LinearModel : public ModelRepresentation::LearningModel {
+private:
+	double LearningRate;
+	double Lambda;
+	std::vector<double> Theta;
+	std::size_t IterationsTrained;
+	IterationObserver Observer;
+	double Tolerance;
+
+public:
+	LinearModel(double InLearningRate, double InLambda);
+
+	void Train(const ModelRepresentation::TrainingView& View, std::size_t Iterations) override;
+	double ValidationLoss(const ModelRepresentation::TrainingView& View) const override;
+	std::size_t GetIterationsTrained() const override { return IterationsTrained; }
+	std::string Describe() const override;
+	std::vector<double> GetParameters() const override { return Theta; }
+	void WarmStart(const std::vector<double>& Parameters) override { Theta = Parameters; }
+	void SetIterationObserver(IterationObserver InObserver) override { Observer = std::move(InObserver); }
+	void SetTolerance(double InTolerance) override { Tolerance = InTolerance; }
+
+	const std::vector<double>& GetTheta() const { return Theta; }
+	void SetTheta(std::vector<double> InTheta) { Theta = std::move(InTheta); }
+};
+
+} // namespace LinearRegression
+
+#endif // __LinearModel__
@@ -0,0 +1,194 @@
+#include "MachineLearning/LinearRegression/NormalEquation.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+#include "CoreUtilities/ReportGeneration.h"
+#include "CoreUtilities/TaskScheduler.h"
+
+namespace LinearRegression {
+
+using ModelRepresentation::KernelBlockSize;
+using ModelRepresentation::TrainingView;
+
+
+NormalEquationSystem::NormalEquationSystem(std::size_t InNumParameters)
+	: NumParameters(InNumParameters),
+	  NumExamples(0),
+	  Gram(InNumParameters * InNumParameters, 0.0),
+	  Moment(InNumParameters, 0.0)
+{
+}
+
+
+NormalEquationSystem::NormalEquationSystem(std::size_t InNumExamples, std::vector<double> InGram,
+                                           std::vector<double> InMoment)
+	: NumParameters(InMoment.size()),
+	  NumExamples(InNumExamples),
+	  Gram(std::move(InGram)),
+	  Moment(std::move(InMoment))
+{
+	if (Gram.size() != NumParameters * NumParameters) {
+		throw std::invalid_argument("NormalEquationSystem: Gram matrix does not match the moment vector");
+	}
+}
+
+
+NormalEquationSystem NormalEquationSystem::Accumulate(const TrainingView& View)
+{
+	const std::size_t NumFeatures = View.GetNumFeatures();
+	const std::size_t Parameters = NumFeatures + 1;
+	LEARNSCRAPE_SCOPED_TIMER(CoreUtilities::ReportPhase::NormalEquation);
+	LEARNSCRAPE_RECORD_VOLUME(CoreUtilities::ReportPhase::NormalEquation, View.GetNumExamples(),
+	                          View.GetNumExamples() * View.GetSet().GetBytesPerExample());
+
+	NormalEquationSystem Total = CoreUtilities::TaskScheduler::Get().ParallelReduce(
+		0, View.GetNumExamples(), 16 * KernelBlockSize, NormalEquationSystem(Parameters),
+		[&](std::size_t Begin, std::size_t End) {
+			NormalEquationSystem Partial(Parameters);
+			// Block of the design matrix, one row per parameter (row 0 = ones).
+			std::vector<double> Design(Parameters * KernelBlockSize, 1.0);
+			double Output[KernelBlockSize];
+
+			for (std::size_t Block = Begin; Block < End; Block += KernelBlockSize) {
+				const std::size_t BlockEnd = std::min(End, Block + KernelBlockSize);
+				const std::size_t Count = BlockEnd - Block;
+
+				for (std::size_t Feature = 0; Feature < NumFeatures; Feature++) {
+					double* Target = &Design[(Feature + 1) * KernelBlockSize];
+					if (View.GetSet().GetColumn(Feature).IsSparse()) {
+						std::fill(Target, Target + Count, 0.0);
+					} else {
+						View.GatherColumn(Feature, Block, BlockEnd, Target);
+					}
+				}
+				View.VisitSparse(Block, BlockEnd, [&](std::size_t Index, std::uint32_t Feature, double Value) {
+					Design[(Feature + 1) * KernelBlockSize + Index] = Value;
+				});
+				View.GatherOutputs(Block, BlockEnd, Output);
+
+				// Upper triangle only; mirrored once at the end.
+				for (std::size_t Row = 0; Row < Parameters; Row++) {
+					const double* Left = &Design[Row * KernelBlockSize];
+					for (std::size_t Column = Row; Column < Parameters; Column++) {
+						const double* Right = &Design[Column * KernelBlockSize];
+						double Sum = 0.0;
+						for (std::size_t Index = 0; Index < Count; Index++) {
+							Sum += Left[Index] * Right[Index];
+						}
+						Partial.Gram[Row * Parameters + Column] += Sum;
+					}
+
+					double Sum = 0.0;
+					for (std::size_t Index = 0; Index < Count; Index++) {
+						Sum += Left[Index] * Output[Index];
+					}
+					Partial.Moment[Row] += Sum;
+				}
+				Partial.NumExamples += Count;
+			}
+			return Partial;
+		},
+		[](NormalEquationSystem Left, const NormalEquationSystem& Right) {
+			Left += Right;
+			return Left;
+		});
+
+	for (std::size_t Row = 0; Row < Parameters; Row++) {
+		for (std::size_t Column = 0; Column < Row; Column++) {
+			Total.Gram[Row * Parameters + Column] = Total.Gram[Column * Parameters + Row];
+		}
+	}
+	return Total;
+}
+
+
+void NormalEquationSystem::Update(const TrainingView& Delta)
+{
+	if (NumParameters == 0) {
+		*this = Accumulate(Delta);
+		return;
+	}
+	if (Delta.GetNumFeatures() + 1 != NumParameters) {
+		throw std::invalid_argument("NormalEquationSystem: update rows have a different number of features");
+	}
+	*this += Accumulate(Delta);
+}
+
+
+NormalEquationSystem& NormalEquationSystem::operator+=(const NormalEquationSystem& Other)
+{
+	for (std::size_t Index = 0; Index < Gram.size(); Index++) {
+		Gram[Index] += Other.Gram[Index];
+	}
+	for (std::size_t Index = 0; Index < Moment.size(); Index++) {
+		Moment[Index] += Other.Moment[Index];
+	}
+	NumExamples += Other.NumExamples;
+	return *this;
+}
+
+
+NormalEquationSystem& NormalEquationSystem::operator-=(const NormalEquationSystem& Other)
+{
+	for (std::size_t Index = 0; Index < Gram.size(); Index++) {
+		Gram[Index] -= Other.Gram[Index];
+	}
+	for (std::size_t Index = 0; Index < Moment.size(); Index++) {
+		Moment[Index] -= Other.Moment[Index];
+	}
+	NumExamples -= Other.NumExamples;
+	return *this;
+}
+
+
+std::vector<double> NormalEquationSystem::Solve(double Lambda) const
+{
+	const std::size_t N = NumParameters;
+
+	// Cholesky factor A = L L^T, stored in the lower triangle of Factor.
+	std::vector<double> Factor(Gram);
+	for (std::size_t Index = 1; Index < N; Index++) {
+		Factor[Index * N + Index] += Lambda;
+	}
+
+	for (std::size_t Column = 0; Column < N; Column++) {
+		double Diagonal = Factor[Column * N + Column];
+		for (std::size_t K = 0; K < Column; K++) {
+			Diagonal -= Factor[Column * N + K] * Factor[Column * N + K];
+		}
+		if (!(Diagonal > 0.0)) {
+			throw std::runtime_error("NormalEquation: Gram matrix is not positive definite; increase lambda");
+		}
+		Diagonal = std::sqrt(Diagonal);
+		Factor[Column * N + Column] = Diagonal;
+
+		for (std::size_t Row = Column + 1; Row < N; Row++) {
+			double Value = Factor[Row * N + Column];
+			for (std::size_t K = 0; K < Column; K++) {
+				Value -= Factor[Row * N + K] * Factor[Column * N + K];
+			}
+			Factor[Row * N + Column] = Value / Diagonal;
+		}
+	}
+
+	// Forwards substitution L z = X^T y, then backwards substitution L^T theta = z.
+	std::vector<double> Theta(Moment);
+	for (std::size_t Row = 0; Row < N; Row++) {
+		for (std::size_t K = 0; K < Row; K++) {
+			Theta[Row] -= Factor[Row * N + K] * Theta[K];
+		}
+		Theta[Row] /= Factor[Row * N + Row];
+	}
+	for (std::size_t Row = N; Row-- > 0;) {
+		for (std::size_t K = Row + 1; K < N; K++) {
+			Theta[Row] -= Factor[K * N + Row] * Theta[K];
+		}
+		Theta[Row] /= Factor[Row * N + Row];
+	}
+	return Theta;
+}
+
+} // namespace LinearRegression
@@ -0,0 +1,58 @@
+#ifndef __NormalEquation__
+#define __NormalEquation__
+
+#include <cstddef>
+#include <vector>
+
+#include "MachineLearning/ModelRepresentation/TrainingSet.h"
+
+/* NORMAL EQUATION */
+// theta = (X^T X + lambda L)^-1 X^T y, where X carries a leading column of
+// ones and L is the identity with L_00 = 0 so the intercept is not
+// regularised. The sums X^T X and X^T y are additive over rows, so systems
+// accumulated over disjoint row sets can be added and subtracted; this is
+// what lets cross-validation derive each fold's system from the total, and
+// what lets a growing data set be folded in as it arrives.
+
+namespace LinearRegression {
+
+class NormalEquationSystem {
+private:
+	std::size_t NumParameters;
+	std::size_t NumExamples;
+	std::vector<double> Gram;
+	std::vector<double> Moment;
+
+public:
+	explicit NormalEquationSystem(std::size_t InNumParameters = 0);
+	// From sums accumulated elsewhere, e.g. added up across processes. The
+	// size comes from InMoment; throws std::invalid_argument if InGram is not
+	// its square.
+	NormalEquationSystem(std::size_t InNumExamples, std::vector<double> InGram, std::vector<double> InMoment);
+
+	// Sum the contributions of every position of View, in parallel.
+	static NormalEquationSystem Accumulate(const ModelRepresentation::TrainingView& View);
+
+	std::size_t GetNumParameters() const { return NumParameters; }
+	std::size_t GetNumExamples() const { return NumExamples; }
+
+	// Row-major (NumParameters x NumParameters) X^T X and the vector X^T y.
+	const std::vector<double>& GetGram() const { return Gram; }
+	const std::vector<double>& GetMoment() const { return Moment; }
+
+	// Rank-k update with the k positions of Delta, typically rows appended
+	// since the last update; earlier rows are never revisited. An empty
+	// (default-constructed) system takes its size from Delta.
+	void Update(const ModelRepresentation::TrainingView& Delta);
+
+	NormalEquationSystem& operator+=(const NormalEquationSystem& Other);
+	NormalEquationSystem& operator-=(const NormalEquationSystem& Other);
+
+	// Solve by Cholesky factorisation. Throws std::runtime_error if the
+	// regularised Gram matrix is not positive definite.
+	std::vector<double> Solve(double Lambda) const;
+};
+
+} // namespace LinearRegression
+
+#endif // __NormalEquation__
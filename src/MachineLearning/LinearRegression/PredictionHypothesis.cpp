@@ -0,0 +1,77 @@
+#include "MachineLearning/LinearRegression/PredictionHypothesis.h"
+
+#include <algorithm>
+
+#include "CoreUtilities/TaskScheduler.h"
+#include "MachineLearning/ModelRepresentation/FixedKernels.h"
+
+namespace LinearRegression {
+
+using ModelRepresentation::KernelBlockSize;
+using ModelRepresentation::TrainingView;
+
+
+void EvaluateHypothesis(const TrainingView& View, const std::vector<double>& Theta,
+                        std::size_t Begin, std::size_t End, double* Out)
+{
+	if (const ModelRepresentation::FixedKernelTable* Fixed = ModelRepresentation::FindFixedKernels(View)) {
+		Fixed->EvaluateHypothesis(View, Theta.data(), Begin, End, Out);
+		return;
+	}
+
+	const std::size_t Count = End - Begin;
+	std::fill(Out, Out + Count, Theta[0]);
+
+	const std::size_t* Rows = View.GetRows();
+	for (std::size_t Feature = 0; Feature < View.GetNumFeatures(); Feature++) {
+		if (View.GetSet().GetColumn(Feature).IsSparse()) {
+			continue;
+		}
+		const double Weight = Theta[Feature + 1];
+
+		View.GetSet().GetColumn(Feature).Visit([&](const auto* Column) {
+			if (Rows == nullptr) {
+				const auto* Values = Column + Begin;
+				for (std::size_t Index = 0; Index < Count; Index++) {
+					Out[Index] += Weight * ModelRepresentation::Widen(Values[Index]);
+				}
+			} else {
+				const std::size_t* Positions = Rows + Begin;
+				for (std::size_t Index = 0; Index < Count; Index++) {
+					Out[Index] += Weight * ModelRepresentation::Widen(Column[Positions[Index]]);
+				}
+			}
+		});
+	}
+
+	View.VisitSparse(Begin, End, [&](std::size_t Index, std::uint32_t Feature, double Value) {
+		Out[Index] += Theta[Feature + 1] * Value;
+	});
+}
+
+
+double EvaluateHypothesis(const double* Inputs, std::size_t NumFeatures, const std::vector<double>& Theta)
+{
+	double Hypothesis = Theta[0];
+	for (std::size_t Feature = 0; Feature < NumFeatures; Feature++) {
+		Hypothesis += Theta[Feature + 1] * Inputs[Feature];
+	}
+	return Hypothesis;
+}
+
+
+std::vector<double> PredictHypothesis(const TrainingView& View, const std::vector<double>& Theta)
+{
+	std::vector<double> Predictions(View.GetNumExamples());
+
+	CoreUtilities::TaskScheduler::Get().ParallelFor(0, View.GetNumExamples(), 16 * KernelBlockSize,
+		[&](std::size_t Begin, std::size_t End) {
+			for (std::size_t Block = Begin; Block < End; Block += KernelBlockSize) {
+				const std::size_t BlockEnd = std::min(End, Block + KernelBlockSize);
+				EvaluateHypothesis(View, Theta, Block, BlockEnd, Predictions.data() + Block);
+			}
+		});
+	return Predictions;
+}
+
+} // namespace LinearRegression
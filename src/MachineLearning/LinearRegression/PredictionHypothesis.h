@@ -0,0 +1,30 @@
+#ifndef __LinearPredictionHypothesis__
+#define __LinearPredictionHypothesis__
+
+#include <cstddef>
+#include <vector>
+
+#include "MachineLearning/ModelRepresentation/TrainingSet.h"
+
+/* LINEAR PREDICTION HYPOTHESIS */
+// h(x) = theta_0 + theta_1 x_1 + ... + theta_n x_n
+// Theta[0] is the intercept and Theta[j + 1] weights feature j. This linear
+// term is shared with the logistic hypothesis.
+
+namespace LinearRegression {
+
+// Hypotheses for view positions [Begin, End) written to Out[0 .. End-Begin).
+// Accumulates one feature column at a time so each pass is a unit-stride
+// stream over the column.
+void EvaluateHypothesis(const ModelRepresentation::TrainingView& View, const std::vector<double>& Theta,
+                        std::size_t Begin, std::size_t End, double* Out);
+
+// Hypothesis for a single example given as NumFeatures scaled inputs.
+double EvaluateHypothesis(const double* Inputs, std::size_t NumFeatures, const std::vector<double>& Theta);
+
+// Hypotheses for every position of the view, computed in parallel.
+std::vector<double> PredictHypothesis(const ModelRepresentation::TrainingView& View, const std::vector<double>& Theta);
+
+} // namespace LinearRegression
+
+#endif // __LinearPredictionHypothesis__
@@ -0,0 +1,73 @@
+#include "MachineLearning/LogisticRegression/CostFunction.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "CoreUtilities/ReportGeneration.h"
+#include "CoreUtilities/TaskScheduler.h"
+#include "MachineLearning/LogisticRegression/PredictionHypothesis.h"
+
+namespace LogisticRegression {
+
+using ModelRepresentation::KernelBlockSize;
+using ModelRepresentation::TrainingView;
+
+namespace {
+
+// Keeps log(h) and log(1 - h) finite for saturated hypotheses.
+const double ProbabilityFloor = 1.0e-15;
+
+} // namespace
+
+
+CostGradient ComputeCostGradient(const TrainingView& View, const std::vector<double>& Theta, double Lambda)
+{
+	const std::size_t NumExamples = View.GetNumExamples();
+	const std::size_t NumParameters = Theta.size();
+	LEARNSCRAPE_SCOPED_TIMER(CoreUtilities::ReportPhase::CostKernel);
+	LEARNSCRAPE_RECORD_VOLUME(CoreUtilities::ReportPhase::CostKernel, NumExamples,
+	                          NumExamples * View.GetSet().GetBytesPerExample());
+
+	// Partials: [0] log-likelihood sum, [1 ..] gradient sums.
+	std::vector<double> Totals = CoreUtilities::TaskScheduler::Get().ParallelReduce(
+		0, NumExamples, 16 * KernelBlockSize, std::vector<double>(NumParameters + 1, 0.0),
+		[&](std::size_t Begin, std::size_t End) {
+			std::vector<double> Partial(NumParameters + 1, 0.0);
+			double Hypothesis[KernelBlockSize];
+			double Output[KernelBlockSize];
+
+			for (std::size_t Block = Begin; Block < End; Block += KernelBlockSize) {
+				const std::size_t BlockEnd = std::min(End, Block + KernelBlockSize);
+
+				EvaluateHypothesis(View, Theta, Block, BlockEnd, Hypothesis);
+				View.GatherOutputs(Block, BlockEnd, Output);
+
+				for (std::size_t Index = 0; Index < BlockEnd - Block; Index++) {
+					const double Probability = std::min(std::max(Hypothesis[Index], ProbabilityFloor), 1.0 - ProbabilityFloor);
+					Partial[0] -= Output[Index] * std::log(Probability) + (1.0 - Output[Index]) * std::log(1.0 - Probability);
+					Hypothesis[Index] -= Output[Index];
+				}
+				LinearRegression::AccumulateGradientBlock(View, Block, BlockEnd, Hypothesis, Partial.data() + 1);
+			}
+			return Partial;
+		},
+		[](std::vector<double> Left, const std::vector<double>& Right) {
+			for (std::size_t Index = 0; Index < Left.size(); Index++) {
+				Left[Index] += Right[Index];
+			}
+			return Left;
+		});
+
+	double Regularisation = 0.0;
+	for (std::size_t Index = 1; Index < NumParameters; Index++) {
+		Regularisation += Theta[Index] * Theta[Index];
+	}
+
+	CostGradient Result;
+	Result.Cost = Totals[0] / NumExamples + Lambda * Regularisation / (2.0 * NumExamples);
+	Result.Gradient.assign(Totals.begin() + 1, Totals.end());
+	LinearRegression::FinaliseGradient(Result.Gradient, Theta, Lambda, NumExamples);
+	return Result;
+}
+
+} // namespace LogisticRegression
@@ -0,0 +1,24 @@
+#ifndef __LogisticCostFunction__
+#define __LogisticCostFunction__
+
+#include <vector>
+
+#include "MachineLearning/LinearRegression/CostFunction.h"
+#include "MachineLearning/ModelRepresentation/TrainingSet.h"
+
+/* LOGISTIC REGRESSION COST FUNCTION */
+// J(theta) = -1/m sum_i [y_i log h(x_i) + (1 - y_i) log(1 - h(x_i))]
+//            + lambda/(2m) sum_{j>=1} theta_j^2
+// The gradient has the same form as linear regression with the logistic
+// hypothesis, so the accumulation is shared.
+
+namespace LogisticRegression {
+
+using LinearRegression::CostGradient;
+
+CostGradient ComputeCostGradient(const ModelRepresentation::TrainingView& View,
+                                 const std::vector<double>& Theta, double Lambda);
+
+} // namespace LogisticRegression
+
+#endif // __LogisticCostFunction__
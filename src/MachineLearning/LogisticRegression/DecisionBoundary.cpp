@@ -0,0 +1,43 @@
+#include "MachineLearning/LogisticRegression/DecisionBoundary.h"
+
+#include <algorithm>
+
+#include "CoreUtilities/TaskScheduler.h"
+#include "MachineLearning/LogisticRegression/PredictionHypothesis.h"
+
+namespace LogisticRegression {
+
+using ModelRepresentation::KernelBlockSize;
+
+
+double MisclassificationRate(const ModelRepresentation::TrainingView& View, const std::vector<double>& Theta,
+                             double Threshold)
+{
+	const std::size_t NumExamples = View.GetNumExamples();
+	if (NumExamples == 0) {
+		return 0.0;
+	}
+
+	const std::size_t Errors = CoreUtilities::TaskScheduler::Get().ParallelReduce(
+		0, NumExamples, 16 * KernelBlockSize, std::size_t(0),
+		[&](std::size_t Begin, std::size_t End) {
+			std::size_t Count = 0;
+			double Probability[KernelBlockSize];
+			double Output[KernelBlockSize];
+
+			for (std::size_t Block = Begin; Block < End; Block += KernelBlockSize) {
+				const std::size_t BlockEnd = std::min(End, Block + KernelBlockSize);
+				EvaluateHypothesis(View, Theta, Block, BlockEnd, Probability);
+				View.GatherOutputs(Block, BlockEnd, Output);
+				for (std::size_t Index = 0; Index < BlockEnd - Block; Index++) {
+					Count += (Classify(Probability[Index], Threshold) != (Output[Index] > 0.5)) ? 1 : 0;
+				}
+			}
+			return Count;
+		},
+		[](std::size_t Left, std::size_t Right) { return Left + Right; });
+
+	return static_cast<double>(Errors) / static_cast<double>(NumExamples);
+}
+
+} // namespace LogisticRegression
@@ -0,0 +1,26 @@
+#ifndef __DecisionBoundary__
+#define __DecisionBoundary__
+
+#include <vector>
+
+#include "MachineLearning/ModelRepresentation/TrainingSet.h"
+
+/* DECISION BOUNDARY */
+// Predict y = 1 when h(x) >= Threshold; Threshold = 0.5 corresponds to the
+// boundary theta^T x = 0.
+
+namespace LogisticRegression {
+
+inline bool Classify(double Probability, double Threshold = 0.5)
+{
+	return Probability >= Threshold;
+}
+
+// Fraction of view positions whose predicted class differs from the output,
+// outputs being read as y = 1 when greater than 0.5.
+double MisclassificationRate(const ModelRepresentation::TrainingView& View, const std::vector<double>& Theta,
+                             double Threshold = 0.5);
+
+} // namespace LogisticRegression
+
+#endif // __DecisionBoundary__
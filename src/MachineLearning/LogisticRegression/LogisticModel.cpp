@@ -0,0 +1,82 @@
+#include "MachineLearning/LogisticRegression/LogisticModel.h"
+
+#include <cmath>
+#include <limits>
+#include <sstream>
+
+#include "CoreUtilities/ReportGeneration.h"
+#include "MachineLearning/LogisticRegression/CostFunction.h"
+#include "MachineLearning/LogisticRegression/DecisionBoundary.h"
+
+namespace LogisticRegression {
+
+LogisticModel::LogisticModel(double InLearningRate, double InLambda, double InThreshold)
+	: LearningRate(InLearningRate), Lambda(InLambda), Threshold(InThreshold), IterationsTrained(0),
+	  Tolerance(0.0)
+{
+}
+
+
+void LogisticModel::Train(const ModelRepresentation::TrainingView& View, std::size_t Iterations)
+{
+	Descend(View, Iterations, LearningRate);
+}
+
+
+void LogisticModel::Descend(const ModelRepresentation::TrainingView& View, std::size_t Iterations, double Rate)
+{
+	LEARNSCRAPE_SCOPED_TIMER(CoreUtilities::ReportPhase::Solver);
+	if (Theta.size() != View.GetNumFeatures() + 1) {
+		Theta.assign(View.GetNumFeatures() + 1, 0.0);
+	}
+
+	double PreviousCost = 0.0;
+	for (std::size_t Iteration = 0; Iteration < Iterations; Iteration++) {
+		const CostGradient Step = ComputeCostGradient(View, Theta, Lambda);
+		if (!std::isfinite(Step.Cost) ||
+		    (Tolerance > 0.0 && Iteration > 0 && std::fabs(PreviousCost - Step.Cost) <= Tolerance * std::fabs(PreviousCost))) {
+			break;
+		}
+		PreviousCost = Step.Cost;
+		for (std::size_t Index = 0; Index < Theta.size(); Index++) {
+			Theta[Index] -= Rate * Step.Gradient[Index];
+		}
+		IterationsTrained++;
+		if (Observer) {
+			Observer(IterationsTrained, Step.Cost);
+		}
+		LEARNSCRAPE_COUNT(CoreUtilities::ReportCounter::OptimiserIterations, 1);
+	}
+}
+
+
+void LogisticModel::TrainIncremental(const ModelRepresentation::TrainingView& Delta, std::size_t NumPrevious,
+                                     std::size_t Iterations)
+{
+	if (Delta.GetNumExamples() == 0) {
+		return;
+	}
+	const double Share = static_cast<double>(Delta.GetNumExamples())
+		/ static_cast<double>(NumPrevious + Delta.GetNumExamples());
+
+	Descend(Delta, Iterations, LearningRate * Share);
+}
+
+
+double LogisticModel::ValidationLoss(const ModelRepresentation::TrainingView& View) const
+{
+	if (Theta.empty()) {
+		return std::numeric_limits<double>::infinity();
+	}
+	return MisclassificationRate(View, Theta, Threshold);
+}
+
+
+std::string LogisticModel::Describe() const
+{
+	std::ostringstream Description;
+	Description << "logistic(alpha=" << LearningRate << ", lambda=" << Lambda << ")";
+	return Description.str();
+}
+
+} // namespace LogisticRegression
@@ -0,0 +1,54 @@
+#ifndef __LogisticModel__
+#define __LogisticModel__
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "MachineLearning/ModelRepresentation/LearningModel.h"
+
+/* LOGISTIC MODEL */
+// Binary logistic regression fitted by batch gradient descent on the
+// regularised cross-entropy cost.
+
+namespace LogisticRegression {
+
+class LogisticModel : public ModelRepresentation::LearningModel {
+private:
+	double LearningRate;
+	double Lambda;
+	double Threshold;
+	std::vector<double> Theta;
+	std::size_t IterationsTrained;
+	IterationObserver Observer;
+	double Tolerance;
+
+	void Descend(const ModelRepresentation::TrainingView& View, std::size_t Iterations, double Rate);
+
+public:
+	LogisticModel(double InLearningRate, double InLambda, double InThreshold = 0.5);
+
+	void Train(const ModelRepresentation::TrainingView& View, std::size_t Iterations) override;
+	// Warm-started steps on Delta, rows that arrived after the model had
+	// been trained on NumPrevious others. Near the previous optimum the
+	// gradient of the cost over all rows is approximately the Delta gradient
+	// weighted by its share of the rows, so each step is scaled by that
+	// share; the result tracks a full retrain without revisiting old rows.
+	void TrainIncremental(const ModelRepresentation::TrainingView& Delta, std::size_t NumPrevious,
+	                      std::size_t Iterations);
+	double ValidationLoss(const ModelRepresentation::TrainingView& View) const override;
+	std::size_t GetIterationsTrained() const override { return IterationsTrained; }
+	std::string Describe() const override;
+	std::vector<double> GetParameters() const override { return Theta; }
+	void WarmStart(const std::vector<double>& Parameters) override { Theta = Parameters; }
+	void SetIterationObserver(IterationObserver InObserver) override { Observer = std::move(InObserver); }
+	void SetTolerance(double InTolerance) override { Tolerance = InTolerance; }
+
+	const std::vector<double>& GetTheta() const { return Theta; }
+	void SetTheta(std::vector<double> InTheta) { Theta = std::move(InTheta); }
+};
+
+} // namespace LogisticRegression
+
+#endif // __LogisticModel__
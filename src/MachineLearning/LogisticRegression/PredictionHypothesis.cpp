@@ -0,0 +1,21 @@
+#include "MachineLearning/LogisticRegression/PredictionHypothesis.h"
+
+#include "MachineLearning/LinearRegression/PredictionHypothesis.h"
+#include "MachineLearning/LogisticRegression/SigmoidFunction.h"
+
+namespace LogisticRegression {
+
+void EvaluateHypothesis(const ModelRepresentation::TrainingView& View, const std::vector<double>& Theta,
+                        std::size_t Begin, std::size_t End, double* Out)
+{
+	LinearRegression::EvaluateHypothesis(View, Theta, Begin, End, Out);
+	Sigmoid(Out, End - Begin);
+}
+
+
+double EvaluateHypothesis(const double* Inputs, std::size_t NumFeatures, const std::vector<double>& Theta)
+{
+	return Sigmoid(LinearRegression::EvaluateHypothesis(Inputs, NumFeatures, Theta));
+}
+
+} // namespace LogisticRegression
@@ -0,0 +1,21 @@
+#ifndef __LogisticPredictionHypothesis__
+#define __LogisticPredictionHypothesis__
+
+#include <cstddef>
+#include <vector>
+
+#include "MachineLearning/ModelRepresentation/TrainingSet.h"
+
+/* LOGISTIC PREDICTION HYPOTHESIS */
+// h(x) = g(theta^T x), the estimated probability that y = 1.
+
+namespace LogisticRegression {
+
+void EvaluateHypothesis(const ModelRepresentation::TrainingView& View, const std::vector<double>& Theta,
+                        std::size_t Begin, std::size_t End, double* Out);
+
+double EvaluateHypothesis(const double* Inputs, std::size_t NumFeatures, const std::vector<double>& Theta);
+
+} // namespace LogisticRegression
+
+#endif // __LogisticPredictionHypothesis__
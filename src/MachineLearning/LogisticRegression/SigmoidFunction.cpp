@@ -0,0 +1,20 @@
+#include "MachineLearning/LogisticRegression/SigmoidFunction.h"
+
+#include <cmath>
+
+namespace LogisticRegression {
+
+double Sigmoid(double Z)
+{
+	return 1.0 / (1.0 + std::exp(-Z));
+}
+
+
+void Sigmoid(double* Values, std::size_t Count)
+{
+	for (std::size_t Index = 0; Index < Count; Index++) {
+		Values[Index] = 1.0 / (1.0 + std::exp(-Values[Index]));
+	}
+}
+
+} // namespace LogisticRegression
@@ -0,0 +1,18 @@
+#ifndef __SigmoidFunction__
+#define __SigmoidFunction__
+
+#include <cstddef>
+
+/* SIGMOID FUNCTION */
+// g(z) = 1 / (1 + e^-z)
+
+namespace LogisticRegression {
+
+double Sigmoid(double Z);
+
+// In-place sigmoid over Count values.
+void Sigmoid(double* Values, std::size_t Count);
+
+} // namespace LogisticRegression
+
+#endif // __SigmoidFunction__
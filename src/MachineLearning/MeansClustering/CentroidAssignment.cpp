@@ -0,0 +1,243 @@
+#include "MachineLearning/MeansClustering/CentroidAssignment.h"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+
+#include "CoreUtilities/ReportGeneration.h"
+#include "CoreUtilities/TaskScheduler.h"
+#include "MachineLearning/ModelRepresentation/FixedKernels.h"
+
+namespace MeansClustering {
+
+using ModelRepresentation::KernelBlockSize;
+using ModelRepresentation::TrainingView;
+using ModelRepresentation::Widen;
+
+namespace {
+
+const std::size_t ClusteringGrainSize = 16 * KernelBlockSize;
+
+
+// Per-cluster feature sums (NumClusters x NumFeatures) followed by the
+// NumClusters row counts.
+std::vector<double> SumAssignments(const TrainingView& View, const std::vector<std::size_t>& Assignment,
+                                   std::size_t NumClusters)
+{
+	const std::size_t NumFeatures = View.GetNumFeatures();
+	const std::size_t* Rows = View.GetRows();
+
+	return CoreUtilities::TaskScheduler::Get().ParallelReduce(
+		0, View.GetNumExamples(), ClusteringGrainSize, std::vector<double>(NumClusters * (NumFeatures + 1), 0.0),
+		[&](std::size_t Begin, std::size_t End) {
+			std::vector<double> Partial(NumClusters * (NumFeatures + 1), 0.0);
+			for (std::size_t Feature = 0; Feature < NumFeatures; Feature++) {
+				if (View.GetSet().GetColumn(Feature).IsSparse()) {
+					continue;
+				}
+				View.GetSet().GetColumn(Feature).Visit([&](const auto* Column) {
+					for (std::size_t Position = Begin; Position < End; Position++) {
+						Partial[Assignment[Position] * NumFeatures + Feature] +=
+							Widen(Column[Rows ? Rows[Position] : Position]);
+					}
+				});
+			}
+			View.VisitSparse(Begin, End, [&](std::size_t Index, std::uint32_t Feature, double Value) {
+				Partial[Assignment[Begin + Index] * NumFeatures + Feature] += Value;
+			});
+			for (std::size_t Position = Begin; Position < End; Position++) {
+				Partial[NumClusters * NumFeatures + Assignment[Position]] += 1.0;
+			}
+			return Partial;
+		},
+		[](std::vector<double> Left, const std::vector<double>& Right) {
+			for (std::size_t Index = 0; Index < Left.size(); Index++) {
+				Left[Index] += Right[Index];
+			}
+			return Left;
+		});
+}
+
+} // namespace
+
+
+double AssignCentroids(const TrainingView& View, const std::vector<double>& Centroids,
+                       std::size_t NumClusters, std::vector<std::size_t>& Assignment)
+{
+	const std::size_t NumFeatures = View.GetNumFeatures();
+	const std::size_t* Rows = View.GetRows();
+	Assignment.resize(View.GetNumExamples());
+
+	// Sparse features contribute |c_s|^2 to every row's distance from
+	// cluster c, corrected at the row's non-zeros by x^2 - 2 x c.
+	std::vector<double> SparseCentreNorms(NumClusters, 0.0);
+	for (std::size_t Feature = 0; Feature < NumFeatures; Feature++) {
+		if (View.GetSet().GetColumn(Feature).IsSparse()) {
+			for (std::size_t Cluster = 0; Cluster < NumClusters; Cluster++) {
+				const double Centre = Centroids[Cluster * NumFeatures + Feature];
+				SparseCentreNorms[Cluster] += Centre * Centre;
+			}
+		}
+	}
+	LEARNSCRAPE_SCOPED_TIMER(CoreUtilities::ReportPhase::Clustering);
+	LEARNSCRAPE_RECORD_VOLUME(CoreUtilities::ReportPhase::Clustering, View.GetNumExamples(),
+	                          View.GetNumExamples() * View.GetSet().GetBytesPerExample());
+	const ModelRepresentation::FixedKernelTable* Fixed = ModelRepresentation::FindFixedKernels(View);
+
+	return CoreUtilities::TaskScheduler::Get().ParallelReduce(
+		0, View.GetNumExamples(), ClusteringGrainSize, 0.0,
+		[&](std::size_t Begin, std::size_t End) {
+			if (Fixed != nullptr) {
+				return Fixed->AssignCentroids(View, Centroids.data(), NumClusters, Begin, End, &Assignment[Begin]);
+			}
+
+			// Distances[Cluster * KernelBlockSize + Index] for the current block.
+			std::vector<double> Distances(NumClusters * KernelBlockSize);
+			double Distortion = 0.0;
+
+			for (std::size_t Block = Begin; Block < End; Block += KernelBlockSize) {
+				const std::size_t Count = std::min(End, Block + KernelBlockSize) - Block;
+				for (std::size_t Cluster = 0; Cluster < NumClusters; Cluster++) {
+					std::fill_n(Distances.begin() + Cluster * KernelBlockSize, KernelBlockSize,
+					            SparseCentreNorms[Cluster]);
+				}
+
+				for (std::size_t Feature = 0; Feature < NumFeatures; Feature++) {
+					if (View.GetSet().GetColumn(Feature).IsSparse()) {
+						continue;
+					}
+					View.GetSet().GetColumn(Feature).Visit([&](const auto* Column) {
+						for (std::size_t Cluster = 0; Cluster < NumClusters; Cluster++) {
+							const double Centre = Centroids[Cluster * NumFeatures + Feature];
+							double* Distance = &Distances[Cluster * KernelBlockSize];
+							for (std::size_t Index = 0; Index < Count; Index++) {
+								const double Value = Widen(Column[Rows ? Rows[Block + Index] : Block + Index]);
+								Distance[Index] += (Value - Centre) * (Value - Centre);
+							}
+						}
+					});
+				}
+				View.VisitSparse(Block, Block + Count, [&](std::size_t Index, std::uint32_t Feature, double Value) {
+					for (std::size_t Cluster = 0; Cluster < NumClusters; Cluster++) {
+						const double Centre = Centroids[Cluster * NumFeatures + Feature];
+						Distances[Cluster * KernelBlockSize + Index] += Value * (Value - 2.0 * Centre);
+					}
+				});
+
+				for (std::size_t Index = 0; Index < Count; Index++) {
+					std::size_t Nearest = 0;
+					double NearestDistance = Distances[Index];
+					for (std::size_t Cluster = 1; Cluster < NumClusters; Cluster++) {
+						if (Distances[Cluster * KernelBlockSize + Index] < NearestDistance) {
+							NearestDistance = Distances[Cluster * KernelBlockSize + Index];
+							Nearest = Cluster;
+						}
+					}
+					Assignment[Block + Index] = Nearest;
+					Distortion += NearestDistance;
+				}
+			}
+			return Distortion;
+		},
+		[](double Left, double Right) { return Left + Right; });
+}
+
+
+void MoveCentroids(const TrainingView& View, const std::vector<std::size_t>& Assignment,
+                   std::size_t NumClusters, std::vector<double>& Centroids)
+{
+	const std::size_t NumFeatures = View.GetNumFeatures();
+	const std::vector<double> Totals = SumAssignments(View, Assignment, NumClusters);
+
+	for (std::size_t Cluster = 0; Cluster < NumClusters; Cluster++) {
+		const double Count = Totals[NumClusters * NumFeatures + Cluster];
+		if (Count == 0.0) {
+			continue;
+		}
+		for (std::size_t Feature = 0; Feature < NumFeatures; Feature++) {
+			Centroids[Cluster * NumFeatures + Feature] = Totals[Cluster * NumFeatures + Feature] / Count;
+		}
+	}
+}
+
+
+std::vector<std::size_t> CountAssignments(const std::vector<std::size_t>& Assignment, std::size_t NumClusters)
+{
+	std::vector<std::size_t> Counts(NumClusters, 0);
+	for (std::size_t Cluster : Assignment) {
+		Counts[Cluster]++;
+	}
+	return Counts;
+}
+
+
+double UpdateCentroidsOnline(const TrainingView& Delta, std::size_t NumClusters, std::vector<double>& Centroids,
+                             std::vector<std::size_t>& Counts)
+{
+	const std::size_t NumFeatures = Delta.GetNumFeatures();
+	if (Counts.size() != NumClusters || Centroids.size() != NumClusters * NumFeatures) {
+		throw std::invalid_argument("MeansClustering: centroids and counts do not match the cluster count");
+	}
+
+	std::vector<std::size_t> Assignment;
+	const double Distortion = AssignCentroids(Delta, Centroids, NumClusters, Assignment);
+	const std::vector<double> Totals = SumAssignments(Delta, Assignment, NumClusters);
+
+	// c := (n c + sum x) / (n + k): the mean of every row the centroid has absorbed.
+	for (std::size_t Cluster = 0; Cluster < NumClusters; Cluster++) {
+		const double Added = Totals[NumClusters * NumFeatures + Cluster];
+		if (Added == 0.0) {
+			continue;
+		}
+		const double Previous = static_cast<double>(Counts[Cluster]);
+		for (std::size_t Feature = 0; Feature < NumFeatures; Feature++) {
+			double& Centre = Centroids[Cluster * NumFeatures + Feature];
+			Centre = (Previous * Centre + Totals[Cluster * NumFeatures + Feature]) / (Previous + Added);
+		}
+		Counts[Cluster] += static_cast<std::size_t>(Added);
+	}
+	return Distortion;
+}
+
+
+ClusteringResult RunMeansClustering(const TrainingView& View, std::size_t NumClusters,
+                                    std::size_t MaxIterations, unsigned Seed)
+{
+	const std::size_t NumFeatures = View.GetNumFeatures();
+	if (NumClusters == 0 || NumClusters > View.GetNumExamples()) {
+		throw std::invalid_argument("MeansClustering: need 1 <= clusters <= examples");
+	}
+
+	// Forgy initialisation: NumClusters distinct rows chosen at random.
+	std::vector<std::size_t> Order(View.GetNumExamples());
+	std::iota(Order.begin(), Order.end(), 0);
+	std::shuffle(Order.begin(), Order.end(), std::mt19937(Seed));
+
+	ClusteringResult Result;
+	Result.Centroids.resize(NumClusters * NumFeatures);
+	for (std::size_t Cluster = 0; Cluster < NumClusters; Cluster++) {
+		for (std::size_t Feature = 0; Feature < NumFeatures; Feature++) {
+			Result.Centroids[Cluster * NumFeatures + Feature] = View.GetSet().GetValue(Feature, View.GetRow(Order[Cluster]));
+		}
+	}
+
+	Result.Distortion = std::numeric_limits<double>::infinity();
+	Result.Iterations = 0;
+	std::vector<std::size_t> Previous;
+
+	while (Result.Iterations < MaxIterations) {
+		Result.Distortion = AssignCentroids(View, Result.Centroids, NumClusters, Result.Assignment);
+		Result.Iterations++;
+		LEARNSCRAPE_COUNT(CoreUtilities::ReportCounter::OptimiserIterations, 1);
+		if (Result.Assignment == Previous) {
+			break;
+		}
+		MoveCentroids(View, Result.Assignment, NumClusters, Result.Centroids);
+		Previous = Result.Assignment;
+	}
+	return Result;
+}
+
+} // namespace MeansClustering
@@ -1 +1,52 @@
+#ifndef __CentroidAssignment__
+#define __CentroidAssignment__
 
+#include <cstddef>
+#include <vector>
+
+#include "MachineLearning/ModelRepresentation/TrainingSet.h"
+
+/* CENTROID ASSIGNMENT */
+// K-means clustering over the feature columns of a TrainingView. Centroids
+// are stored row-major, NumClusters x NumFeatures, in the same (usually
+// standardised) space as the columns. Distances are accumulated in double
+// whatever the storage type of the columns.
+
+namespace MeansClustering {
+
+// Assign every view position to its nearest centroid and return the sum of
+// squared distances (the distortion).
+double AssignCentroids(const ModelRepresentation::TrainingView& View, const std::vector<double>& Centroids,
+                       std::size_t NumClusters, std::vector<std::size_t>& Assignment);
+
+// Replace each centroid by the mean of its assigned rows; a cluster left
+// empty keeps its previous centroid.
+void MoveCentroids(const ModelRepresentation::TrainingView& View, const std::vector<std::size_t>& Assignment,
+                   std::size_t NumClusters, std::vector<double>& Centroids);
+
+// Rows assigned to each cluster.
+std::vector<std::size_t> CountAssignments(const std::vector<std::size_t>& Assignment, std::size_t NumClusters);
+
+// Fold the rows of Delta into existing centroids without revisiting earlier
+// rows: assign each to its nearest centroid, then move every centroid to the
+// mean of all rows it has absorbed. Counts holds how many rows each
+// centroid already summarises and is advanced. Returns the distortion of
+// Delta against the incoming centroids.
+double UpdateCentroidsOnline(const ModelRepresentation::TrainingView& Delta, std::size_t NumClusters,
+                             std::vector<double>& Centroids, std::vector<std::size_t>& Counts);
+
+struct ClusteringResult {
+	std::vector<double> Centroids;
+	std::vector<std::size_t> Assignment;
+	double Distortion;
+	std::size_t Iterations;
+};
+
+// Lloyd iterations from NumClusters distinct random rows until the
+// assignment stops changing or MaxIterations is reached.
+ClusteringResult RunMeansClustering(const ModelRepresentation::TrainingView& View, std::size_t NumClusters,
+                                    std::size_t MaxIterations, unsigned Seed);
+
+} // namespace MeansClustering
+
+#endif // __CentroidAssignment__
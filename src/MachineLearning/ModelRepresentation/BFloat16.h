@@ -0,0 +1,47 @@
+#ifndef __BFloat16__
+#define __BFloat16__
+
+#include <cstdint>
+#include <cstring>
+
+/* BFLOAT16 */
+// The upper 16 bits of an IEEE-754 binary32: same exponent range as float
+// with an 8-bit significand. Narrowing rounds to nearest even; widening is
+// exact.
+
+namespace ModelRepresentation {
+
+struct BFloat16 {
+	std::uint16_t Bits;
+};
+
+
+inline BFloat16 NarrowBFloat16(double Value)
+{
+	const float Single = static_cast<float>(Value);
+	std::uint32_t Bits;
+	std::memcpy(&Bits, &Single, sizeof(Bits));
+
+	// NaN: keep it a quiet NaN rather than letting rounding carry into Inf.
+	if ((Bits & 0x7f800000u) == 0x7f800000u && (Bits & 0x007fffffu) != 0) {
+		return BFloat16{static_cast<std::uint16_t>((Bits >> 16) | 0x0040u)};
+	}
+	Bits += 0x7fffu + ((Bits >> 16) & 1u);
+	return BFloat16{static_cast<std::uint16_t>(Bits >> 16)};
+}
+
+
+// Overloads used by the kernels to read any column type into a double.
+inline double Widen(double Value) { return Value; }
+inline double Widen(float Value) { return static_cast<double>(Value); }
+inline double Widen(BFloat16 Value)
+{
+	const std::uint32_t Bits = static_cast<std::uint32_t>(Value.Bits) << 16;
+	float Single;
+	std::memcpy(&Single, &Bits, sizeof(Single));
+	return static_cast<double>(Single);
+}
+
+} // namespace ModelRepresentation
+
+#endif // __BFloat16__
@@ -0,0 +1,168 @@
+#include "MachineLearning/ModelRepresentation/CrossValidation.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+
+#include "CoreUtilities/TaskScheduler.h"
+#include "MachineLearning/LinearRegression/CostFunction.h"
+#include "MachineLearning/LinearRegression/NormalEquation.h"
+
+namespace ModelRepresentation {
+
+namespace {
+
+void Summarise(CrossValidationResult& Result)
+{
+	const double NumFolds = static_cast<double>(Result.FoldLoss.size());
+	Result.MeanLoss = std::accumulate(Result.FoldLoss.begin(), Result.FoldLoss.end(), 0.0) / NumFolds;
+
+	double SumSquares = 0.0;
+	for (double Loss : Result.FoldLoss) {
+		SumSquares += (Loss - Result.MeanLoss) * (Loss - Result.MeanLoss);
+	}
+	Result.DeviationLoss = std::sqrt(SumSquares / NumFolds);
+}
+
+} // namespace
+
+
+/*============================================================================*/
+// FOLD PARTITION
+/*============================================================================*/
+
+FoldPartition::FoldPartition(const TrainingSet& InSet, std::size_t NumFolds, unsigned Seed)
+	: Set(&InSet), NumRows(InSet.GetNumExamples())
+{
+	if (NumFolds < 2 || NumFolds > NumRows) {
+		throw std::invalid_argument("FoldPartition: need 2 <= folds <= examples");
+	}
+
+	Order.resize(2 * NumRows);
+	std::iota(Order.begin(), Order.begin() + NumRows, 0);
+	std::shuffle(Order.begin(), Order.begin() + NumRows, std::mt19937(Seed));
+
+	// Fold sizes differ by at most one row.
+	FoldStarts.resize(NumFolds + 1);
+	for (std::size_t Fold = 0; Fold <= NumFolds; Fold++) {
+		FoldStarts[Fold] = Fold * NumRows / NumFolds;
+	}
+
+	// Sort within each fold so views stream through the columns in order.
+	for (std::size_t Fold = 0; Fold < NumFolds; Fold++) {
+		std::sort(Order.begin() + FoldStarts[Fold], Order.begin() + FoldStarts[Fold + 1]);
+	}
+	std::copy(Order.begin(), Order.begin() + NumRows, Order.begin() + NumRows);
+}
+
+
+TrainingView FoldPartition::HeldOut(std::size_t Fold) const
+{
+	return TrainingView(*Set, Order.data() + FoldStarts[Fold], FoldStarts[Fold + 1] - FoldStarts[Fold]);
+}
+
+
+TrainingView FoldPartition::Training(std::size_t Fold) const
+{
+	const std::size_t HeldOutSize = FoldStarts[Fold + 1] - FoldStarts[Fold];
+	return TrainingView(*Set, Order.data() + FoldStarts[Fold + 1], NumRows - HeldOutSize);
+}
+
+
+TrainingView FoldPartition::FoldRange(std::size_t FirstFold, std::size_t EndFold) const
+{
+	return TrainingView(*Set, Order.data() + FoldStarts[FirstFold], FoldStarts[EndFold] - FoldStarts[FirstFold]);
+}
+
+
+/*============================================================================*/
+// CROSS VALIDATION
+/*============================================================================*/
+
+CrossValidationResult CrossValidate(const FoldPartition& Folds, const ModelBuilder& Builder, std::size_t Iterations,
+                                    double Tolerance)
+{
+	const std::size_t NumFolds = Folds.GetNumFolds();
+	const std::size_t Half = NumFolds / 2;
+	CoreUtilities::TaskScheduler& Scheduler = CoreUtilities::TaskScheduler::Get();
+
+	CrossValidationResult Result;
+	Result.FoldLoss.resize(NumFolds);
+	Result.FoldIterations.resize(NumFolds);
+
+	// StartPoints[0] is fitted on folds [0, Half) and used by the folds
+	// after them; StartPoints[1] the other way round.
+	std::vector<double> StartPoints[2];
+	std::size_t StartIterations[2] = {0, 0};
+	if (Tolerance > 0.0) {
+		Scheduler.ParallelFor(0, 2, 1, [&](std::size_t Begin, std::size_t End) {
+			for (std::size_t Side = Begin; Side < End; Side++) {
+				std::unique_ptr<LearningModel> Model = Builder();
+				Model->SetTolerance(Tolerance);
+				Model->Train(Side == 0 ? Folds.FoldRange(0, Half) : Folds.FoldRange(Half, NumFolds), Iterations);
+				StartPoints[Side] = Model->GetParameters();
+				StartIterations[Side] = Model->GetIterationsTrained();
+			}
+		});
+		Result.WarmStartIterations = StartIterations[0] + StartIterations[1];
+	}
+
+	Scheduler.ParallelFor(0, NumFolds, 1, [&](std::size_t Begin, std::size_t End) {
+		for (std::size_t Fold = Begin; Fold < End; Fold++) {
+			std::unique_ptr<LearningModel> Model = Builder();
+			Model->SetTolerance(Tolerance);
+			const std::vector<double>& StartPoint = StartPoints[Fold < Half ? 1 : 0];
+			if (!StartPoint.empty()) {
+				Model->WarmStart(StartPoint);
+			}
+			Model->Train(Folds.Training(Fold), Iterations);
+			Result.FoldLoss[Fold] = Model->ValidationLoss(Folds.HeldOut(Fold));
+			Result.FoldIterations[Fold] = Model->GetIterationsTrained();
+		}
+	});
+
+	Summarise(Result);
+	return Result;
+}
+
+
+CrossValidationResult CrossValidateNormalEquation(const FoldPartition& Folds, double Lambda)
+{
+	using LinearRegression::NormalEquationSystem;
+
+	const std::size_t NumFolds = Folds.GetNumFolds();
+	CoreUtilities::TaskScheduler& Scheduler = CoreUtilities::TaskScheduler::Get();
+
+	std::vector<NormalEquationSystem> HeldOutSystems(NumFolds);
+	Scheduler.ParallelFor(0, NumFolds, 1, [&](std::size_t Begin, std::size_t End) {
+		for (std::size_t Fold = Begin; Fold < End; Fold++) {
+			HeldOutSystems[Fold] = NormalEquationSystem::Accumulate(Folds.HeldOut(Fold));
+		}
+	});
+
+	NormalEquationSystem Total(HeldOutSystems[0].GetNumParameters());
+	for (const NormalEquationSystem& System : HeldOutSystems) {
+		Total += System;
+	}
+
+	CrossValidationResult Result;
+	Result.FoldLoss.resize(NumFolds);
+	Result.FoldIterations.assign(NumFolds, 0);
+
+	Scheduler.ParallelFor(0, NumFolds, 1, [&](std::size_t Begin, std::size_t End) {
+		for (std::size_t Fold = Begin; Fold < End; Fold++) {
+			NormalEquationSystem Training = Total;
+			Training -= HeldOutSystems[Fold];
+			const std::vector<double> Theta = Training.Solve(Lambda);
+			// ComputeCost halves the mean squared residual.
+			Result.FoldLoss[Fold] = 2.0 * LinearRegression::ComputeCost(Folds.HeldOut(Fold), Theta, 0.0);
+		}
+	});
+
+	Summarise(Result);
+	return Result;
+}
+
+} // namespace ModelRepresentation
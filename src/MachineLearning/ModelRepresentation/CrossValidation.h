@@ -0,0 +1,70 @@
+#ifndef __CrossValidation__
+#define __CrossValidation__
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "MachineLearning/ModelRepresentation/LearningModel.h"
+#include "MachineLearning/ModelRepresentation/TrainingSet.h"
+
+/* CROSS VALIDATION */
+// K-fold cross-validation over a single TrainingSet. Folds are slices of one
+// shuffled index permutation; the permutation is stored twice end to end so
+// the training rows of every fold (its complement) are also one contiguous
+// slice. Both the held-out and the training side of a fold are therefore
+// plain TrainingViews and no feature data is copied.
+
+namespace ModelRepresentation {
+
+class FoldPartition {
+private:
+	const TrainingSet* Set;
+	std::size_t NumRows;
+	std::vector<std::size_t> Order;
+	std::vector<std::size_t> FoldStarts;
+
+public:
+	FoldPartition(const TrainingSet& InSet, std::size_t NumFolds, unsigned Seed);
+
+	std::size_t GetNumFolds() const { return FoldStarts.size() - 1; }
+	const TrainingSet& GetSet() const { return *Set; }
+
+	TrainingView HeldOut(std::size_t Fold) const;
+	TrainingView Training(std::size_t Fold) const;
+	// The rows of folds [FirstFold, EndFold).
+	TrainingView FoldRange(std::size_t FirstFold, std::size_t EndFold) const;
+};
+
+
+struct CrossValidationResult {
+	std::vector<double> FoldLoss;
+	std::vector<std::size_t> FoldIterations;
+	// Steps spent fitting the warm-start points, on top of FoldIterations.
+	std::size_t WarmStartIterations = 0;
+	double MeanLoss;
+	double DeviationLoss;
+};
+
+using ModelBuilder = std::function<std::unique_ptr<LearningModel>()>;
+
+// Folds are fitted in parallel, each for at most Iterations steps. With a
+// Tolerance above 0, every model stops once its cost settles, and each
+// fold is warm-started so that it settles sooner: the folds are split into
+// two halves, one start point is fitted on each half's rows, and each
+// fold starts from the point fitted on the other half. Those rows all lie
+// in the fold's training side, so no start point has seen the rows it is
+// scored on and the mean loss stays unbiased. Without a Tolerance the warm
+// start would save nothing, so every fold starts cold.
+CrossValidationResult CrossValidate(const FoldPartition& Folds, const ModelBuilder& Builder, std::size_t Iterations,
+                                    double Tolerance = 0.0);
+
+// Closed-form linear regression per fold. X^T X and X^T y are accumulated
+// once per fold (one pass over the data in total); each fold's training
+// system is the total minus the held-out fold's contribution.
+CrossValidationResult CrossValidateNormalEquation(const FoldPartition& Folds, double Lambda);
+
+} // namespace ModelRepresentation
+
+#endif // __CrossValidation__
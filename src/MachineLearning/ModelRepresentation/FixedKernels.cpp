@@ -0,0 +1,300 @@
+#include "MachineLearning/ModelRepresentation/FixedKernels.h"
+
+#include <array>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+namespace ModelRepresentation {
+
+namespace {
+
+const std::size_t NumFixedCounts = MaxFixedFeatures - MinFixedFeatures + 1;
+
+
+template <typename BodyType, std::size_t... Indices>
+inline void UnrollIndices(BodyType& Body, std::index_sequence<Indices...>)
+{
+	(Body(std::integral_constant<std::size_t, Indices>()), ...);
+}
+
+
+// Body(0) ... Body(Count - 1) with each index a compile-time constant.
+template <std::size_t Count, typename BodyType>
+inline void Unroll(BodyType&& Body)
+{
+	UnrollIndices(Body, std::make_index_sequence<Count>());
+}
+
+
+// Body(Index, Row) for view positions [Begin, End), Index = Position - Begin;
+// the identity view gets its own loop so it stays unit-stride.
+template <typename BodyType>
+inline void ForEachPosition(const TrainingView& View, std::size_t Begin, std::size_t End, BodyType&& Body)
+{
+	const std::size_t* Rows = View.GetRows();
+	if (Rows == nullptr) {
+		for (std::size_t Position = Begin; Position < End; Position++) {
+			Body(Position - Begin, Position);
+		}
+	} else {
+		for (std::size_t Position = Begin; Position < End; Position++) {
+			Body(Position - Begin, Rows[Position]);
+		}
+	}
+}
+
+
+template <std::size_t NumFeatures, typename ElementType>
+class FixedRows {
+private:
+	std::array<const ElementType*, NumFeatures> Columns;
+
+public:
+	explicit FixedRows(const TrainingSet& Set)
+	{
+		Unroll<NumFeatures>([&](auto Feature) { Columns[Feature] = Set.GetColumn(Feature).template GetData<ElementType>(); });
+	}
+
+	std::array<double, NumFeatures> Load(std::size_t Row) const
+	{
+		std::array<double, NumFeatures> Values;
+		Unroll<NumFeatures>([&](auto Feature) { Values[Feature] = Widen(Columns[Feature][Row]); });
+		return Values;
+	}
+};
+
+
+/*==============================================================================*/
+// Kernels
+/*==============================================================================*/
+template <std::size_t NumFeatures, typename ElementType>
+void FixedHypothesis(const TrainingView& View, const double* Theta, std::size_t Begin, std::size_t End, double* Out)
+{
+	const FixedRows<NumFeatures, ElementType> Rows(View.GetSet());
+	std::array<double, NumFeatures + 1> Weights;
+	Unroll<NumFeatures + 1>([&](auto Index) { Weights[Index] = Theta[Index]; });
+
+	ForEachPosition(View, Begin, End, [&](std::size_t Index, std::size_t Row) {
+		const std::array<double, NumFeatures> Values = Rows.Load(Row);
+		double Hypothesis = Weights[0];
+		Unroll<NumFeatures>([&](auto Feature) { Hypothesis += Weights[Feature + 1] * Values[Feature]; });
+		Out[Index] = Hypothesis;
+	});
+}
+
+
+template <std::size_t NumFeatures, typename ElementType>
+void FixedGradient(const TrainingView& View, std::size_t Begin, std::size_t End, const double* Residual,
+                   double* GradientSums)
+{
+	const FixedRows<NumFeatures, ElementType> Rows(View.GetSet());
+	std::array<double, NumFeatures + 1> Sums{};
+
+	ForEachPosition(View, Begin, End, [&](std::size_t Index, std::size_t Row) {
+		const std::array<double, NumFeatures> Values = Rows.Load(Row);
+		Sums[0] += Residual[Index];
+		Unroll<NumFeatures>([&](auto Feature) { Sums[Feature + 1] += Residual[Index] * Values[Feature]; });
+	});
+	Unroll<NumFeatures + 1>([&](auto Index) { GradientSums[Index] += Sums[Index]; });
+}
+
+
+template <std::size_t NumFeatures>
+inline double SquaredDistance(const std::array<double, NumFeatures>& Values, const double* Centre)
+{
+	double Distance = 0.0;
+	Unroll<NumFeatures>([&](auto Feature) {
+		Distance += (Values[Feature] - Centre[Feature]) * (Values[Feature] - Centre[Feature]);
+	});
+	return Distance;
+}
+
+
+template <std::size_t NumFeatures, typename ElementType>
+double FixedAssign(const TrainingView& View, const double* Centroids, std::size_t NumClusters, std::size_t Begin,
+                   std::size_t End, std::size_t* Assignment)
+{
+	const FixedRows<NumFeatures, ElementType> Rows(View.GetSet());
+	double Distortion = 0.0;
+
+	ForEachPosition(View, Begin, End, [&](std::size_t Index, std::size_t Row) {
+		const std::array<double, NumFeatures> Values = Rows.Load(Row);
+		std::size_t Nearest = 0;
+		double NearestDistance = SquaredDistance<NumFeatures>(Values, Centroids);
+		for (std::size_t Cluster = 1; Cluster < NumClusters; Cluster++) {
+			const double Distance = SquaredDistance<NumFeatures>(Values, Centroids + Cluster * NumFeatures);
+			if (Distance < NearestDistance) {
+				NearestDistance = Distance;
+				Nearest = Cluster;
+			}
+		}
+		Assignment[Index] = Nearest;
+		Distortion += NearestDistance;
+	});
+	return Distortion;
+}
+
+
+template <std::size_t NumFeatures, typename ElementType>
+void FixedDistances(const TrainingView& View, const double* Query, std::size_t Begin, std::size_t End, double* Out)
+{
+	const FixedRows<NumFeatures, ElementType> Rows(View.GetSet());
+	std::array<double, NumFeatures> Centre;
+	Unroll<NumFeatures>([&](auto Feature) { Centre[Feature] = Query[Feature]; });
+
+	ForEachPosition(View, Begin, End, [&](std::size_t Index, std::size_t Row) {
+		Out[Index] = SquaredDistance<NumFeatures>(Rows.Load(Row), Centre.data());
+	});
+}
+
+
+template <typename ElementType, std::size_t... Offsets>
+constexpr std::array<FixedKernelTable, NumFixedCounts> MakeKernelTables(std::index_sequence<Offsets...>)
+{
+	return {{{&FixedHypothesis<MinFixedFeatures + Offsets, ElementType>,
+	          &FixedGradient<MinFixedFeatures + Offsets, ElementType>,
+	          &FixedAssign<MinFixedFeatures + Offsets, ElementType>,
+	          &FixedDistances<MinFixedFeatures + Offsets, ElementType>}...}};
+}
+
+
+// Indexed by feature count - MinFixedFeatures.
+constexpr std::array<FixedKernelTable, NumFixedCounts> Float64Kernels =
+	MakeKernelTables<double>(std::make_index_sequence<NumFixedCounts>());
+constexpr std::array<FixedKernelTable, NumFixedCounts> Float32Kernels =
+	MakeKernelTables<float>(std::make_index_sequence<NumFixedCounts>());
+
+
+/*==============================================================================*/
+// Polynomial terms
+/*==============================================================================*/
+// PolynomialTerms(NumFeatures, Degree) built at compile time. Term t is
+// Terms[Parent[t]] * x[Factor[t]]; Parent[t] == NumTerms stands for 1.
+template <std::size_t NumFeatures, std::size_t Degree>
+struct TermTable {
+	static_assert(Degree >= 1 && Degree <= MaxFixedDegree, "no compile-time term table for this degree");
+	static constexpr std::size_t NumTerms = NumFeatures + (Degree >= 2 ? NumFeatures * (NumFeatures + 1) / 2 : 0);
+
+	std::array<std::uint8_t, NumTerms * NumFeatures> Exponents{};
+	std::array<std::size_t, NumTerms> Parent{};
+	std::array<std::size_t, NumTerms> Factor{};
+};
+
+
+// Graded order as PolynomialTerms generates it: x_0 .. x_n-1, then the
+// products x_i x_j for i <= j in lexicographic order, each built as x_j
+// times x_i.
+template <std::size_t NumFeatures, std::size_t Degree>
+constexpr TermTable<NumFeatures, Degree> MakeTermTable()
+{
+	TermTable<NumFeatures, Degree> Table{};
+	const std::size_t NumTerms = TermTable<NumFeatures, Degree>::NumTerms;
+	std::size_t Term = 0;
+	for (std::size_t Feature = 0; Feature < NumFeatures; Feature++, Term++) {
+		Table.Exponents[Term * NumFeatures + Feature] = 1;
+		Table.Parent[Term] = NumTerms;
+		Table.Factor[Term] = Feature;
+	}
+	for (std::size_t First = 0; Degree >= 2 && First < NumFeatures; First++) {
+		for (std::size_t Second = First; Second < NumFeatures; Second++, Term++) {
+			Table.Exponents[Term * NumFeatures + First]++;
+			Table.Exponents[Term * NumFeatures + Second]++;
+			Table.Parent[Term] = Second;
+			Table.Factor[Term] = First;
+		}
+	}
+	return Table;
+}
+
+
+template <std::size_t NumFeatures, std::size_t Degree>
+constexpr TermTable<NumFeatures, Degree> FixedTerms = MakeTermTable<NumFeatures, Degree>();
+
+
+template <std::size_t NumFeatures, std::size_t Degree>
+double FixedPolynomial(const double* Raw, const double* Mean, const double* Deviation, const double* Theta)
+{
+	constexpr std::size_t NumTerms = TermTable<NumFeatures, Degree>::NumTerms;
+	std::array<double, NumFeatures> Scaled;
+	Unroll<NumFeatures>([&](auto Feature) { Scaled[Feature] = (Raw[Feature] - Mean[Feature]) / Deviation[Feature]; });
+
+	std::array<double, NumTerms + 1> Terms;
+	Terms[NumTerms] = 1.0;
+	double Hypothesis = Theta[0];
+	Unroll<NumTerms>([&](auto Term) {
+		constexpr std::size_t Parent = FixedTerms<NumFeatures, Degree>.Parent[Term];
+		constexpr std::size_t Factor = FixedTerms<NumFeatures, Degree>.Factor[Term];
+		Terms[Term] = Terms[Parent] * Scaled[Factor];
+		Hypothesis += Theta[Term + 1] * Terms[Term];
+	});
+	return Hypothesis;
+}
+
+
+struct FixedPolynomialEntry {
+	FixedPolynomialFunction Function;
+	const std::uint8_t* Exponents;
+	std::size_t NumTerms;
+};
+
+
+template <std::size_t Degree, std::size_t... Offsets>
+constexpr std::array<FixedPolynomialEntry, NumFixedCounts> MakePolynomialTables(std::index_sequence<Offsets...>)
+{
+	return {{{&FixedPolynomial<MinFixedFeatures + Offsets, Degree>,
+	          FixedTerms<MinFixedFeatures + Offsets, Degree>.Exponents.data(),
+	          TermTable<MinFixedFeatures + Offsets, Degree>::NumTerms}...}};
+}
+
+
+// Indexed by degree - 1, then feature count - MinFixedFeatures.
+constexpr std::array<std::array<FixedPolynomialEntry, NumFixedCounts>, MaxFixedDegree> PolynomialTables = {{
+	MakePolynomialTables<1>(std::make_index_sequence<NumFixedCounts>()),
+	MakePolynomialTables<2>(std::make_index_sequence<NumFixedCounts>())
+}};
+
+} // namespace
+
+
+const FixedKernelTable* FindFixedKernels(const TrainingView& View)
+{
+	const std::size_t NumFeatures = View.GetNumFeatures();
+	if (NumFeatures < MinFixedFeatures || NumFeatures > MaxFixedFeatures) {
+		return nullptr;
+	}
+	const TrainingSet& Set = View.GetSet();
+	const GeneralisedFeature::DataType Type = Set.GetColumn(0).GetType();
+	for (std::size_t Feature = 1; Feature < NumFeatures; Feature++) {
+		if (Set.GetColumn(Feature).GetType() != Type) {
+			return nullptr;
+		}
+	}
+
+	switch (Type) {
+	case GeneralisedFeature::DataType::Float64:
+		return &Float64Kernels[NumFeatures - MinFixedFeatures];
+	case GeneralisedFeature::DataType::Float32:
+		return &Float32Kernels[NumFeatures - MinFixedFeatures];
+	default:
+		return nullptr;
+	}
+}
+
+
+FixedPolynomialFunction FindFixedPolynomial(std::size_t NumFeatures, std::size_t NumTerms,
+                                            const std::uint8_t* Exponents)
+{
+	if (NumFeatures < MinFixedFeatures || NumFeatures > MaxFixedFeatures) {
+		return nullptr;
+	}
+	for (const auto& Degree : PolynomialTables) {
+		const FixedPolynomialEntry& Entry = Degree[NumFeatures - MinFixedFeatures];
+		if (Entry.NumTerms == NumTerms && std::memcmp(Entry.Exponents, Exponents, NumTerms * NumFeatures) == 0) {
+			return Entry.Function;
+		}
+	}
+	return nullptr;
+}
+
+} // namespace ModelRepresentation
@@ -0,0 +1,74 @@
+#ifndef __FixedKernels__
+#define __FixedKernels__
+
+#include <cstddef>
+#include <cstdint>
+
+#include "MachineLearning/ModelRepresentation/TrainingSet.h"
+
+/* FIXED-SIZE KERNELS */
+// Most production models keep only a handful of features after selection.
+// At those widths, the generic kernels spend their time on loop setup,
+// per-column type dispatch and repeated passes over the block buffers, not
+// on arithmetic. For MinFixedFeatures..MaxFixedFeatures features, the same
+// kernels are instantiated with the feature count as a template parameter:
+// - theta and the row are held in std::arrays;
+// - the feature loop is unrolled, so each row is read once and
+//   accumulated in registers.
+// FindFixedKernels picks the instantiation from a table indexed by feature
+// count and storage type. The generic kernels consult it first and keep
+// their own path for other widths, sparse columns and mixed storage. Each
+// fixed kernel adds terms in the generic kernel's order. bfloat16 columns
+// also stay generic: widening them row by row costs more than the
+// column-at-a-time loops save.
+//
+// Mapped polynomial models get the same treatment. Their exponent table is
+// compared against compile-time tables for degrees up to MaxFixedDegree.
+// Each term is then one multiply of an earlier term (or 1) by a feature,
+// with every index a constant.
+
+namespace ModelRepresentation {
+
+const std::size_t MinFixedFeatures = 3;
+const std::size_t MaxFixedFeatures = 16;
+const std::size_t MaxFixedDegree = 2;
+
+
+// Kernels specialised for one feature count and column type, over view
+// positions [Begin, End).
+struct FixedKernelTable {
+	// LinearRegression::EvaluateHypothesis; Theta holds NumFeatures + 1 values.
+	void (*EvaluateHypothesis)(const TrainingView& View, const double* Theta, std::size_t Begin, std::size_t End,
+	                           double* Out);
+	// LinearRegression::AccumulateGradientBlock.
+	void (*AccumulateGradient)(const TrainingView& View, std::size_t Begin, std::size_t End, const double* Residual,
+	                           double* GradientSums);
+	// Nearest of the NumClusters row-major Centroids for each position, into
+	// Assignment[0 .. End - Begin); returns the sum of squared distances.
+	double (*AssignCentroids)(const TrainingView& View, const double* Centroids, std::size_t NumClusters,
+	                          std::size_t Begin, std::size_t End, std::size_t* Assignment);
+	// Out[p - Begin] = ||x_p - Query||^2.
+	void (*SquaredDistances)(const TrainingView& View, const double* Query, std::size_t Begin, std::size_t End,
+	                         double* Out);
+};
+
+// Kernels for View's feature count, or nullptr when the generic path must
+// be used: the count is out of range, or the columns are not all float64 or
+// all float32.
+const FixedKernelTable* FindFixedKernels(const TrainingView& View);
+
+
+// h(x) of a polynomial model for one row of raw inputs: standardise with
+// Mean / Deviation, expand the terms and weight them by Theta (intercept
+// first).
+using FixedPolynomialFunction = double (*)(const double* Raw, const double* Mean, const double* Deviation,
+                                           const double* Theta);
+
+// The evaluator for an exponent table equal to PolynomialTerms(NumFeatures,
+// Degree) with Degree <= MaxFixedDegree, or nullptr.
+FixedPolynomialFunction FindFixedPolynomial(std::size_t NumFeatures, std::size_t NumTerms,
+                                            const std::uint8_t* Exponents);
+
+} // namespace ModelRepresentation
+
+#endif // __FixedKernels__
@@ -0,0 +1,39 @@
+#include "MachineLearning/ModelRepresentation/GeneralisedFeature.h"
+
+#include <utility>
+
+namespace ModelRepresentation {
+
+GeneralisedFeature::GeneralisedFeature(std::string InVariableName, std::string InStandardUnit, DataType InType)
+	: VariableName(std::move(InVariableName)),
+	  StandardUnit(std::move(InStandardUnit)),
+	  Type(InType),
+	  ScalingMean(0.0),
+	  ScalingDeviation(1.0)
+{
+}
+
+
+std::size_t GeneralisedFeature::GetBytesPerValue(DataType Type)
+{
+	switch (Type) {
+	case DataType::Float32:
+		return 4;
+	case DataType::BFloat16:
+		return 2;
+	case DataType::Sparse:
+		return sizeof(double) + sizeof(std::uint32_t);
+	default:
+		return 8;
+	}
+}
+
+
+void GeneralisedFeature::SetScaling(double Mean, double Deviation)
+{
+	// A constant column has zero spread; leave it centred but unscaled.
+	ScalingMean = Mean;
+	ScalingDeviation = (Deviation > 0.0) ? Deviation : 1.0;
+}
+
+} // namespace ModelRepresentation
@@ -0,0 +1,57 @@
+#ifndef __GeneralisedFeature__
+#define __GeneralisedFeature__
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/* GENERALISED FEATURE */
+// Describes one input column of a TrainingSet: its name, physical unit and
+// the standardisation (mean / standard deviation) applied to it. The scaling
+// statistics travel with the feature so a trained model can rescale raw
+// inputs at prediction time. DataType selects how the TrainingSet stores
+// the column; kernels always accumulate in double. Sparse features are kept
+// in the set's CSR block, which stores only their non-zeros.
+
+namespace ModelRepresentation {
+
+class GeneralisedFeature {
+public:
+	enum class DataType : std::uint8_t {
+		Float64,
+		Float32,
+		BFloat16,
+		Sparse
+	};
+
+	// Bytes per stored value; for Sparse, per stored non-zero (value + index).
+	static std::size_t GetBytesPerValue(DataType Type);
+
+private:
+	std::string VariableName;
+	std::string StandardUnit;
+	DataType Type;
+	double ScalingMean;
+	double ScalingDeviation;
+
+public:
+	explicit GeneralisedFeature(std::string InVariableName, std::string InStandardUnit = "",
+	                            DataType InType = DataType::Float64);
+
+	const std::string& GetVariableName() const { return VariableName; }
+	const std::string& GetStandardUnit() const { return StandardUnit; }
+
+	DataType GetDataType() const { return Type; }
+	void SetDataType(DataType InType) { Type = InType; }
+
+	double GetScalingMean() const { return ScalingMean; }
+	double GetScalingDeviation() const { return ScalingDeviation; }
+	void SetScaling(double Mean, double Deviation);
+
+	// Map a raw value into the standardised space used for training.
+	double Scale(double RawValue) const { return (RawValue - ScalingMean) / ScalingDeviation; }
+};
+
+} // namespace ModelRepresentation
+
+#endif // __GeneralisedFeature__
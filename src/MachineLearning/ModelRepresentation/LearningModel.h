@@ -0,0 +1,56 @@
+#ifndef __LearningModel__
+#define __LearningModel__
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "MachineLearning/ModelRepresentation/TrainingSet.h"
+
+/* LEARNING MODEL */
+// Strategy interface implemented by every trainable model so drivers (the
+// hyperparameter search, cross-validation) can train and compare them
+// without knowing the algorithm. Training is resumable: each Train() call
+// continues from the current parameters, which lets a driver hand out its
+// iteration budget in rungs.
+
+namespace ModelRepresentation {
+
+class LearningModel {
+public:
+	// Called after every optimisation step with the step count so far and the
+	// training cost that step was taken from.
+	using IterationObserver = std::function<void(std::size_t Iteration, double Cost)>;
+
+	virtual ~LearningModel() = default;
+
+	// Run Iterations further optimisation steps on View.
+	virtual void Train(const TrainingView& View, std::size_t Iterations) = 0;
+
+	// Loss on held-out rows; lower is better. Regression models report the
+	// mean squared error and classifiers the misclassification rate, so only
+	// models of the same kind are comparable.
+	virtual double ValidationLoss(const TrainingView& View) const = 0;
+
+	virtual std::size_t GetIterationsTrained() const = 0;
+
+	virtual std::string Describe() const = 0;
+
+	// Parameter vector used to warm-start another instance of the same
+	// model; models without one return an empty vector and ignore WarmStart.
+	virtual std::vector<double> GetParameters() const { return {}; }
+	virtual void WarmStart(const std::vector<double>& Parameters) { (void)Parameters; }
+
+	// Models that do not compute a training cost per step ignore the observer.
+	virtual void SetIterationObserver(IterationObserver Observer) { (void)Observer; }
+
+	// Let Train stop before its budget once a step changes the training cost
+	// by less than Tolerance relative to the step before; 0, the default,
+	// always runs the full budget. Ignored like the observer.
+	virtual void SetTolerance(double Tolerance) { (void)Tolerance; }
+};
+
+} // namespace ModelRepresentation
+
+#endif // __LearningModel__
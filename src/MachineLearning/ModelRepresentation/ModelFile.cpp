@@ -0,0 +1,156 @@
+#include "MachineLearning/ModelRepresentation/ModelFile.h"
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "MachineLearning/LogisticRegression/SigmoidFunction.h"
+#include "MachineLearning/ModelRepresentation/FixedKernels.h"
+
+namespace ModelRepresentation {
+
+namespace {
+
+const char ModelMagic[8] = {'L', 'S', 'M', 'O', 'D', 'E', 'L', '\0'};
+const std::uint32_t ModelVersion = 1;
+
+
+std::size_t ModelFileSize(std::size_t NumFeatures, std::size_t NumTerms)
+{
+	return sizeof(ModelFileHeader)
+		+ sizeof(double) * (2 * NumFeatures + NumTerms + 1)
+		+ NumTerms * NumFeatures;
+}
+
+} // namespace
+
+
+void WriteModelFile(const std::string& Path, ModelKind Kind, const std::vector<GeneralisedFeature>& Features,
+                    const PolynomialTerms& Terms, const std::vector<double>& Theta)
+{
+	if (Terms.GetNumFeatures() != Features.size() || Theta.size() != Terms.GetNumTerms() + 1) {
+		throw std::invalid_argument("ModelFile: theta, terms and features are inconsistent");
+	}
+
+	ModelFileHeader Header;
+	std::memcpy(Header.Magic, ModelMagic, sizeof(ModelMagic));
+	Header.Version = ModelVersion;
+	Header.Kind = Kind;
+	Header.NumFeatures = static_cast<std::uint32_t>(Features.size());
+	Header.NumTerms = static_cast<std::uint32_t>(Terms.GetNumTerms());
+	Header.Reserved = 0;
+
+	std::vector<double> Means, Deviations;
+	for (const GeneralisedFeature& Feature : Features) {
+		Means.push_back(Feature.GetScalingMean());
+		Deviations.push_back(Feature.GetScalingDeviation());
+	}
+
+	std::ofstream File(Path, std::ios::binary | std::ios::trunc);
+	File.write(reinterpret_cast<const char*>(&Header), sizeof(Header));
+	File.write(reinterpret_cast<const char*>(Means.data()), sizeof(double) * Means.size());
+	File.write(reinterpret_cast<const char*>(Deviations.data()), sizeof(double) * Deviations.size());
+	File.write(reinterpret_cast<const char*>(Theta.data()), sizeof(double) * Theta.size());
+	File.write(reinterpret_cast<const char*>(Terms.GetExponents().data()), Terms.GetExponents().size());
+	if (!File) {
+		throw std::runtime_error("ModelFile: cannot write " + Path);
+	}
+}
+
+
+/*============================================================================*/
+// MAPPED MODEL
+/*============================================================================*/
+
+MappedModel::MappedModel(const std::string& Path)
+	: Mapping(nullptr), MappingSize(0), FixedPredict(nullptr)
+{
+	const int Descriptor = ::open(Path.c_str(), O_RDONLY);
+	if (Descriptor < 0) {
+		throw std::runtime_error("ModelFile: cannot open " + Path);
+	}
+
+	struct stat Status;
+	if (::fstat(Descriptor, &Status) != 0 || static_cast<std::size_t>(Status.st_size) < sizeof(ModelFileHeader)) {
+		::close(Descriptor);
+		throw std::runtime_error("ModelFile: " + Path + " is truncated");
+	}
+
+	MappingSize = static_cast<std::size_t>(Status.st_size);
+	Mapping = ::mmap(nullptr, MappingSize, PROT_READ, MAP_PRIVATE | MAP_POPULATE, Descriptor, 0);
+	::close(Descriptor);
+	if (Mapping == MAP_FAILED) {
+		Mapping = nullptr;
+		throw std::runtime_error("ModelFile: cannot map " + Path);
+	}
+
+	Header = static_cast<const ModelFileHeader*>(Mapping);
+	if (std::memcmp(Header->Magic, ModelMagic, sizeof(ModelMagic)) != 0 || Header->Version != ModelVersion ||
+	    MappingSize != ModelFileSize(Header->NumFeatures, Header->NumTerms)) {
+		::munmap(Mapping, MappingSize);
+		throw std::runtime_error("ModelFile: " + Path + " is not a learnscrape model");
+	}
+
+	const double* Values = reinterpret_cast<const double*>(Header + 1);
+	ScalingMean = Values;
+	ScalingDeviation = ScalingMean + Header->NumFeatures;
+	Theta = ScalingDeviation + Header->NumFeatures;
+	Exponents = reinterpret_cast<const std::uint8_t*>(Theta + Header->NumTerms + 1);
+	FixedPredict = FindFixedPolynomial(Header->NumFeatures, Header->NumTerms, Exponents);
+}
+
+
+MappedModel::~MappedModel()
+{
+	if (Mapping) {
+		::munmap(Mapping, MappingSize);
+	}
+}
+
+
+void MappedModel::Predict(const double* Inputs, std::size_t NumRows, double* Outputs) const
+{
+	const std::size_t NumFeatures = Header->NumFeatures;
+	const std::size_t NumTerms = Header->NumTerms;
+	const bool bLogistic = Header->Kind == ModelKind::Logistic;
+
+	if (FixedPredict != nullptr) {
+		for (std::size_t Row = 0; Row < NumRows; Row++) {
+			const double Hypothesis = FixedPredict(Inputs + Row * NumFeatures, ScalingMean, ScalingDeviation, Theta);
+			Outputs[Row] = bLogistic ? LogisticRegression::Sigmoid(Hypothesis) : Hypothesis;
+		}
+		return;
+	}
+
+	// Scratch is reused across calls so the serving loop never allocates.
+	thread_local std::vector<double> Scaled;
+	Scaled.resize(NumFeatures);
+
+	for (std::size_t Row = 0; Row < NumRows; Row++) {
+		const double* Raw = Inputs + Row * NumFeatures;
+		for (std::size_t Feature = 0; Feature < NumFeatures; Feature++) {
+			Scaled[Feature] = (Raw[Feature] - ScalingMean[Feature]) / ScalingDeviation[Feature];
+		}
+
+		double Hypothesis = Theta[0];
+		const std::uint8_t* Term = Exponents;
+		for (std::size_t Index = 0; Index < NumTerms; Index++, Term += NumFeatures) {
+			double Value = 1.0;
+			for (std::size_t Feature = 0; Feature < NumFeatures; Feature++) {
+				for (std::uint8_t Power = 0; Power < Term[Feature]; Power++) {
+					Value *= Scaled[Feature];
+				}
+			}
+			Hypothesis += Theta[Index + 1] * Value;
+		}
+
+		Outputs[Row] = bLogistic ? LogisticRegression::Sigmoid(Hypothesis) : Hypothesis;
+	}
+}
+
+} // namespace ModelRepresentation
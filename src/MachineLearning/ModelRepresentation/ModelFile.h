@@ -0,0 +1,81 @@
+#ifndef __ModelFile__
+#define __ModelFile__
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "MachineLearning/ModelRepresentation/FixedKernels.h"
+#include "MachineLearning/ModelRepresentation/GeneralisedFeature.h"
+#include "MachineLearning/ModelRepresentation/PolynomialTerms.h"
+
+/* MODEL FILE */
+// Compact binary form of a trained polynomial model, laid out so it can be
+// memory-mapped and used in place:
+//
+//   ModelFileHeader                         32 bytes
+//   double  ScalingMean[NumFeatures]
+//   double  ScalingDeviation[NumFeatures]
+//   double  Theta[NumTerms + 1]             intercept first
+//   uint8_t Exponents[NumTerms * NumFeatures]
+//
+// All values are little-endian; the doubles are 8-byte aligned.
+
+namespace ModelRepresentation {
+
+enum class ModelKind : std::uint32_t {
+	Linear = 0,
+	Logistic = 1
+};
+
+struct ModelFileHeader {
+	char Magic[8];
+	std::uint32_t Version;
+	ModelKind Kind;
+	std::uint32_t NumFeatures;
+	std::uint32_t NumTerms;
+	std::uint64_t Reserved;
+};
+
+static_assert(sizeof(ModelFileHeader) == 32, "ModelFileHeader must stay 32 bytes");
+
+// Throws std::runtime_error if the file cannot be written.
+void WriteModelFile(const std::string& Path, ModelKind Kind, const std::vector<GeneralisedFeature>& Features,
+                    const PolynomialTerms& Terms, const std::vector<double>& Theta);
+
+
+// Read-only mapping of a model file. Predictions take raw (unscaled)
+// feature values, apply the stored standardisation and polynomial terms, and
+// return h(x) (a probability for logistic models). Models whose terms are a
+// small standard table are evaluated through FindFixedPolynomial.
+class MappedModel {
+private:
+	void* Mapping;
+	std::size_t MappingSize;
+	const ModelFileHeader* Header;
+	const double* ScalingMean;
+	const double* ScalingDeviation;
+	const double* Theta;
+	const std::uint8_t* Exponents;
+	// Compile-time evaluator for small degree-1 and degree-2 models, if any.
+	FixedPolynomialFunction FixedPredict;
+
+public:
+	// Throws std::runtime_error for a missing, truncated or foreign file.
+	explicit MappedModel(const std::string& Path);
+	MappedModel(const MappedModel&) = delete;
+	MappedModel& operator=(const MappedModel&) = delete;
+	~MappedModel();
+
+	ModelKind GetKind() const { return Header->Kind; }
+	std::size_t GetNumFeatures() const { return Header->NumFeatures; }
+	std::size_t GetNumTerms() const { return Header->NumTerms; }
+
+	// Inputs is row-major NumRows x GetNumFeatures().
+	void Predict(const double* Inputs, std::size_t NumRows, double* Outputs) const;
+};
+
+} // namespace ModelRepresentation
+
+#endif // __ModelFile__
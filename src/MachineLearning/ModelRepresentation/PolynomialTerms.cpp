@@ -0,0 +1,126 @@
+#include "MachineLearning/ModelRepresentation/PolynomialTerms.h"
+
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+#include "CoreUtilities/TaskScheduler.h"
+
+namespace ModelRepresentation {
+
+namespace {
+
+// Append every exponent vector of total degree Remaining over features
+// [Feature, NumFeatures), in lexicographically descending order.
+void EmitTerms(std::size_t Feature, std::size_t Remaining, std::vector<std::uint8_t>& Current,
+               std::vector<std::uint8_t>& Out)
+{
+	if (Feature + 1 == Current.size()) {
+		Current[Feature] = static_cast<std::uint8_t>(Remaining);
+		Out.insert(Out.end(), Current.begin(), Current.end());
+		return;
+	}
+	for (std::size_t Power = Remaining + 1; Power-- > 0;) {
+		Current[Feature] = static_cast<std::uint8_t>(Power);
+		EmitTerms(Feature + 1, Remaining - Power, Current, Out);
+	}
+}
+
+} // namespace
+
+
+PolynomialTerms::PolynomialTerms(std::size_t InNumFeatures, std::size_t Degree)
+	: NumFeatures(InNumFeatures)
+{
+	if (Degree > 255) {
+		throw std::invalid_argument("PolynomialTerms: degree must fit in one byte");
+	}
+	std::vector<std::uint8_t> Current(NumFeatures, 0);
+	for (std::size_t Order = 1; Order <= Degree && NumFeatures > 0; Order++) {
+		EmitTerms(0, Order, Current, Exponents);
+	}
+}
+
+
+PolynomialTerms::PolynomialTerms(std::size_t InNumFeatures, std::vector<std::uint8_t> InExponents)
+	: NumFeatures(InNumFeatures), Exponents(std::move(InExponents))
+{
+	if (NumFeatures == 0 || Exponents.size() % NumFeatures != 0) {
+		throw std::invalid_argument("PolynomialTerms: exponent table does not match the feature count");
+	}
+}
+
+
+void PolynomialTerms::Expand(const double* Inputs, double* Terms) const
+{
+	const std::uint8_t* Row = Exponents.data();
+	for (std::size_t Term = 0; Term < GetNumTerms(); Term++, Row += NumFeatures) {
+		double Value = 1.0;
+		for (std::size_t Feature = 0; Feature < NumFeatures; Feature++) {
+			for (std::uint8_t Power = 0; Power < Row[Feature]; Power++) {
+				Value *= Inputs[Feature];
+			}
+		}
+		Terms[Term] = Value;
+	}
+}
+
+
+TrainingSet PolynomialTerms::ExpandTrainingSet(const TrainingSet& Set) const
+{
+	const std::size_t NumTerms = GetNumTerms();
+	const std::size_t NumRows = Set.GetNumExamples();
+
+	std::vector<GeneralisedFeature> TermFeatures;
+	for (std::size_t Term = 0; Term < NumTerms; Term++) {
+		TermFeatures.emplace_back(DescribeTerm(Term, Set.GetFeatures()));
+	}
+
+	std::vector<std::vector<double>> Columns(NumTerms, std::vector<double>(NumRows, 1.0));
+	CoreUtilities::TaskScheduler::Get().ParallelFor(0, NumTerms, 1, [&](std::size_t Begin, std::size_t End) {
+		for (std::size_t Term = Begin; Term < End; Term++) {
+			const std::uint8_t* Row = &Exponents[Term * NumFeatures];
+			std::vector<double>& Column = Columns[Term];
+			for (std::size_t Feature = 0; Feature < NumFeatures; Feature++) {
+				if (Set.GetColumn(Feature).IsSparse()) {
+					for (std::size_t Example = 0; Row[Feature] != 0 && Example < NumRows; Example++) {
+						Column[Example] *= std::pow(Set.GetValue(Feature, Example), Row[Feature]);
+					}
+					continue;
+				}
+				Set.GetColumn(Feature).Visit([&](const auto* Source) {
+					for (std::uint8_t Power = 0; Power < Row[Feature]; Power++) {
+						for (std::size_t Example = 0; Example < NumRows; Example++) {
+							Column[Example] *= Widen(Source[Example]);
+						}
+					}
+				});
+			}
+		}
+	});
+
+	std::vector<double> Outputs(Set.GetOutputs(), Set.GetOutputs() + NumRows);
+	return TrainingSet(std::move(TermFeatures), std::move(Columns), std::move(Outputs), Set.GetOutputName());
+}
+
+
+std::string PolynomialTerms::DescribeTerm(std::size_t Term, const std::vector<GeneralisedFeature>& Features) const
+{
+	std::string Name;
+	const std::uint8_t* Row = &Exponents[Term * NumFeatures];
+	for (std::size_t Feature = 0; Feature < NumFeatures; Feature++) {
+		if (Row[Feature] == 0) {
+			continue;
+		}
+		if (!Name.empty()) {
+			Name += "*";
+		}
+		Name += Features[Feature].GetVariableName();
+		if (Row[Feature] > 1) {
+			Name += "^" + std::to_string(Row[Feature]);
+		}
+	}
+	return Name;
+}
+
+} // namespace ModelRepresentation
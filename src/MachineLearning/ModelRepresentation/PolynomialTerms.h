@@ -0,0 +1,46 @@
+#ifndef __PolynomialTerms__
+#define __PolynomialTerms__
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "MachineLearning/ModelRepresentation/TrainingSet.h"
+
+/* POLYNOMIAL TERMS */
+// Table of the monomials used by multivariate polynomial regression. Term t
+// is prod_j x_j^Exponents[t * NumFeatures + j]. Terms are generated in
+// graded order (all degree-1 terms, then degree 2, ...), so the first
+// NumFeatures terms are the features themselves and Degree = 1 reproduces
+// plain linear regression. The constant term is the model intercept and is
+// not part of the table.
+
+namespace ModelRepresentation {
+
+class PolynomialTerms {
+private:
+	std::size_t NumFeatures;
+	std::vector<std::uint8_t> Exponents;
+
+public:
+	PolynomialTerms(std::size_t InNumFeatures, std::size_t Degree);
+	PolynomialTerms(std::size_t InNumFeatures, std::vector<std::uint8_t> InExponents);
+
+	std::size_t GetNumFeatures() const { return NumFeatures; }
+	std::size_t GetNumTerms() const { return NumFeatures ? Exponents.size() / NumFeatures : 0; }
+	const std::vector<std::uint8_t>& GetExponents() const { return Exponents; }
+
+	// Terms[t] for one example given its NumFeatures (scaled) inputs.
+	void Expand(const double* Inputs, double* Terms) const;
+
+	// New set whose features are the terms evaluated on Set's columns.
+	TrainingSet ExpandTrainingSet(const TrainingSet& Set) const;
+
+	// Human-readable name such as "Density^2*Mass".
+	std::string DescribeTerm(std::size_t Term, const std::vector<GeneralisedFeature>& Features) const;
+};
+
+} // namespace ModelRepresentation
+
+#endif // __PolynomialTerms__
@@ -0,0 +1,913 @@
+#include "MachineLearning/ModelRepresentation/TrainingSet.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+#include "CoreUtilities/ReportGeneration.h"
+#include "CoreUtilities/TaskScheduler.h"
+
+namespace ModelRepresentation {
+
+namespace {
+
+const std::size_t CsvGrainSize = 4096;
+
+
+std::string Trim(const std::string& Text)
+{
+	const std::size_t First = Text.find_first_not_of(" \t\r\"");
+	if (First == std::string::npos) {
+		return "";
+	}
+	const std::size_t Last = Text.find_last_not_of(" \t\r\"");
+	return Text.substr(First, Last - First + 1);
+}
+
+
+bool IsBlank(const char* Begin, const char* End)
+{
+	for (const char* Cursor = Begin; Cursor < End; Cursor++) {
+		if (*Cursor != ' ' && *Cursor != '\t' && *Cursor != '\r') {
+			return false;
+		}
+	}
+	return true;
+}
+
+
+// Split "Name [Unit]" into its name and unit.
+GeneralisedFeature ParseHeaderCell(const std::string& Cell)
+{
+	const std::string Text = Trim(Cell);
+	const std::size_t Open = Text.find('[');
+	const std::size_t Close = Text.rfind(']');
+
+	if (Open != std::string::npos && Close != std::string::npos && Close > Open) {
+		return GeneralisedFeature(Trim(Text.substr(0, Open)), Trim(Text.substr(Open + 1, Close - Open - 1)));
+	}
+	return GeneralisedFeature(Text);
+}
+
+
+std::vector<std::string> SplitHeader(const std::string& Line)
+{
+	std::vector<std::string> Cells;
+	std::stringstream Header(Line);
+	std::string Cell;
+	while (std::getline(Header, Cell, ',')) {
+		Cells.push_back(Cell);
+	}
+	return Cells;
+}
+
+
+bool IsCellPadding(char Character)
+{
+	return Character == ' ' || Character == '\t' || Character == '\r' || Character == '"';
+}
+
+
+// Parse the NumValues comma-separated numbers of the row at Cursor into
+// Values. The row ends at the next newline or at End. Returns an empty
+// string on success, otherwise what is wrong.
+std::string ParseCsvRow(const char* Cursor, const char* End, std::size_t NumValues, double* Values)
+{
+	for (std::size_t Column = 0; Column < NumValues; Column++) {
+		// Bound the cell first so strtod can never read into the next one.
+		const char* CellEnd = Cursor;
+		while (CellEnd < End && *CellEnd != ',' && *CellEnd != '\n') {
+			CellEnd++;
+		}
+		const char* First = Cursor;
+		const char* Last = CellEnd;
+		while (First < Last && IsCellPadding(*First)) {
+			First++;
+		}
+		while (Last > First && IsCellPadding(Last[-1])) {
+			Last--;
+		}
+		if (First == Last) {
+			return "column " + std::to_string(Column + 1) + " is empty";
+		}
+		char* Next = nullptr;
+		Values[Column] = std::strtod(First, &Next);
+		if (Next != Last) {
+			return "column " + std::to_string(Column + 1) + " is not numeric";
+		}
+
+		Cursor = CellEnd;
+		if (Column + 1 < NumValues) {
+			if (Cursor == End || *Cursor != ',') {
+				return "has too few columns";
+			}
+			Cursor++;
+		}
+	}
+	if (Cursor < End && *Cursor != '\n') {
+		return "has too many columns";
+	}
+	return "";
+}
+
+} // namespace
+
+
+/*============================================================================*/
+// FEATURE COLUMN
+/*============================================================================*/
+
+FeatureColumn::FeatureColumn(GeneralisedFeature::DataType InType)
+	: Type(InType)
+{
+}
+
+
+std::size_t FeatureColumn::GetSize() const
+{
+	// Only the vector matching Type is ever populated.
+	return Float64Values.size() + Float32Values.size() + BFloat16Values.size();
+}
+
+
+double FeatureColumn::Get(std::size_t Row) const
+{
+	if (IsSparse()) {
+		throw std::logic_error("FeatureColumn: sparse values are held by the SparseFeatureBlock");
+	}
+	return Visit([Row](const auto* Values) { return Widen(Values[Row]); });
+}
+
+
+void FeatureColumn::Set(std::size_t Row, double Value)
+{
+	switch (Type) {
+	case GeneralisedFeature::DataType::Float32:
+		Float32Values[Row] = static_cast<float>(Value);
+		break;
+	case GeneralisedFeature::DataType::BFloat16:
+		BFloat16Values[Row] = NarrowBFloat16(Value);
+		break;
+	case GeneralisedFeature::DataType::Sparse:
+		throw std::logic_error("FeatureColumn: sparse values are held by the SparseFeatureBlock");
+	default:
+		Float64Values[Row] = Value;
+		break;
+	}
+}
+
+
+void FeatureColumn::PushBack(double Value)
+{
+	switch (Type) {
+	case GeneralisedFeature::DataType::Float32:
+		Float32Values.push_back(static_cast<float>(Value));
+		break;
+	case GeneralisedFeature::DataType::BFloat16:
+		BFloat16Values.push_back(NarrowBFloat16(Value));
+		break;
+	case GeneralisedFeature::DataType::Sparse:
+		break;
+	default:
+		Float64Values.push_back(Value);
+		break;
+	}
+}
+
+
+void FeatureColumn::Resize(std::size_t Size)
+{
+	switch (Type) {
+	case GeneralisedFeature::DataType::Float32:
+		Float32Values.resize(Size);
+		break;
+	case GeneralisedFeature::DataType::BFloat16:
+		BFloat16Values.resize(Size);
+		break;
+	case GeneralisedFeature::DataType::Sparse:
+		break;
+	default:
+		Float64Values.resize(Size);
+		break;
+	}
+}
+
+
+void FeatureColumn::Reserve(std::size_t Size)
+{
+	switch (Type) {
+	case GeneralisedFeature::DataType::Float32:
+		Float32Values.reserve(Size);
+		break;
+	case GeneralisedFeature::DataType::BFloat16:
+		BFloat16Values.reserve(Size);
+		break;
+	case GeneralisedFeature::DataType::Sparse:
+		break;
+	default:
+		Float64Values.reserve(Size);
+		break;
+	}
+}
+
+
+void FeatureColumn::Convert(GeneralisedFeature::DataType NewType)
+{
+	if (NewType == Type) {
+		return;
+	}
+	if (IsSparse() || NewType == GeneralisedFeature::DataType::Sparse) {
+		throw std::logic_error("FeatureColumn: use TrainingSet::SetStorageType to change sparsity");
+	}
+
+	FeatureColumn Converted(NewType);
+	const std::size_t Size = GetSize();
+	Converted.Resize(Size);
+	for (std::size_t Row = 0; Row < Size; Row++) {
+		Converted.Set(Row, Get(Row));
+	}
+	*this = std::move(Converted);
+}
+
+
+/*============================================================================*/
+// SPARSE FEATURE BLOCK
+/*============================================================================*/
+
+std::size_t SparseFeatureBlock::GetStorageBytes() const
+{
+	return RowOffsets.size() * sizeof(std::size_t)
+		+ Values.size() * GeneralisedFeature::GetBytesPerValue(GeneralisedFeature::DataType::Sparse);
+}
+
+
+double SparseFeatureBlock::Get(std::size_t Row, std::size_t Feature) const
+{
+	const std::uint32_t* Begin = FeatureIds.data() + RowOffsets[Row];
+	const std::uint32_t* End = FeatureIds.data() + RowOffsets[Row + 1];
+	const std::uint32_t* Found = std::lower_bound(Begin, End, static_cast<std::uint32_t>(Feature));
+	return (Found != End && *Found == Feature) ? Values[Found - FeatureIds.data()] : 0.0;
+}
+
+
+void SparseFeatureBlock::AppendRow(const double* Inputs, const std::vector<std::uint32_t>& SparseFeatures)
+{
+	if (RowOffsets.empty()) {
+		RowOffsets.push_back(0);
+	}
+	for (std::uint32_t Feature : SparseFeatures) {
+		if (Inputs[Feature] != 0.0) {
+			FeatureIds.push_back(Feature);
+			Values.push_back(Inputs[Feature]);
+		}
+	}
+	RowOffsets.push_back(Values.size());
+}
+
+
+void SparseFeatureBlock::Reserve(std::size_t NumRows)
+{
+	RowOffsets.reserve(NumRows + 1);
+}
+
+
+void SparseFeatureBlock::InsertFeatures(const std::vector<std::uint32_t>& Features,
+                                        const std::vector<const FeatureColumn*>& Columns, std::size_t NumRows)
+{
+	if (!RowOffsets.empty() && GetNumRows() != NumRows) {
+		throw std::invalid_argument("SparseFeatureBlock: inserted columns must match the block's row count");
+	}
+	if (RowOffsets.empty()) {
+		RowOffsets.assign(NumRows + 1, 0);
+	}
+
+	std::vector<std::size_t> Order(Features.size());
+	std::iota(Order.begin(), Order.end(), 0);
+	std::sort(Order.begin(), Order.end(), [&](std::size_t Left, std::size_t Right) {
+		return Features[Left] < Features[Right];
+	});
+
+	// Count, then merge each row's existing entries with the new non-zeros.
+	std::vector<std::size_t> Offsets(NumRows + 1, 0);
+	for (std::size_t Row = 0; Row < NumRows; Row++) {
+		std::size_t Count = RowOffsets[Row + 1] - RowOffsets[Row];
+		for (const FeatureColumn* Column : Columns) {
+			Count += (Column->Get(Row) != 0.0) ? 1 : 0;
+		}
+		Offsets[Row + 1] = Offsets[Row] + Count;
+	}
+
+	std::vector<std::uint32_t> MergedFeatures(Offsets[NumRows]);
+	std::vector<double> MergedValues(Offsets[NumRows]);
+	for (std::size_t Row = 0; Row < NumRows; Row++) {
+		std::size_t Old = RowOffsets[Row];
+		std::size_t Out = Offsets[Row];
+		for (std::size_t Next : Order) {
+			const double Value = Columns[Next]->Get(Row);
+			if (Value == 0.0) {
+				continue;
+			}
+			for (; Old < RowOffsets[Row + 1] && FeatureIds[Old] < Features[Next]; Old++, Out++) {
+				MergedFeatures[Out] = FeatureIds[Old];
+				MergedValues[Out] = Values[Old];
+			}
+			MergedFeatures[Out] = Features[Next];
+			MergedValues[Out] = Value;
+			Out++;
+		}
+		for (; Old < RowOffsets[Row + 1]; Old++, Out++) {
+			MergedFeatures[Out] = FeatureIds[Old];
+			MergedValues[Out] = Values[Old];
+		}
+	}
+
+	RowOffsets = std::move(Offsets);
+	FeatureIds = std::move(MergedFeatures);
+	Values = std::move(MergedValues);
+}
+
+
+std::vector<double> SparseFeatureBlock::RemoveFeature(std::uint32_t Feature)
+{
+	const std::size_t NumRows = GetNumRows();
+	std::vector<double> Dense(NumRows, 0.0);
+
+	std::size_t Out = 0;
+	for (std::size_t Row = 0; Row < NumRows; Row++) {
+		const std::size_t Begin = RowOffsets[Row];
+		const std::size_t End = RowOffsets[Row + 1];
+		RowOffsets[Row] = Out;
+		for (std::size_t Entry = Begin; Entry < End; Entry++) {
+			if (FeatureIds[Entry] == Feature) {
+				Dense[Row] = Values[Entry];
+				continue;
+			}
+			FeatureIds[Out] = FeatureIds[Entry];
+			Values[Out] = Values[Entry];
+			Out++;
+		}
+	}
+	RowOffsets[NumRows] = Out;
+	FeatureIds.resize(Out);
+	Values.resize(Out);
+	return Dense;
+}
+
+
+void SparseFeatureBlock::ScaleFeatures(const std::vector<double>& Factors)
+{
+	for (std::size_t Entry = 0; Entry < Values.size(); Entry++) {
+		Values[Entry] *= Factors[FeatureIds[Entry]];
+	}
+}
+
+
+/*============================================================================*/
+// TRAINING SET
+/*============================================================================*/
+
+TrainingSet::TrainingSet(std::vector<GeneralisedFeature> InFeatures, std::string InOutputName)
+	: Features(std::move(InFeatures)),
+	  OutputName(std::move(InOutputName))
+{
+	for (const GeneralisedFeature& Feature : Features) {
+		const bool bSparse = Feature.GetDataType() == GeneralisedFeature::DataType::Sparse;
+		Columns.emplace_back(bSparse ? GeneralisedFeature::DataType::Float64 : Feature.GetDataType());
+	}
+	MoveToSparse(GetSparseFeatures());
+}
+
+
+TrainingSet::TrainingSet(std::vector<GeneralisedFeature> InFeatures, std::vector<std::vector<double>> InColumns,
+                         std::vector<double> InOutputs, std::string InOutputName)
+	: Features(std::move(InFeatures)),
+	  Outputs(std::move(InOutputs)),
+	  OutputName(std::move(InOutputName))
+{
+	if (InColumns.size() != Features.size()) {
+		throw std::invalid_argument("TrainingSet: one column is required per feature");
+	}
+	for (std::size_t Feature = 0; Feature < Features.size(); Feature++) {
+		if (InColumns[Feature].size() != Outputs.size()) {
+			throw std::invalid_argument("TrainingSet: every column needs one value per output");
+		}
+		const bool bSparse = Features[Feature].GetDataType() == GeneralisedFeature::DataType::Sparse;
+		Columns.emplace_back(bSparse ? GeneralisedFeature::DataType::Float64 : Features[Feature].GetDataType());
+		Columns.back().Resize(Outputs.size());
+		for (std::size_t Row = 0; Row < Outputs.size(); Row++) {
+			Columns.back().Set(Row, InColumns[Feature][Row]);
+		}
+	}
+	MoveToSparse(GetSparseFeatures());
+}
+
+
+std::vector<std::uint32_t> TrainingSet::GetSparseFeatures() const
+{
+	std::vector<std::uint32_t> SparseFeatures;
+	for (std::size_t Feature = 0; Feature < Features.size(); Feature++) {
+		if (Features[Feature].GetDataType() == GeneralisedFeature::DataType::Sparse) {
+			SparseFeatures.push_back(static_cast<std::uint32_t>(Feature));
+		}
+	}
+	return SparseFeatures;
+}
+
+
+void TrainingSet::MoveToSparse(const std::vector<std::uint32_t>& SparseFeatures)
+{
+	if (SparseFeatures.empty()) {
+		return;
+	}
+	std::vector<const FeatureColumn*> Sources;
+	for (std::uint32_t Feature : SparseFeatures) {
+		Sources.push_back(&Columns[Feature]);
+	}
+	Sparse.InsertFeatures(SparseFeatures, Sources, GetNumExamples());
+
+	for (std::uint32_t Feature : SparseFeatures) {
+		Columns[Feature] = FeatureColumn(GeneralisedFeature::DataType::Sparse);
+		Features[Feature].SetDataType(GeneralisedFeature::DataType::Sparse);
+	}
+}
+
+
+TrainingSet TrainingSet::LoadCsv(const std::string& Path, GeneralisedFeature::DataType StorageType,
+                                 std::uint64_t* EndOffset)
+{
+	LEARNSCRAPE_SCOPED_TIMER(CoreUtilities::ReportPhase::Ingest);
+
+	std::ifstream File(Path, std::ios::binary);
+	if (!File) {
+		throw std::runtime_error("TrainingSet: cannot open " + Path);
+	}
+	std::stringstream Buffer;
+	Buffer << File.rdbuf();
+	std::string Text = Buffer.str();
+
+	// When following the file, stop at the last newline: a final line
+	// without one may still be mid-write, and AppendCsv picks it up once
+	// it is complete.
+	if (EndOffset) {
+		const std::size_t Complete = Text.rfind('\n');
+		if (Complete == std::string::npos) {
+			throw std::runtime_error("TrainingSet: " + Path + " has no complete header line");
+		}
+		Text.resize(Complete + 1);
+	}
+
+	// Header
+	const std::size_t HeaderEnd = std::min(Text.find('\n'), Text.size());
+	const std::vector<std::string> HeaderCells = SplitHeader(Text.substr(0, HeaderEnd));
+	if (HeaderCells.size() < 2) {
+		throw std::runtime_error("TrainingSet: " + Path + " needs at least one feature and one output column");
+	}
+
+	// Sparse columns are chosen once the values are known.
+	const bool bSparse = StorageType == GeneralisedFeature::DataType::Sparse;
+	std::vector<GeneralisedFeature> Features;
+	for (std::size_t Cell = 0; Cell + 1 < HeaderCells.size(); Cell++) {
+		Features.push_back(ParseHeaderCell(HeaderCells[Cell]));
+		Features.back().SetDataType(bSparse ? GeneralisedFeature::DataType::Float64 : StorageType);
+	}
+	TrainingSet Set(std::move(Features), Trim(HeaderCells.back()));
+
+	// Locate every non-blank data line so rows can be parsed independently.
+	std::vector<std::size_t> LineStarts;
+	for (std::size_t Start = HeaderEnd + 1; Start < Text.size();) {
+		const char* Newline = static_cast<const char*>(std::memchr(Text.data() + Start, '\n', Text.size() - Start));
+		const std::size_t End = Newline ? static_cast<std::size_t>(Newline - Text.data()) : Text.size();
+		if (!IsBlank(Text.data() + Start, Text.data() + End)) {
+			LineStarts.push_back(Start);
+		}
+		Start = End + 1;
+	}
+
+	const std::size_t NumFeatures = Set.GetNumFeatures();
+	const std::size_t NumRows = LineStarts.size();
+	for (FeatureColumn& Column : Set.Columns) {
+		Column.Resize(NumRows);
+	}
+	Set.Outputs.resize(NumRows);
+
+	const char* const TextEnd = Text.data() + Text.size();
+	CoreUtilities::TaskScheduler::Get().ParallelFor(0, NumRows, CsvGrainSize,
+		[&](std::size_t Begin, std::size_t End) {
+			std::vector<double> Values(NumFeatures + 1);
+			for (std::size_t Row = Begin; Row < End; Row++) {
+				const std::string Problem = ParseCsvRow(Text.data() + LineStarts[Row], TextEnd, NumFeatures + 1, Values.data());
+				if (!Problem.empty()) {
+					throw std::runtime_error("TrainingSet: " + Path + " row " + std::to_string(Row + 2) + " " + Problem);
+				}
+				for (std::size_t Column = 0; Column < NumFeatures; Column++) {
+					Set.Columns[Column].Set(Row, Values[Column]);
+				}
+				Set.Outputs[Row] = Values[NumFeatures];
+			}
+		});
+
+	if (bSparse) {
+		Set.SparsifyColumns(0.5);
+	}
+	if (EndOffset) {
+		*EndOffset = Text.size();
+	}
+
+	LEARNSCRAPE_RECORD_VOLUME(CoreUtilities::ReportPhase::Ingest, NumRows, Text.size());
+	return Set;
+}
+
+
+std::size_t TrainingSet::AppendCsv(const std::string& Path, std::uint64_t& Offset)
+{
+	LEARNSCRAPE_SCOPED_TIMER(CoreUtilities::ReportPhase::Ingest);
+
+	std::ifstream File(Path, std::ios::binary | std::ios::ate);
+	if (!File) {
+		throw std::runtime_error("TrainingSet: cannot open " + Path);
+	}
+	const std::uint64_t Size = static_cast<std::uint64_t>(File.tellg());
+	if (Size < Offset) {
+		throw std::runtime_error("TrainingSet: " + Path + " is shorter than the ingested offset; it was rewritten");
+	}
+	std::string Text(static_cast<std::size_t>(Size - Offset), '\0');
+	File.seekg(static_cast<std::streamoff>(Offset));
+	File.read(&Text[0], static_cast<std::streamsize>(Text.size()));
+
+	// Only whole lines are consumed; a row still being written waits for the
+	// next call.
+	const std::size_t Complete = Text.rfind('\n');
+	if (Complete == std::string::npos) {
+		return 0;
+	}
+	Text.resize(Complete + 1);
+
+	std::size_t Start = 0;
+	if (Offset == 0) {
+		const std::size_t HeaderEnd = Text.find('\n');
+		const std::vector<std::string> HeaderCells = SplitHeader(Text.substr(0, HeaderEnd));
+		bool bMatches = HeaderCells.size() == Features.size() + 1 && Trim(HeaderCells.back()) == OutputName;
+		for (std::size_t Feature = 0; bMatches && Feature < Features.size(); Feature++) {
+			bMatches = ParseHeaderCell(HeaderCells[Feature]).GetVariableName() == Features[Feature].GetVariableName();
+		}
+		if (!bMatches) {
+			throw std::runtime_error("TrainingSet: " + Path + " header does not match the set's columns");
+		}
+		Start = HeaderEnd + 1;
+	}
+
+	const std::size_t NumFeatures = Features.size();
+	std::vector<double> Values(NumFeatures + 1);
+	std::size_t NumAppended = 0;
+	std::string Error;
+	while (Start < Text.size()) {
+		const std::size_t End = Text.find('\n', Start);
+		if (!IsBlank(Text.data() + Start, Text.data() + End)) {
+			const std::string Problem = ParseCsvRow(Text.data() + Start, Text.data() + Text.size(), NumFeatures + 1, Values.data());
+			if (!Problem.empty()) {
+				// The rows above are already in the set; consume up to and
+				// including this one so a retry neither repeats nor sticks.
+				Error = "TrainingSet: " + Path + " row at byte " + std::to_string(Offset + Start) + " " + Problem;
+				Start = End + 1;
+				break;
+			}
+			for (std::size_t Feature = 0; Feature < NumFeatures; Feature++) {
+				Values[Feature] = Features[Feature].Scale(Values[Feature]);
+			}
+			AddExample(Values.data(), Values[NumFeatures]);
+			NumAppended++;
+		}
+		Start = End + 1;
+	}
+
+	Offset += Start;
+	LEARNSCRAPE_RECORD_VOLUME(CoreUtilities::ReportPhase::Ingest, NumAppended, Start);
+	if (!Error.empty()) {
+		throw std::runtime_error(Error);
+	}
+	return NumAppended;
+}
+
+
+void TrainingSet::WriteCsv(const std::string& Path) const
+{
+	std::ofstream File(Path, std::ios::binary);
+	if (!File) {
+		throw std::runtime_error("TrainingSet: cannot write " + Path);
+	}
+	for (const GeneralisedFeature& Feature : Features) {
+		File << Feature.GetVariableName();
+		if (!Feature.GetStandardUnit().empty()) {
+			File << " [" << Feature.GetStandardUnit() << "]";
+		}
+		File << ',';
+	}
+	File << OutputName << '\n';
+
+	char Number[32];
+	for (std::size_t Row = 0; Row < GetNumExamples(); Row++) {
+		for (std::size_t Feature = 0; Feature < Features.size(); Feature++) {
+			std::snprintf(Number, sizeof(Number), "%.17g,", GetValue(Feature, Row));
+			File << Number;
+		}
+		std::snprintf(Number, sizeof(Number), "%.17g\n", Outputs[Row]);
+		File << Number;
+	}
+	if (!File) {
+		throw std::runtime_error("TrainingSet: failed writing " + Path);
+	}
+}
+
+
+double TrainingSet::GetValue(std::size_t Feature, std::size_t Row) const
+{
+	return Columns[Feature].IsSparse() ? Sparse.Get(Row, Feature) : Columns[Feature].Get(Row);
+}
+
+
+void TrainingSet::AddExample(const double* Inputs, double Output)
+{
+	for (std::size_t Feature = 0; Feature < Features.size(); Feature++) {
+		Columns[Feature].PushBack(Inputs[Feature]);
+	}
+	if (HasSparseFeatures()) {
+		Sparse.AppendRow(Inputs, GetSparseFeatures());
+	}
+	Outputs.push_back(Output);
+}
+
+
+void TrainingSet::Reserve(std::size_t NumExamples)
+{
+	for (FeatureColumn& Column : Columns) {
+		Column.Reserve(NumExamples);
+	}
+	if (HasSparseFeatures()) {
+		Sparse.Reserve(NumExamples);
+	}
+	Outputs.reserve(NumExamples);
+}
+
+
+void TrainingSet::SetStorageType(std::size_t Feature, GeneralisedFeature::DataType Type)
+{
+	const bool bWasSparse = Columns[Feature].IsSparse();
+	const bool bToSparse = Type == GeneralisedFeature::DataType::Sparse;
+
+	if (bToSparse && !bWasSparse) {
+		MoveToSparse({static_cast<std::uint32_t>(Feature)});
+		return;
+	}
+	if (bWasSparse && !bToSparse) {
+		const std::vector<double> Dense = Sparse.RemoveFeature(static_cast<std::uint32_t>(Feature));
+		Columns[Feature] = FeatureColumn(Type);
+		Columns[Feature].Resize(Dense.size());
+		for (std::size_t Row = 0; Row < Dense.size(); Row++) {
+			Columns[Feature].Set(Row, Dense[Row]);
+		}
+		Features[Feature].SetDataType(Type);
+		if (GetSparseFeatures().empty()) {
+			Sparse = SparseFeatureBlock();
+		}
+		return;
+	}
+	if (!bWasSparse) {
+		Columns[Feature].Convert(Type);
+		Features[Feature].SetDataType(Type);
+	}
+}
+
+
+std::size_t TrainingSet::SparsifyColumns(double MinZeroFraction)
+{
+	const std::size_t NumRows = GetNumExamples();
+	std::vector<std::uint32_t> Selected;
+
+	for (std::size_t Feature = 0; Feature < Features.size(); Feature++) {
+		if (Columns[Feature].IsSparse()) {
+			continue;
+		}
+		const std::size_t Zeros = Columns[Feature].Visit([NumRows](const auto* Values) {
+			std::size_t Count = 0;
+			for (std::size_t Row = 0; Row < NumRows; Row++) {
+				Count += (Widen(Values[Row]) == 0.0) ? 1 : 0;
+			}
+			return Count;
+		});
+		if (NumRows > 0 && static_cast<double>(Zeros) >= MinZeroFraction * static_cast<double>(NumRows)) {
+			Selected.push_back(static_cast<std::uint32_t>(Feature));
+		}
+	}
+	MoveToSparse(Selected);
+	return Selected.size();
+}
+
+
+std::size_t TrainingSet::GetStorageBytes() const
+{
+	std::size_t Bytes = Outputs.size() * sizeof(double) + Sparse.GetStorageBytes();
+	for (std::size_t Feature = 0; Feature < Features.size(); Feature++) {
+		Bytes += Columns[Feature].GetSize() * GeneralisedFeature::GetBytesPerValue(Columns[Feature].GetType());
+	}
+	return Bytes;
+}
+
+
+std::size_t TrainingSet::GetBytesPerExample() const
+{
+	std::size_t Bytes = sizeof(double);
+	for (const FeatureColumn& Column : Columns) {
+		Bytes += Column.IsSparse() ? 0 : GeneralisedFeature::GetBytesPerValue(Column.GetType());
+	}
+	if (HasSparseFeatures() && GetNumExamples() > 0) {
+		Bytes += Sparse.GetStorageBytes() / GetNumExamples();
+	}
+	return Bytes;
+}
+
+
+void TrainingSet::Standardise()
+{
+	const std::size_t NumRows = GetNumExamples();
+	if (NumRows == 0) {
+		return;
+	}
+
+	// Statistics are taken from the stored values and accumulated in double;
+	// the standardised values are rounded back into the column's type.
+	CoreUtilities::TaskScheduler::Get().ParallelFor(0, Features.size(), 1,
+		[&](std::size_t Begin, std::size_t End) {
+			for (std::size_t Feature = Begin; Feature < End; Feature++) {
+				FeatureColumn& Column = Columns[Feature];
+				if (Column.IsSparse()) {
+					continue;
+				}
+
+				const double Mean = Column.Visit([NumRows](const auto* Values) {
+					double Sum = 0.0;
+					for (std::size_t Row = 0; Row < NumRows; Row++) {
+						Sum += Widen(Values[Row]);
+					}
+					return Sum / NumRows;
+				});
+				const double SumSquares = Column.Visit([NumRows, Mean](const auto* Values) {
+					double Sum = 0.0;
+					for (std::size_t Row = 0; Row < NumRows; Row++) {
+						const double Difference = Widen(Values[Row]) - Mean;
+						Sum += Difference * Difference;
+					}
+					return Sum;
+				});
+				Features[Feature].SetScaling(Mean, std::sqrt(SumSquares / NumRows));
+
+				const GeneralisedFeature& Scaling = Features[Feature];
+				for (std::size_t Row = 0; Row < NumRows; Row++) {
+					Column.Set(Row, Scaling.Scale(Column.Get(Row)));
+				}
+			}
+		});
+
+	if (!HasSparseFeatures()) {
+		return;
+	}
+	// Sparse features: moments over the stored non-zeros (the rest are zero).
+	std::vector<double> Sums(Features.size(), 0.0);
+	std::vector<double> SumSquares(Features.size(), 0.0);
+	const std::uint32_t* SparseIds = Sparse.GetFeatureIds();
+	const double* SparseValues = Sparse.GetValues();
+	for (std::size_t Entry = 0; Entry < Sparse.GetNumNonZeros(); Entry++) {
+		Sums[SparseIds[Entry]] += SparseValues[Entry];
+		SumSquares[SparseIds[Entry]] += SparseValues[Entry] * SparseValues[Entry];
+	}
+
+	std::vector<double> Factors(Features.size(), 1.0);
+	for (std::uint32_t Feature : GetSparseFeatures()) {
+		const double Mean = Sums[Feature] / NumRows;
+		const double Variance = std::max(0.0, SumSquares[Feature] / NumRows - Mean * Mean);
+		Features[Feature].SetScaling(0.0, std::sqrt(Variance));
+		Factors[Feature] = 1.0 / Features[Feature].GetScalingDeviation();
+	}
+	Sparse.ScaleFeatures(Factors);
+}
+
+
+void TrainingSet::Standardise(const std::vector<double>& Means, const std::vector<double>& Deviations)
+{
+	if (Means.size() != Features.size() || Deviations.size() != Features.size()) {
+		throw std::invalid_argument("TrainingSet::Standardise: need one mean and one deviation per feature");
+	}
+	const std::size_t NumRows = GetNumExamples();
+	std::vector<double> Factors(Features.size(), 1.0);
+
+	CoreUtilities::TaskScheduler::Get().ParallelFor(0, Features.size(), 1,
+		[&](std::size_t Begin, std::size_t End) {
+			for (std::size_t Feature = Begin; Feature < End; Feature++) {
+				FeatureColumn& Column = Columns[Feature];
+				if (Column.IsSparse()) {
+					Features[Feature].SetScaling(0.0, Deviations[Feature]);
+					Factors[Feature] = 1.0 / Features[Feature].GetScalingDeviation();
+					continue;
+				}
+				Features[Feature].SetScaling(Means[Feature], Deviations[Feature]);
+				const GeneralisedFeature& Scaling = Features[Feature];
+				for (std::size_t Row = 0; Row < NumRows; Row++) {
+					Column.Set(Row, Scaling.Scale(Column.Get(Row)));
+				}
+			}
+		});
+
+	if (HasSparseFeatures()) {
+		Sparse.ScaleFeatures(Factors);
+	}
+}
+
+
+/*============================================================================*/
+// TRAINING VIEW
+/*============================================================================*/
+
+TrainingView::TrainingView(const TrainingSet& InSet)
+	: Set(&InSet), Rows(nullptr), NumRows(InSet.GetNumExamples())
+{
+}
+
+
+TrainingView::TrainingView(const TrainingSet& InSet, const std::vector<std::size_t>& InRows)
+	: Set(&InSet), Rows(InRows.data()), NumRows(InRows.size())
+{
+}
+
+
+TrainingView::TrainingView(const TrainingSet& InSet, const std::size_t* InRows, std::size_t InNumRows)
+	: Set(&InSet), Rows(InRows), NumRows(InNumRows)
+{
+}
+
+
+void TrainingView::GatherColumn(std::size_t Feature, std::size_t Begin, std::size_t End, double* Out) const
+{
+	if (Set->GetColumn(Feature).IsSparse()) {
+		for (std::size_t Position = Begin; Position < End; Position++) {
+			Out[Position - Begin] = Set->GetSparseBlock().Get(GetRow(Position), Feature);
+		}
+		return;
+	}
+	Set->GetColumn(Feature).Visit([&](const auto* Values) {
+		if (!Rows) {
+			for (std::size_t Position = Begin; Position < End; Position++) {
+				Out[Position - Begin] = Widen(Values[Position]);
+			}
+			return;
+		}
+		for (std::size_t Position = Begin; Position < End; Position++) {
+			Out[Position - Begin] = Widen(Values[Rows[Position]]);
+		}
+	});
+}
+
+
+void TrainingView::GatherOutputs(std::size_t Begin, std::size_t End, double* Out) const
+{
+	const double* Outputs = Set->GetOutputs();
+	if (!Rows) {
+		std::copy(Outputs + Begin, Outputs + End, Out);
+		return;
+	}
+	for (std::size_t Position = Begin; Position < End; Position++) {
+		Out[Position - Begin] = Outputs[Rows[Position]];
+	}
+}
+
+
+std::vector<std::size_t> RowRange(std::size_t Begin, std::size_t End)
+{
+	std::vector<std::size_t> Rows(End - Begin);
+	std::iota(Rows.begin(), Rows.end(), Begin);
+	return Rows;
+}
+
+
+void SplitHoldout(std::size_t NumExamples, double ValidationFraction, unsigned Seed,
+                  std::vector<std::size_t>& TrainRows, std::vector<std::size_t>& ValidationRows)
+{
+	std::vector<std::size_t> Order(NumExamples);
+	std::iota(Order.begin(), Order.end(), 0);
+	std::shuffle(Order.begin(), Order.end(), std::mt19937(Seed));
+
+	const std::size_t NumValidation = static_cast<std::size_t>(ValidationFraction * NumExamples);
+	ValidationRows.assign(Order.begin(), Order.begin() + NumValidation);
+	TrainRows.assign(Order.begin() + NumValidation, Order.end());
+
+	std::sort(ValidationRows.begin(), ValidationRows.end());
+	std::sort(TrainRows.begin(), TrainRows.end());
+}
+
+} // namespace ModelRepresentation
@@ -0,0 +1,275 @@
+#ifndef __TrainingSet__
+#define __TrainingSet__
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "MachineLearning/ModelRepresentation/BFloat16.h"
+#include "MachineLearning/ModelRepresentation/GeneralisedFeature.h"
+
+/* TRAINING SET */
+// Column-major store of m examples over n features plus one output column.
+// Each feature column is contiguous so the kernels stream one feature at a
+// time over a block of rows. A TrainingSet is built once, standardised once
+// and then shared read-only between every model trained on it; subsets of
+// rows are addressed through TrainingView rather than copied. Feature
+// columns may be held in float32 or bfloat16 (see GeneralisedFeature::
+// DataType) to cut the bytes streamed per pass; outputs stay double.
+// Mostly-zero features (elemental fractions, one-hot fields) may instead be
+// held as Sparse, in one CSR block shared by all such features; kernels
+// make a dense pass over the other columns and then walk each row's
+// non-zeros.
+
+namespace ModelRepresentation {
+
+// Number of rows the kernels process per block; sized so a block of
+// hypotheses, outputs and residuals stays resident in L1.
+const std::size_t KernelBlockSize = 256;
+
+
+// Storage for one feature column in its GeneralisedFeature::DataType. Only
+// the vector matching the type is populated. Kernels call Visit() with a
+// generic lambda, which is instantiated once per element type and reads
+// the values through Widen(). A Sparse column is an empty placeholder (its
+// values are in the SparseFeatureBlock); kernels must skip it rather than
+// Visit it.
+class FeatureColumn {
+private:
+	GeneralisedFeature::DataType Type;
+	std::vector<double> Float64Values;
+	std::vector<float> Float32Values;
+	std::vector<BFloat16> BFloat16Values;
+
+public:
+	explicit FeatureColumn(GeneralisedFeature::DataType InType = GeneralisedFeature::DataType::Float64);
+
+	GeneralisedFeature::DataType GetType() const { return Type; }
+	bool IsSparse() const { return Type == GeneralisedFeature::DataType::Sparse; }
+	std::size_t GetSize() const;
+
+	double Get(std::size_t Row) const;
+	void Set(std::size_t Row, double Value);
+	void PushBack(double Value);
+	void Resize(std::size_t Size);
+	void Reserve(std::size_t Size);
+
+	// Re-encode the stored values (rounding when narrowing).
+	void Convert(GeneralisedFeature::DataType NewType);
+
+	template <typename BodyType>
+	decltype(auto) Visit(BodyType&& Body) const
+	{
+		switch (Type) {
+		case GeneralisedFeature::DataType::Float32:
+			return Body(Float32Values.data());
+		case GeneralisedFeature::DataType::BFloat16:
+			return Body(BFloat16Values.data());
+		default:
+			return Body(Float64Values.data());
+		}
+	}
+
+	// Typed values for kernels that have already checked GetType().
+	template <typename ElementType>
+	const ElementType* GetData() const;
+};
+
+template <>
+inline const double* FeatureColumn::GetData<double>() const { return Float64Values.data(); }
+template <>
+inline const float* FeatureColumn::GetData<float>() const { return Float32Values.data(); }
+template <>
+inline const BFloat16* FeatureColumn::GetData<BFloat16>() const { return BFloat16Values.data(); }
+
+
+// Compressed sparse rows over the set's Sparse features. The non-zeros of
+// row r are (FeatureIds[k], Values[k]) for k in [RowOffsets[r],
+// RowOffsets[r + 1]), in ascending feature order. Column indices are feature
+// ids of the owning TrainingSet, so theta[FeatureIds[k] + 1] weights
+// Values[k] without any remapping. An empty block has no rows at all.
+class SparseFeatureBlock {
+private:
+	std::vector<std::size_t> RowOffsets;
+	std::vector<std::uint32_t> FeatureIds;
+	std::vector<double> Values;
+
+public:
+	SparseFeatureBlock() = default;
+
+	bool IsEmpty() const { return RowOffsets.empty(); }
+	std::size_t GetNumRows() const { return RowOffsets.empty() ? 0 : RowOffsets.size() - 1; }
+	std::size_t GetNumNonZeros() const { return Values.size(); }
+	std::size_t GetStorageBytes() const;
+
+	const std::size_t* GetRowOffsets() const { return RowOffsets.data(); }
+	const std::uint32_t* GetFeatureIds() const { return FeatureIds.data(); }
+	const double* GetValues() const { return Values.data(); }
+
+	// Value of Feature in Row; zero when it is not stored.
+	double Get(std::size_t Row, std::size_t Feature) const;
+
+	// Append one row from a dense input vector, keeping the non-zeros of the
+	// listed (ascending) features.
+	void AppendRow(const double* Inputs, const std::vector<std::uint32_t>& SparseFeatures);
+	void Reserve(std::size_t NumRows);
+
+	// Move dense columns (one value per row, NumRows rows) into the block, or
+	// one feature back out. Each call rebuilds the arrays in a single pass.
+	void InsertFeatures(const std::vector<std::uint32_t>& Features, const std::vector<const FeatureColumn*>& Columns,
+	                    std::size_t NumRows);
+	std::vector<double> RemoveFeature(std::uint32_t Feature);
+
+	// Multiply every stored value of feature f by Factors[f].
+	void ScaleFeatures(const std::vector<double>& Factors);
+};
+
+
+class TrainingSet {
+private:
+	std::vector<GeneralisedFeature> Features;
+	std::vector<FeatureColumn> Columns;
+	SparseFeatureBlock Sparse;
+	std::vector<double> Outputs;
+	std::string OutputName;
+
+	std::vector<std::uint32_t> GetSparseFeatures() const;
+	// Move the listed dense columns into the sparse block.
+	void MoveToSparse(const std::vector<std::uint32_t>& SparseFeatures);
+
+public:
+	TrainingSet(std::vector<GeneralisedFeature> InFeatures, std::string InOutputName = "y");
+	TrainingSet(std::vector<GeneralisedFeature> InFeatures, std::vector<std::vector<double>> InColumns,
+	            std::vector<double> InOutputs, std::string InOutputName = "y");
+
+	// Read a CSV file whose header names the columns and whose final column
+	// is the output. A header cell "Density [g/cm^3]" yields the unit
+	// "g/cm^3". Rows are parsed in parallel and every feature is stored as
+	// StorageType, except that Sparse stores the columns that are at least
+	// half zeros sparsely and the rest as Float64. Throws std::runtime_error
+	// on malformed input. EndOffset, if given, receives the offset just past
+	// the last complete line, for a later AppendCsv; a trailing line with
+	// no newline yet is then left unread.
+	static TrainingSet LoadCsv(const std::string& Path,
+	                           GeneralisedFeature::DataType StorageType = GeneralisedFeature::DataType::Float64,
+	                           std::uint64_t* EndOffset = nullptr);
+
+	// Append the complete rows an append-only CSV gained past byte Offset
+	// and advance Offset over them; a trailing partial row is left for the
+	// next call. At Offset 0 the header is checked against the set's
+	// columns. Values are mapped through each feature's recorded scaling so
+	// they land in the same space as a standardised set. Returns the number
+	// of rows appended. A malformed row throws std::runtime_error. The rows
+	// before it stay appended, and Offset moves past the bad row, so the
+	// next call resumes after it without adding anything twice.
+	std::size_t AppendCsv(const std::string& Path, std::uint64_t& Offset);
+
+	// Write the set in the layout LoadCsv reads, values as currently stored
+	// and printed to round-trip exactly. Throws std::runtime_error if Path
+	// cannot be written.
+	void WriteCsv(const std::string& Path) const;
+
+	std::size_t GetNumExamples() const { return Outputs.size(); }
+	std::size_t GetNumFeatures() const { return Features.size(); }
+
+	const GeneralisedFeature& GetFeature(std::size_t Feature) const { return Features[Feature]; }
+	const std::vector<GeneralisedFeature>& GetFeatures() const { return Features; }
+	const std::string& GetOutputName() const { return OutputName; }
+
+	const FeatureColumn& GetColumn(std::size_t Feature) const { return Columns[Feature]; }
+	const SparseFeatureBlock& GetSparseBlock() const { return Sparse; }
+	bool HasSparseFeatures() const { return !Sparse.IsEmpty(); }
+	double GetValue(std::size_t Feature, std::size_t Row) const;
+	const double* GetOutputs() const { return Outputs.data(); }
+
+	// Change how one feature column is stored; moves it into or out of the
+	// sparse block when Sparse is involved.
+	void SetStorageType(std::size_t Feature, GeneralisedFeature::DataType Type);
+
+	// Store every dense column with at least MinZeroFraction zeros as
+	// Sparse; returns how many columns moved.
+	std::size_t SparsifyColumns(double MinZeroFraction);
+
+	// Bytes held by the feature columns and outputs.
+	std::size_t GetStorageBytes() const;
+	// Bytes one example occupies across the feature columns and output
+	// (sparse features counted at their average non-zeros per row).
+	std::size_t GetBytesPerExample() const;
+
+	// Append one example; Inputs holds GetNumFeatures() raw values.
+	void AddExample(const double* Inputs, double Output);
+	void Reserve(std::size_t NumExamples);
+
+	// Compute each feature's mean / standard deviation, store them on the
+	// GeneralisedFeature and standardise the columns in place. Sparse
+	// features are divided by their deviation but not centred, so their
+	// zeros stay implicit; their recorded mean is 0.
+	void Standardise();
+	// Standardise with statistics computed elsewhere, e.g. over every shard of
+	// a data set split across processes. Takes one mean and one deviation per
+	// feature; sparse features ignore their mean, as above.
+	void Standardise(const std::vector<double>& Means, const std::vector<double>& Deviations);
+};
+
+
+// A read-only selection of rows of a TrainingSet. Position i of the view
+// maps to row GetRow(i) of the set; a view without an index list covers
+// every row in order.
+class TrainingView {
+private:
+	const TrainingSet* Set;
+	const std::size_t* Rows;
+	std::size_t NumRows;
+
+public:
+	explicit TrainingView(const TrainingSet& InSet);
+	TrainingView(const TrainingSet& InSet, const std::vector<std::size_t>& InRows);
+	TrainingView(const TrainingSet& InSet, const std::size_t* InRows, std::size_t InNumRows);
+
+	const TrainingSet& GetSet() const { return *Set; }
+	std::size_t GetNumExamples() const { return NumRows; }
+	std::size_t GetNumFeatures() const { return Set->GetNumFeatures(); }
+
+	bool IsIdentity() const { return Rows == nullptr; }
+	const std::size_t* GetRows() const { return Rows; }
+	std::size_t GetRow(std::size_t Position) const { return Rows ? Rows[Position] : Position; }
+
+	// Copy feature (or output) values for positions [Begin, End) into Out.
+	void GatherColumn(std::size_t Feature, std::size_t Begin, std::size_t End, double* Out) const;
+	void GatherOutputs(std::size_t Begin, std::size_t End, double* Out) const;
+
+	// Call Body(Index, Feature, Value) for every stored non-zero of the
+	// sparse features at positions [Begin, End), with Index = Position - Begin.
+	template <typename BodyType>
+	void VisitSparse(std::size_t Begin, std::size_t End, BodyType&& Body) const
+	{
+		const SparseFeatureBlock& Block = Set->GetSparseBlock();
+		if (Block.GetNumNonZeros() == 0) {
+			return;
+		}
+		const std::size_t* Offsets = Block.GetRowOffsets();
+		const std::uint32_t* Features = Block.GetFeatureIds();
+		const double* Values = Block.GetValues();
+
+		for (std::size_t Position = Begin; Position < End; Position++) {
+			const std::size_t Row = GetRow(Position);
+			for (std::size_t Entry = Offsets[Row]; Entry < Offsets[Row + 1]; Entry++) {
+				Body(Position - Begin, Features[Entry], Values[Entry]);
+			}
+		}
+	}
+};
+
+
+// The positions Begin..End-1, for a view over rows appended since Begin.
+std::vector<std::size_t> RowRange(std::size_t Begin, std::size_t End);
+
+// Shuffle 0..NumExamples-1 with Seed and split off ValidationFraction of the
+// rows. Both index lists are returned sorted so views stream in row order.
+void SplitHoldout(std::size_t NumExamples, double ValidationFraction, unsigned Seed,
+                  std::vector<std::size_t>& TrainRows, std::vector<std::size_t>& ValidationRows);
+
+} // namespace ModelRepresentation
+
+#endif // __TrainingSet__
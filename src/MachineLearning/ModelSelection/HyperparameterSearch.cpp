@@ -0,0 +1,156 @@
+#include "MachineLearning/ModelSelection/HyperparameterSearch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <utility>
+
+#include "CoreUtilities/TaskScheduler.h"
+
+namespace ModelSelection {
+
+using ModelRepresentation::LearningModel;
+using ModelRepresentation::TrainingView;
+
+namespace {
+
+struct Candidate {
+	std::unique_ptr<LearningModel> Model;
+	SearchResult Result;
+};
+
+
+// Diverged models report NaN; rank them behind everything finite.
+double RankingLoss(double Loss)
+{
+	return std::isnan(Loss) ? std::numeric_limits<double>::infinity() : Loss;
+}
+
+} // namespace
+
+
+std::vector<Hyperparameters> GridCandidates(const std::map<std::string, std::vector<double>>& Grid)
+{
+	std::vector<Hyperparameters> Candidates(1);
+
+	for (const auto& Axis : Grid) {
+		std::vector<Hyperparameters> Expanded;
+		for (const Hyperparameters& Partial : Candidates) {
+			for (double Value : Axis.second) {
+				Hyperparameters Next = Partial;
+				Next[Axis.first] = Value;
+				Expanded.push_back(std::move(Next));
+			}
+		}
+		Candidates = std::move(Expanded);
+	}
+	return Candidates;
+}
+
+
+std::vector<Hyperparameters> RandomCandidates(const std::map<std::string, SearchRange>& Ranges,
+                                              std::size_t Count, unsigned Seed)
+{
+	std::mt19937 Generator(Seed);
+	std::uniform_real_distribution<double> Unit(0.0, 1.0);
+	std::vector<Hyperparameters> Candidates(Count);
+
+	for (Hyperparameters& Candidate : Candidates) {
+		for (const auto& Range : Ranges) {
+			const SearchRange& Bounds = Range.second;
+			const double Draw = Unit(Generator);
+			Candidate[Range.first] = Bounds.bLogScale
+				? std::exp(std::log(Bounds.Lower) + Draw * (std::log(Bounds.Upper) - std::log(Bounds.Lower)))
+				: Bounds.Lower + Draw * (Bounds.Upper - Bounds.Lower);
+		}
+	}
+	return Candidates;
+}
+
+
+HyperparameterSearch::HyperparameterSearch(ModelFactory InFactory, SearchOptions InOptions)
+	: Factory(std::move(InFactory)), Options(InOptions)
+{
+}
+
+
+std::vector<SearchResult> HyperparameterSearch::Run(const std::vector<Hyperparameters>& Candidates,
+                                                    const TrainingView& Training,
+                                                    const TrainingView& Validation) const
+{
+	if (Options.Budget == 0) {
+		throw std::invalid_argument("HyperparameterSearch: need Budget > 0");
+	}
+	// Otherwise a rung never shrinks the field (factor <= 1) or never grows
+	// its budget (zero minimum), and the halving loop does not end.
+	if (Options.bSuccessiveHalving &&
+	    (!(Options.ReductionFactor > 1.0) || Options.MinimumBudget == 0 || Options.MinimumBudget > Options.Budget)) {
+		throw std::invalid_argument("HyperparameterSearch: halving needs ReductionFactor > 1 and 0 < MinimumBudget <= Budget");
+	}
+	CoreUtilities::TaskScheduler& Scheduler = CoreUtilities::TaskScheduler::Get();
+
+	std::vector<Candidate> Pool(Candidates.size());
+	for (std::size_t Index = 0; Index < Candidates.size(); Index++) {
+		Pool[Index].Model = Factory(Candidates[Index]);
+		Pool[Index].Result = SearchResult{Candidates[Index], Pool[Index].Model->Describe(),
+		                                  std::numeric_limits<double>::infinity(), 0, false};
+	}
+
+	// Survivors are indices into Pool; each rung trains them all in parallel.
+	std::vector<std::size_t> Survivors(Pool.size());
+	for (std::size_t Index = 0; Index < Pool.size(); Index++) {
+		Survivors[Index] = Index;
+	}
+
+	std::size_t RungBudget = Options.bSuccessiveHalving ? Options.MinimumBudget : Options.Budget;
+
+	while (!Survivors.empty()) {
+		Scheduler.ParallelFor(0, Survivors.size(), 1, [&](std::size_t Begin, std::size_t End) {
+			for (std::size_t Slot = Begin; Slot < End; Slot++) {
+				Candidate& Entry = Pool[Survivors[Slot]];
+				const std::size_t Trained = Entry.Model->GetIterationsTrained();
+				if (RungBudget > Trained) {
+					Entry.Model->Train(Training, RungBudget - Trained);
+				}
+				Entry.Result.ValidationLoss = RankingLoss(Entry.Model->ValidationLoss(Validation));
+				Entry.Result.IterationsTrained = Entry.Model->GetIterationsTrained();
+			}
+		});
+
+		if (!Options.bSuccessiveHalving || RungBudget >= Options.Budget || Survivors.size() <= 1) {
+			break;
+		}
+
+		std::stable_sort(Survivors.begin(), Survivors.end(), [&](std::size_t Left, std::size_t Right) {
+			return Pool[Left].Result.ValidationLoss < Pool[Right].Result.ValidationLoss;
+		});
+
+		const std::size_t Keep = std::max<std::size_t>(
+			1, static_cast<std::size_t>(std::ceil(Survivors.size() / Options.ReductionFactor)));
+		for (std::size_t Slot = Keep; Slot < Survivors.size(); Slot++) {
+			Pool[Survivors[Slot]].Result.bTerminatedEarly = true;
+			Pool[Survivors[Slot]].Model.reset();
+		}
+		Survivors.resize(Keep);
+
+		RungBudget = std::min(Options.Budget,
+		                      static_cast<std::size_t>(std::ceil(RungBudget * Options.ReductionFactor)));
+	}
+
+	std::vector<SearchResult> Results;
+	Results.reserve(Pool.size());
+	for (Candidate& Entry : Pool) {
+		Results.push_back(std::move(Entry.Result));
+	}
+	std::stable_sort(Results.begin(), Results.end(), [](const SearchResult& Left, const SearchResult& Right) {
+		if (Left.bTerminatedEarly != Right.bTerminatedEarly) {
+			return !Left.bTerminatedEarly;
+		}
+		return Left.ValidationLoss < Right.ValidationLoss;
+	});
+	return Results;
+}
+
+} // namespace ModelSelection
@@ -0,0 +1,76 @@
+#ifndef __HyperparameterSearch__
+#define __HyperparameterSearch__
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "MachineLearning/ModelRepresentation/LearningModel.h"
+#include "MachineLearning/ModelRepresentation/TrainingSet.h"
+
+/* HYPERPARAMETER SEARCH */
+// Trains many model configurations concurrently against one shared,
+// read-only TrainingSet. Candidates come from a grid or from random
+// sampling; each is built by a ModelFactory (the strategy) and trained as a
+// task on the shared scheduler. With successive halving, every survivor is
+// trained to the current rung budget, scored on the validation rows, and
+// only the best 1/ReductionFactor continue to the next (larger) budget.
+
+namespace ModelSelection {
+
+using Hyperparameters = std::map<std::string, double>;
+using ModelFactory = std::function<std::unique_ptr<ModelRepresentation::LearningModel>(const Hyperparameters&)>;
+
+struct SearchRange {
+	double Lower;
+	double Upper;
+	bool bLogScale;
+};
+
+struct SearchOptions {
+	// Iterations given to each candidate that survives to the end.
+	std::size_t Budget = 500;
+
+	bool bSuccessiveHalving = false;
+	// Budget of the first rung when halving.
+	std::size_t MinimumBudget = 20;
+	double ReductionFactor = 3.0;
+};
+
+struct SearchResult {
+	Hyperparameters Parameters;
+	std::string Description;
+	double ValidationLoss;
+	std::size_t IterationsTrained;
+	bool bTerminatedEarly;
+};
+
+// Cartesian product of the listed values.
+std::vector<Hyperparameters> GridCandidates(const std::map<std::string, std::vector<double>>& Grid);
+
+// Count independent draws, uniform (or log-uniform) within each range.
+std::vector<Hyperparameters> RandomCandidates(const std::map<std::string, SearchRange>& Ranges,
+                                              std::size_t Count, unsigned Seed);
+
+class HyperparameterSearch {
+private:
+	ModelFactory Factory;
+	SearchOptions Options;
+
+public:
+	HyperparameterSearch(ModelFactory InFactory, SearchOptions InOptions);
+
+	// Results ordered best first; candidates dropped by halving come last.
+	// Throws std::invalid_argument unless Budget > 0 and, when halving,
+	// ReductionFactor > 1 and 0 < MinimumBudget <= Budget.
+	std::vector<SearchResult> Run(const std::vector<Hyperparameters>& Candidates,
+	                              const ModelRepresentation::TrainingView& Training,
+	                              const ModelRepresentation::TrainingView& Validation) const;
+};
+
+} // namespace ModelSelection
+
+#endif // __HyperparameterSearch__
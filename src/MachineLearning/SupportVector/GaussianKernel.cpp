@@ -0,0 +1,103 @@
+#include "MachineLearning/SupportVector/GaussianKernel.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "CoreUtilities/ReportGeneration.h"
+#include "CoreUtilities/TaskScheduler.h"
+#include "MachineLearning/ModelRepresentation/FixedKernels.h"
+
+namespace SupportVector {
+
+using ModelRepresentation::KernelBlockSize;
+using ModelRepresentation::TrainingView;
+
+
+double GaussianKernel(const double* X, const double* Z, std::size_t NumFeatures, double Sigma)
+{
+	double SquaredDistance = 0.0;
+	for (std::size_t Feature = 0; Feature < NumFeatures; Feature++) {
+		const double Difference = X[Feature] - Z[Feature];
+		SquaredDistance += Difference * Difference;
+	}
+	return std::exp(-SquaredDistance / (2.0 * Sigma * Sigma));
+}
+
+
+void GaussianKernelRow(const TrainingView& View, const double* Query, double Sigma,
+                       std::size_t Begin, std::size_t End, double* Out)
+{
+	const std::size_t Count = End - Begin;
+	const double Scale = -1.0 / (2.0 * Sigma * Sigma);
+
+	if (const ModelRepresentation::FixedKernelTable* Fixed = ModelRepresentation::FindFixedKernels(View)) {
+		Fixed->SquaredDistances(View, Query, Begin, End, Out);
+		for (std::size_t Index = 0; Index < Count; Index++) {
+			Out[Index] = std::exp(Scale * Out[Index]);
+		}
+		return;
+	}
+
+	const std::size_t* Rows = View.GetRows();
+	const ModelRepresentation::TrainingSet& Set = View.GetSet();
+
+	// Sparse features contribute |q_s|^2 for every row, corrected at the
+	// row's non-zeros by x^2 - 2 x q.
+	double SparseQueryNorm = 0.0;
+	for (std::size_t Feature = 0; Feature < View.GetNumFeatures(); Feature++) {
+		if (Set.GetColumn(Feature).IsSparse()) {
+			SparseQueryNorm += Query[Feature] * Query[Feature];
+		}
+	}
+	std::fill(Out, Out + Count, SparseQueryNorm);
+
+	for (std::size_t Feature = 0; Feature < View.GetNumFeatures(); Feature++) {
+		if (Set.GetColumn(Feature).IsSparse()) {
+			continue;
+		}
+		const double Centre = Query[Feature];
+
+		View.GetSet().GetColumn(Feature).Visit([&](const auto* Column) {
+			for (std::size_t Index = 0; Index < Count; Index++) {
+				const double Value = ModelRepresentation::Widen(Column[Rows ? Rows[Begin + Index] : Begin + Index]);
+				Out[Index] += (Value - Centre) * (Value - Centre);
+			}
+		});
+	}
+
+	View.VisitSparse(Begin, End, [&](std::size_t Index, std::uint32_t Feature, double Value) {
+		Out[Index] += Value * (Value - 2.0 * Query[Feature]);
+	});
+
+	for (std::size_t Index = 0; Index < Count; Index++) {
+		Out[Index] = std::exp(Scale * Out[Index]);
+	}
+}
+
+
+double GaussianKernelSum(const TrainingView& View, const std::vector<double>& Weights,
+                         const double* Query, double Sigma)
+{
+	LEARNSCRAPE_SCOPED_TIMER(CoreUtilities::ReportPhase::KernelRows);
+	LEARNSCRAPE_RECORD_VOLUME(CoreUtilities::ReportPhase::KernelRows, View.GetNumExamples(),
+	                          View.GetNumExamples() * View.GetSet().GetBytesPerExample());
+
+	return CoreUtilities::TaskScheduler::Get().ParallelReduce(
+		0, View.GetNumExamples(), 16 * KernelBlockSize, 0.0,
+		[&](std::size_t Begin, std::size_t End) {
+			double Sum = 0.0;
+			double Kernel[KernelBlockSize];
+
+			for (std::size_t Block = Begin; Block < End; Block += KernelBlockSize) {
+				const std::size_t BlockEnd = std::min(End, Block + KernelBlockSize);
+				GaussianKernelRow(View, Query, Sigma, Block, BlockEnd, Kernel);
+				for (std::size_t Index = 0; Index < BlockEnd - Block; Index++) {
+					Sum += Weights[Block + Index] * Kernel[Index];
+				}
+			}
+			return Sum;
+		},
+		[](double Left, double Right) { return Left + Right; });
+}
+
+} // namespace SupportVector
@@ -1 +1,29 @@
+#ifndef __GaussianKernel__
+#define __GaussianKernel__
 
+#include <cstddef>
+#include <vector>
+
+#include "MachineLearning/ModelRepresentation/TrainingSet.h"
+
+/* GAUSSIAN KERNEL */
+// K(x, z) = exp(-||x - z||^2 / (2 sigma^2))
+
+namespace SupportVector {
+
+double GaussianKernel(const double* X, const double* Z, std::size_t NumFeatures, double Sigma);
+
+// Kernel row against a query point: Out[p - Begin] = K(Query, x_p) for view
+// positions [Begin, End). Distances are accumulated one feature column at a
+// time.
+void GaussianKernelRow(const ModelRepresentation::TrainingView& View, const double* Query, double Sigma,
+                       std::size_t Begin, std::size_t End, double* Out);
+
+// sum_p Weights[p] K(Query, x_p) over every position of the view; large
+// views are split across the task scheduler.
+double GaussianKernelSum(const ModelRepresentation::TrainingView& View, const std::vector<double>& Weights,
+                         const double* Query, double Sigma);
+
+} // namespace SupportVector
+
+#endif // __GaussianKernel__
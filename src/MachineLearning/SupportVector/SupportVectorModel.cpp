@@ -0,0 +1,119 @@
+#include "MachineLearning/SupportVector/SupportVectorModel.h"
+
+#include <limits>
+#include <sstream>
+
+#include "CoreUtilities/TaskScheduler.h"
+#include "MachineLearning/SupportVector/GaussianKernel.h"
+
+namespace SupportVector {
+
+using ModelRepresentation::TrainingSet;
+using ModelRepresentation::TrainingView;
+
+namespace {
+
+double Label(double Output)
+{
+	return (Output > 0.5) ? 1.0 : -1.0;
+}
+
+
+void GatherRow(const TrainingSet& Set, std::size_t Row, std::vector<double>& Out)
+{
+	Out.resize(Set.GetNumFeatures());
+	for (std::size_t Feature = 0; Feature < Set.GetNumFeatures(); Feature++) {
+		Out[Feature] = Set.GetValue(Feature, Row);
+	}
+}
+
+} // namespace
+
+
+SupportVectorModel::SupportVectorModel(double InLambda, double InSigma, unsigned Seed)
+	: Lambda(InLambda), Sigma(InSigma), IterationsTrained(0), Generator(Seed)
+{
+}
+
+
+double SupportVectorModel::KernelExpansion(const TrainingSet& Set, const double* Query) const
+{
+	if (SupportRows.empty()) {
+		return 0.0;
+	}
+	return GaussianKernelSum(TrainingView(Set, SupportRows), SupportWeights, Query, Sigma);
+}
+
+
+void SupportVectorModel::Train(const TrainingView& View, std::size_t Iterations)
+{
+	if (View.GetNumExamples() == 0) {
+		return;
+	}
+
+	const TrainingSet& Set = View.GetSet();
+	std::uniform_int_distribution<std::size_t> Sample(0, View.GetNumExamples() - 1);
+	std::vector<double> Query;
+
+	for (std::size_t Iteration = 0; Iteration < Iterations; Iteration++) {
+		IterationsTrained++;
+
+		const std::size_t Row = View.GetRow(Sample(Generator));
+		const double Y = Label(Set.GetOutputs()[Row]);
+		GatherRow(Set, Row, Query);
+
+		const double Decision = KernelExpansion(Set, Query.data()) / (Lambda * IterationsTrained);
+		if (Y * Decision >= 1.0) {
+			continue;
+		}
+
+		// Hinge loss active: alpha_Row += 1, stored pre-multiplied by y.
+		const auto Found = SupportIndex.find(Row);
+		if (Found == SupportIndex.end()) {
+			SupportIndex.emplace(Row, SupportRows.size());
+			SupportRows.push_back(Row);
+			SupportWeights.push_back(Y);
+		} else {
+			SupportWeights[Found->second] += Y;
+		}
+	}
+}
+
+
+double SupportVectorModel::ValidationLoss(const TrainingView& View) const
+{
+	if (IterationsTrained == 0) {
+		return std::numeric_limits<double>::infinity();
+	}
+	if (View.GetNumExamples() == 0) {
+		return 0.0;
+	}
+
+	const TrainingSet& Set = View.GetSet();
+	const std::size_t Errors = CoreUtilities::TaskScheduler::Get().ParallelReduce(
+		0, View.GetNumExamples(), 64, std::size_t(0),
+		[&](std::size_t Begin, std::size_t End) {
+			std::size_t Count = 0;
+			std::vector<double> Query;
+			for (std::size_t Position = Begin; Position < End; Position++) {
+				const std::size_t Row = View.GetRow(Position);
+				GatherRow(Set, Row, Query);
+				const double Decision = KernelExpansion(Set, Query.data());
+				Count += ((Decision >= 0.0 ? 1.0 : -1.0) != Label(Set.GetOutputs()[Row])) ? 1 : 0;
+			}
+			return Count;
+		},
+		[](std::size_t Left, std::size_t Right) { return Left + Right; });
+
+	return static_cast<double>(Errors) / static_cast<double>(View.GetNumExamples());
+}
+
+
+std::string SupportVectorModel::Describe() const
+{
+	std::ostringstream Description;
+	Description << "svm(lambda=" << Lambda << ", sigma=" << Sigma << ")";
+	return Description.str();
+}
+
+} // namespace SupportVector
@@ -0,0 +1,47 @@
+#ifndef __SupportVectorModel__
+#define __SupportVectorModel__
+
+#include <cstddef>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "MachineLearning/ModelRepresentation/LearningModel.h"
+
+/* SUPPORT VECTOR MODEL */
+// Binary SVM with a Gaussian kernel trained by kernelised Pegasos
+// (stochastic sub-gradient descent on the hinge loss). Each iteration
+// samples one training row; the support vectors are kept as row indices of
+// the shared TrainingSet, so no feature data is copied. Outputs are read as
+// y = +1 when greater than 0.5 and y = -1 otherwise.
+
+namespace SupportVector {
+
+class SupportVectorModel : public ModelRepresentation::LearningModel {
+private:
+	double Lambda;
+	double Sigma;
+	std::vector<std::size_t> SupportRows;
+	std::vector<double> SupportWeights;
+	std::unordered_map<std::size_t, std::size_t> SupportIndex;
+	std::size_t IterationsTrained;
+	std::mt19937 Generator;
+
+	// Un-normalised decision value sum_s w_s K(x_s, Query).
+	double KernelExpansion(const ModelRepresentation::TrainingSet& Set, const double* Query) const;
+
+public:
+	SupportVectorModel(double InLambda, double InSigma, unsigned Seed = 0);
+
+	void Train(const ModelRepresentation::TrainingView& View, std::size_t Iterations) override;
+	double ValidationLoss(const ModelRepresentation::TrainingView& View) const override;
+	std::size_t GetIterationsTrained() const override { return IterationsTrained; }
+	std::string Describe() const override;
+
+	std::size_t GetNumSupportVectors() const { return SupportRows.size(); }
+};
+
+} // namespace SupportVector
+
+#endif // __SupportVectorModel__
@@ -0,0 +1,83 @@
+#include "NumericalAlgorithms/InterpolationAlgorithms/CubicSpline.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+namespace InterpolationAlgorithms {
+
+void SolveSymmetricTridiagonal(const std::vector<double>& Diagonal, const std::vector<double>& OffDiagonal,
+                               std::vector<double>& Rhs)
+{
+	const std::size_t Size = Diagonal.size();
+	if (Rhs.size() != Size || (Size > 0 && OffDiagonal.size() + 1 != Size)) {
+		throw std::invalid_argument("SolveSymmetricTridiagonal: inconsistent dimensions");
+	}
+	if (Size == 0) {
+		return;
+	}
+
+	// Pivots d_k of T = L D L^T; L has unit diagonal and L_{k,k-1} = e_k / d_{k-1}.
+	std::vector<double> Pivot(Size);
+	Pivot[0] = Diagonal[0];
+	for (std::size_t Row = 1; Row < Size; Row++) {
+		if (Pivot[Row - 1] == 0.0) {
+			throw std::runtime_error("SolveSymmetricTridiagonal: zero pivot");
+		}
+		const double Multiplier = OffDiagonal[Row - 1] / Pivot[Row - 1];
+		Pivot[Row] = Diagonal[Row] - Multiplier * OffDiagonal[Row - 1];
+		// Forward substitution L.y = b, folded into the factorisation.
+		Rhs[Row] -= Multiplier * Rhs[Row - 1];
+	}
+	if (Pivot[Size - 1] == 0.0) {
+		throw std::runtime_error("SolveSymmetricTridiagonal: zero pivot");
+	}
+
+	// D.z = y, then back substitution L^T.x = z.
+	Rhs[Size - 1] /= Pivot[Size - 1];
+	for (std::size_t Row = Size - 1; Row-- > 0;) {
+		Rhs[Row] = Rhs[Row] / Pivot[Row] - (OffDiagonal[Row] / Pivot[Row]) * Rhs[Row + 1];
+	}
+}
+
+
+CubicSpline::CubicSpline(double InStart, double InSpacing, std::vector<double> InValues)
+	: Start(InStart), Spacing(InSpacing), Values(std::move(InValues)), SecondDerivatives(Values.size(), 0.0)
+{
+	const std::size_t Size = Values.size();
+	if (Size < 2 || !(Spacing > 0.0)) {
+		throw std::invalid_argument("CubicSpline: need at least two points and a positive spacing");
+	}
+	if (Size == 2) {
+		return;
+	}
+
+	const std::size_t Interior = Size - 2;
+	const double Scale = 6.0 / (Spacing * Spacing);
+	std::vector<double> Rhs(Interior);
+	for (std::size_t Index = 0; Index < Interior; Index++) {
+		Rhs[Index] = Scale * (Values[Index + 2] - 2.0 * Values[Index + 1] + Values[Index]);
+	}
+
+	SolveSymmetricTridiagonal(std::vector<double>(Interior, 4.0), std::vector<double>(Interior - 1, 1.0), Rhs);
+	std::copy(Rhs.begin(), Rhs.end(), SecondDerivatives.begin() + 1);
+}
+
+
+double CubicSpline::Evaluate(double X) const
+{
+	const double Position = (X - Start) / Spacing;
+	const double Last = static_cast<double>(Values.size() - 2);
+	const std::size_t Interval = static_cast<std::size_t>(std::min(std::max(std::floor(Position), 0.0), Last));
+
+	const double Lower = Start + static_cast<double>(Interval) * Spacing;
+	const double Below = X - Lower;
+	const double Above = Lower + Spacing - X;
+
+	return (Above * Values[Interval] + Below * Values[Interval + 1]
+	        - Below * Above * ((Above + Spacing) * SecondDerivatives[Interval]
+	                           + (Below + Spacing) * SecondDerivatives[Interval + 1]) / 6.0) / Spacing;
+}
+
+} // namespace InterpolationAlgorithms
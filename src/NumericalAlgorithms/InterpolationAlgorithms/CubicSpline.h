@@ -0,0 +1,43 @@
+#ifndef __CubicSpline__
+#define __CubicSpline__
+
+#include <cstddef>
+#include <vector>
+
+/* CUBIC SPLINE */
+// Natural cubic spline through values on a uniform grid. The second
+// derivatives y'' satisfy, for the interior points,
+//   y''_{i-1} + 4 y''_i + y''_{i+1} = 6 (y_{i+1} - 2 y_i + y_{i-1}) / h^2
+// with y''_0 = y''_{n-1} = 0. That system is symmetric tridiagonal, so it is
+// solved in O(n) by LDL^T factorisation rather than by the O(n^2) sine
+// expansion of the standalone program.
+
+namespace InterpolationAlgorithms {
+
+// Solve T.x = b for symmetric tridiagonal T, given its Diagonal (n values)
+// and OffDiagonal (n - 1 values). Rhs holds b on entry and x on return.
+// Throws std::runtime_error on a zero pivot.
+void SolveSymmetricTridiagonal(const std::vector<double>& Diagonal, const std::vector<double>& OffDiagonal,
+                               std::vector<double>& Rhs);
+
+
+class CubicSpline {
+private:
+	double Start;
+	double Spacing;
+	std::vector<double> Values;
+	std::vector<double> SecondDerivatives;
+
+public:
+	// Values[i] is the function at Start + i * Spacing; needs at least two.
+	CubicSpline(double InStart, double InSpacing, std::vector<double> InValues);
+
+	const std::vector<double>& GetSecondDerivatives() const { return SecondDerivatives; }
+
+	// Points outside the grid are extrapolated from the end intervals.
+	double Evaluate(double X) const;
+};
+
+} // namespace InterpolationAlgorithms
+
+#endif // __CubicSpline__
@@ -410,7 +410,7 @@ void Plot_Spline_versus_Actual_Sine (int Number_of_Iterations,
       error = approx_sin_x_input - sin(x_input);
 
       FILE << x_input << '\t'
-	   << approx_sin_x_input << '\t' << error << endl;
+	   << approx_sin_x_input << '\t' << error << '\n';
 
     }
 }
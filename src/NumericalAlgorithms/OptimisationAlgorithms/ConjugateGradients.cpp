@@ -0,0 +1,61 @@
+#include "NumericalAlgorithms/OptimisationAlgorithms/ConjugateGradients.h"
+
+#include <cmath>
+#include <stdexcept>
+
+#include "CoreUtilities/ReportGeneration.h"
+
+namespace OptimisationAlgorithms {
+
+SolverResult SolveConjugateGradients(const LinearOperator& A, const std::vector<double>& B,
+                                     std::vector<double>& X, const SolverOptions& Options)
+{
+	const std::size_t Size = A.GetSize();
+	if (B.size() != Size || X.size() != Size) {
+		throw std::invalid_argument("ConjugateGradients: A, b and x dimensions differ");
+	}
+	LEARNSCRAPE_SCOPED_TIMER(CoreUtilities::ReportPhase::Solver);
+
+	// Residual r = b - A.x, direction p and its image A.p.
+	std::vector<double> Residual(Size);
+	std::vector<double> Direction(Size);
+	std::vector<double> Image(Size);
+
+	A.Multiply(X.data(), Residual.data());
+	for (std::size_t Index = 0; Index < Size; Index++) {
+		Residual[Index] = B[Index] - Residual[Index];
+	}
+	Direction = Residual;
+	double ResidualSquared = Dot(Residual, Residual);
+
+	SolverResult Result{0, std::sqrt(ResidualSquared), false};
+	while (Result.ResidualNorm >= Options.Tolerance && Result.Iterations < Options.MaxIterations) {
+		A.Multiply(Direction.data(), Image.data());
+		const double Curvature = Dot(Direction, Image);
+		if (!(Curvature > 0.0)) {
+			throw std::runtime_error("ConjugateGradients: matrix is not positive definite");
+		}
+		const double Alpha = ResidualSquared / Curvature;
+
+		for (std::size_t Index = 0; Index < Size; Index++) {
+			X[Index] += Alpha * Direction[Index];
+			Residual[Index] -= Alpha * Image[Index];
+		}
+
+		const double NextResidualSquared = Dot(Residual, Residual);
+		const double Beta = NextResidualSquared / ResidualSquared;
+		for (std::size_t Index = 0; Index < Size; Index++) {
+			Direction[Index] = Residual[Index] + Beta * Direction[Index];
+		}
+		ResidualSquared = NextResidualSquared;
+
+		Result.Iterations++;
+		Result.ResidualNorm = std::sqrt(ResidualSquared);
+		LEARNSCRAPE_COUNT(CoreUtilities::ReportCounter::OptimiserIterations, 1);
+	}
+
+	Result.bConverged = Result.ResidualNorm < Options.Tolerance;
+	return Result;
+}
+
+} // namespace OptimisationAlgorithms
@@ -0,0 +1,23 @@
+#ifndef __ConjugateGradients__
+#define __ConjugateGradients__
+
+#include <vector>
+
+#include "NumericalAlgorithms/OptimisationAlgorithms/LinearOperator.h"
+
+/* CONJUGATE GRADIENTS */
+// Solve A.x = b for symmetric positive definite A. Search directions are kept
+// A-conjugate: p := r + beta p with beta = r_new.r_new / r.r, and
+// alpha = r.r / p.A.p. Each step costs one product with A, and in exact
+// arithmetic the method ends in at most n steps.
+
+namespace OptimisationAlgorithms {
+
+// X holds the starting point and receives the solution. Stops once
+// ||b - A.x|| < Options.Tolerance or after Options.MaxIterations steps.
+SolverResult SolveConjugateGradients(const LinearOperator& A, const std::vector<double>& B,
+                                     std::vector<double>& X, const SolverOptions& Options = SolverOptions());
+
+} // namespace OptimisationAlgorithms
+
+#endif // __ConjugateGradients__
@@ -0,0 +1,38 @@
+#include "NumericalAlgorithms/OptimisationAlgorithms/DistributedDescent.h"
+
+#include <algorithm>
+
+#include "CoreUtilities/ReportGeneration.h"
+
+namespace OptimisationAlgorithms {
+
+DescentResult SolveDistributedDescent(CoreUtilities::RingAllReduce& Ring, const ShardObjective& Objective,
+                                      std::vector<double>& X, double LearningRate, const ConvergenceCheck& Check)
+{
+	LEARNSCRAPE_SCOPED_TIMER(CoreUtilities::ReportPhase::Solver);
+	const std::size_t Size = X.size();
+
+	// Cost in slot 0, gradient after it, so one all-reduce carries both.
+	std::vector<double> Gradient(Size);
+	std::vector<double> Packed(Size + 1);
+	DescentResult Result = {0, 0.0};
+
+	for (;;) {
+		std::fill(Gradient.begin(), Gradient.end(), 0.0);
+		Packed[0] = Objective(X, Gradient);
+		std::copy(Gradient.begin(), Gradient.end(), Packed.begin() + 1);
+		Ring.AllReduce(Packed);
+
+		Result.Cost = Packed[0];
+		if (!Check(Result.Iterations, Result.Cost)) {
+			return Result;
+		}
+		for (std::size_t Index = 0; Index < Size; Index++) {
+			X[Index] -= LearningRate * Packed[Index + 1];
+		}
+		Result.Iterations++;
+		LEARNSCRAPE_COUNT(CoreUtilities::ReportCounter::OptimiserIterations, 1);
+	}
+}
+
+} // namespace OptimisationAlgorithms
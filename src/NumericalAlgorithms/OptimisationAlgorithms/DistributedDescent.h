@@ -0,0 +1,46 @@
+#ifndef __DistributedDescent__
+#define __DistributedDescent__
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+#include "CoreUtilities/RingAllReduce.h"
+
+/* DISTRIBUTED DESCENT */
+// Data-parallel gradient descent on a separable objective
+// f(x) = sum_k f_k(x), where rank k of a ring can evaluate only its own
+// term f_k, e.g. the loss over its shard of the training rows. Each step:
+// 1. every rank evaluates f_k and grad f_k at the shared x;
+// 2. one all-reduce sums [f, grad f] over the ring;
+// 3. every rank takes the same step.
+// The all-reduce leaves bit-identical sums on every rank, so the iterates
+// stay in lockstep and x itself is never sent. Whether to continue is left
+// to the caller's check, typically a coordinator that sees the summed cost
+// of every step.
+
+namespace OptimisationAlgorithms {
+
+// Rank k's term: returns f_k(X) and writes grad f_k(X) into Gradient, which
+// has X's size.
+using ShardObjective = std::function<double(const std::vector<double>& X, std::vector<double>& Gradient)>;
+
+// Called with the number of steps taken so far and f(x) at the current x;
+// returning false stops before the next step. Must return the same answer
+// on every rank.
+using ConvergenceCheck = std::function<bool(std::size_t Steps, double Cost)>;
+
+struct DescentResult {
+	std::size_t Iterations;
+	// f at the returned x.
+	double Cost;
+};
+
+// X holds the starting point (equal on every rank) and receives the
+// solution; steps are x := x - LearningRate * grad f.
+DescentResult SolveDistributedDescent(CoreUtilities::RingAllReduce& Ring, const ShardObjective& Objective,
+                                      std::vector<double>& X, double LearningRate, const ConvergenceCheck& Check);
+
+} // namespace OptimisationAlgorithms
+
+#endif // __DistributedDescent__
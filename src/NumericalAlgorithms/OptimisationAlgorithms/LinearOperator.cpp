@@ -0,0 +1,156 @@
+#include "NumericalAlgorithms/OptimisationAlgorithms/LinearOperator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "CoreUtilities/TaskScheduler.h"
+
+namespace OptimisationAlgorithms {
+
+namespace {
+
+// Aim for roughly this many multiply-adds per parallel chunk.
+const std::size_t MultiplyGrainElements = 1 << 16;
+
+} // namespace
+
+
+SymmetricMatrix::SymmetricMatrix(std::size_t InSize)
+	: Size(InSize), Values(InSize * InSize, 0.0)
+{
+}
+
+
+SymmetricMatrix SymmetricMatrix::Banded(std::size_t Size, double Decay)
+{
+	if (Size % 2 != 1) {
+		throw std::invalid_argument("SymmetricMatrix: banded test matrix size must be odd");
+	}
+	if (Decay < 0.0 || Decay >= 1.0) {
+		throw std::invalid_argument("SymmetricMatrix: banded test matrix decay must lie in [0, 1)");
+	}
+
+	SymmetricMatrix Matrix(Size);
+	double Element = Decay;
+	for (std::size_t Row = 0; Row < Size; Row++) {
+		Matrix.Values[Row * Size + Row] = 1.0;
+	}
+	for (std::size_t Offset = 1; Offset < (Size + 1) / 2; Offset++) {
+		for (std::size_t Row = 0; Row < Size; Row++) {
+			Matrix.Set(Row, (Row + Offset) % Size, Element);
+		}
+		Element *= Decay;
+	}
+	return Matrix;
+}
+
+
+void SymmetricMatrix::Set(std::size_t Row, std::size_t Column, double Value)
+{
+	Values[Row * Size + Column] = Value;
+	Values[Column * Size + Row] = Value;
+}
+
+
+void SymmetricMatrix::Multiply(const double* X, double* Out) const
+{
+	const std::size_t Grain = std::max<std::size_t>(1, MultiplyGrainElements / std::max<std::size_t>(1, Size));
+
+	CoreUtilities::TaskScheduler::Get().ParallelFor(0, Size, Grain, [&](std::size_t Begin, std::size_t End) {
+		for (std::size_t Row = Begin; Row < End; Row++) {
+			const double* Entries = &Values[Row * Size];
+			double Sum = 0.0;
+			for (std::size_t Column = 0; Column < Size; Column++) {
+				Sum += Entries[Column] * X[Column];
+			}
+			Out[Row] = Sum;
+		}
+	});
+}
+
+
+SparseMatrix::SparseMatrix(std::size_t InSize)
+	: Size(InSize), RowOffsets(InSize + 1, 0)
+{
+}
+
+
+SparseMatrix SparseMatrix::FromEntries(std::size_t Size, const std::vector<MatrixEntry>& Entries)
+{
+	// Expand to both triangles, order by (row, column) and merge repeats.
+	std::vector<MatrixEntry> Expanded;
+	Expanded.reserve(2 * Entries.size());
+	for (const MatrixEntry& Entry : Entries) {
+		if (Entry.Row >= Size || Entry.Column >= Size) {
+			throw std::invalid_argument("SparseMatrix: entry index out of range");
+		}
+		Expanded.push_back(Entry);
+		if (Entry.Row != Entry.Column) {
+			Expanded.push_back({Entry.Column, Entry.Row, Entry.Value});
+		}
+	}
+	std::sort(Expanded.begin(), Expanded.end(), [](const MatrixEntry& Left, const MatrixEntry& Right) {
+		return Left.Row != Right.Row ? Left.Row < Right.Row : Left.Column < Right.Column;
+	});
+
+	SparseMatrix Matrix(Size);
+	for (std::size_t Index = 0; Index < Expanded.size(); Index++) {
+		const MatrixEntry& Entry = Expanded[Index];
+		if (Index > 0 && Expanded[Index - 1].Row == Entry.Row && Expanded[Index - 1].Column == Entry.Column) {
+			Matrix.Values.back() += Entry.Value;
+			continue;
+		}
+		Matrix.Columns.push_back(Entry.Column);
+		Matrix.Values.push_back(Entry.Value);
+		Matrix.RowOffsets[Entry.Row + 1]++;
+	}
+	for (std::size_t Row = 0; Row < Size; Row++) {
+		Matrix.RowOffsets[Row + 1] += Matrix.RowOffsets[Row];
+	}
+	return Matrix;
+}
+
+
+SparseMatrix SparseMatrix::FromDense(const SymmetricMatrix& Dense, double DropTolerance)
+{
+	std::vector<MatrixEntry> Entries;
+	for (std::size_t Row = 0; Row < Dense.GetSize(); Row++) {
+		for (std::size_t Column = Row; Column < Dense.GetSize(); Column++) {
+			const double Value = Dense.Get(Row, Column);
+			if (std::fabs(Value) > DropTolerance) {
+				Entries.push_back({Row, Column, Value});
+			}
+		}
+	}
+	return FromEntries(Dense.GetSize(), Entries);
+}
+
+
+void SparseMatrix::Multiply(const double* X, double* Out) const
+{
+	const std::size_t AverageRow = std::max<std::size_t>(1, Values.size() / std::max<std::size_t>(1, Size));
+	const std::size_t Grain = std::max<std::size_t>(1, MultiplyGrainElements / AverageRow);
+
+	CoreUtilities::TaskScheduler::Get().ParallelFor(0, Size, Grain, [&](std::size_t Begin, std::size_t End) {
+		for (std::size_t Row = Begin; Row < End; Row++) {
+			double Sum = 0.0;
+			for (std::size_t Entry = RowOffsets[Row]; Entry < RowOffsets[Row + 1]; Entry++) {
+				Sum += Values[Entry] * X[Columns[Entry]];
+			}
+			Out[Row] = Sum;
+		}
+	});
+}
+
+
+double Dot(const std::vector<double>& Left, const std::vector<double>& Right)
+{
+	double Sum = 0.0;
+	for (std::size_t Index = 0; Index < Left.size(); Index++) {
+		Sum += Left[Index] * Right[Index];
+	}
+	return Sum;
+}
+
+} // namespace OptimisationAlgorithms
@@ -0,0 +1,96 @@
+#ifndef __LinearOperator__
+#define __LinearOperator__
+
+#include <cstddef>
+#include <vector>
+
+/* LINEAR OPERATOR */
+// Shared pieces of the iterative solvers for A.x = b with A symmetric positive
+// definite. The solvers touch A only through Multiply, so any storage that
+// can form A.x is usable.
+
+namespace OptimisationAlgorithms {
+
+class LinearOperator {
+public:
+	virtual ~LinearOperator() = default;
+
+	virtual std::size_t GetSize() const = 0;
+
+	// Out = A.X; both hold GetSize() values and do not alias.
+	virtual void Multiply(const double* X, double* Out) const = 0;
+};
+
+
+// Dense row-major n x n symmetric matrix; Multiply runs row blocks in parallel.
+class SymmetricMatrix : public LinearOperator {
+private:
+	std::size_t Size;
+	std::vector<double> Values;
+
+public:
+	explicit SymmetricMatrix(std::size_t InSize = 0);
+
+	// The MTMCC 12 test matrix: unit diagonal and A(j, (j + i) mod n) = Decay^i
+	// for i = 1 .. (n - 1) / 2, mirrored. Size must be odd; Decay in [0, 1).
+	static SymmetricMatrix Banded(std::size_t Size, double Decay);
+
+	std::size_t GetSize() const override { return Size; }
+	double Get(std::size_t Row, std::size_t Column) const { return Values[Row * Size + Column]; }
+	// Sets both (Row, Column) and (Column, Row).
+	void Set(std::size_t Row, std::size_t Column, double Value);
+
+	void Multiply(const double* X, double* Out) const override;
+};
+
+
+struct MatrixEntry {
+	std::size_t Row;
+	std::size_t Column;
+	double Value;
+};
+
+
+// Symmetric matrix in compressed sparse row form. Both triangles are stored
+// so Multiply is a plain row-parallel CSR product.
+class SparseMatrix : public LinearOperator {
+private:
+	std::size_t Size;
+	std::vector<std::size_t> RowOffsets;
+	std::vector<std::size_t> Columns;
+	std::vector<double> Values;
+
+public:
+	explicit SparseMatrix(std::size_t InSize = 0);
+
+	// Each off-diagonal entry is given once and mirrored; repeated positions
+	// are summed. Throws std::invalid_argument for out-of-range indices.
+	static SparseMatrix FromEntries(std::size_t Size, const std::vector<MatrixEntry>& Entries);
+	// Keep the entries of Dense whose magnitude exceeds DropTolerance.
+	static SparseMatrix FromDense(const SymmetricMatrix& Dense, double DropTolerance = 0.0);
+
+	std::size_t GetSize() const override { return Size; }
+	std::size_t GetNumNonZeros() const { return Values.size(); }
+
+	void Multiply(const double* X, double* Out) const override;
+};
+
+
+struct SolverOptions {
+	std::size_t MaxIterations = 1000;
+	double Tolerance = 1.0e-10;
+};
+
+struct SolverResult {
+	std::size_t Iterations;
+	// ||b - A.x|| when the solver stopped.
+	double ResidualNorm;
+	bool bConverged;
+};
+
+
+double Dot(const std::vector<double>& Left, const std::vector<double>& Right);
+
+} // namespace OptimisationAlgorithms
+
+#endif // __LinearOperator__
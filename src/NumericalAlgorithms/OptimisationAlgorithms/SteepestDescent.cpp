@@ -0,0 +1,68 @@
+#include "NumericalAlgorithms/OptimisationAlgorithms/SteepestDescent.h"
+
+#include <cmath>
+#include <stdexcept>
+
+#include "CoreUtilities/ReportGeneration.h"
+
+namespace OptimisationAlgorithms {
+
+namespace {
+
+// Steps between exact residual recomputations.
+const std::size_t ResidualRefreshInterval = 50;
+
+
+void ExactResidual(const LinearOperator& A, const std::vector<double>& B, const std::vector<double>& X,
+                   std::vector<double>& Residual)
+{
+	A.Multiply(X.data(), Residual.data());
+	for (std::size_t Index = 0; Index < Residual.size(); Index++) {
+		Residual[Index] -= B[Index];
+	}
+}
+
+} // namespace
+
+
+SolverResult SolveSteepestDescent(const LinearOperator& A, const std::vector<double>& B,
+                                  std::vector<double>& X, const SolverOptions& Options)
+{
+	const std::size_t Size = A.GetSize();
+	if (B.size() != Size || X.size() != Size) {
+		throw std::invalid_argument("SteepestDescent: A, b and x dimensions differ");
+	}
+	LEARNSCRAPE_SCOPED_TIMER(CoreUtilities::ReportPhase::Solver);
+
+	// Gradient g = A.x - b and its image A.g.
+	std::vector<double> Gradient(Size);
+	std::vector<double> Image(Size);
+	ExactResidual(A, B, X, Gradient);
+
+	SolverResult Result{0, std::sqrt(Dot(Gradient, Gradient)), false};
+	while (Result.ResidualNorm >= Options.Tolerance && Result.Iterations < Options.MaxIterations) {
+		A.Multiply(Gradient.data(), Image.data());
+		const double Curvature = Dot(Gradient, Image);
+		if (!(Curvature > 0.0)) {
+			throw std::runtime_error("SteepestDescent: matrix is not positive definite");
+		}
+		const double Alpha = (Result.ResidualNorm * Result.ResidualNorm) / Curvature;
+
+		for (std::size_t Index = 0; Index < Size; Index++) {
+			X[Index] -= Alpha * Gradient[Index];
+			Gradient[Index] -= Alpha * Image[Index];
+		}
+		Result.Iterations++;
+		LEARNSCRAPE_COUNT(CoreUtilities::ReportCounter::OptimiserIterations, 1);
+
+		if (Result.Iterations % ResidualRefreshInterval == 0) {
+			ExactResidual(A, B, X, Gradient);
+		}
+		Result.ResidualNorm = std::sqrt(Dot(Gradient, Gradient));
+	}
+
+	Result.bConverged = Result.ResidualNorm < Options.Tolerance;
+	return Result;
+}
+
+} // namespace OptimisationAlgorithms
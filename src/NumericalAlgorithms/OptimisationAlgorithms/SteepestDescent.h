@@ -0,0 +1,24 @@
+#ifndef __SteepestDescent__
+#define __SteepestDescent__
+
+#include <vector>
+
+#include "NumericalAlgorithms/OptimisationAlgorithms/LinearOperator.h"
+
+/* STEEPEST DESCENT */
+// Minimise f(x) = x^T A x / 2 - b^T x, whose gradient is g = A.x - b. Each
+// step moves along -g by the exact line-search length alpha = g.g / g.A.g.
+// The residual is carried by the recurrence r := r - alpha A.r, so a step
+// costs one product with A. It is recomputed from scratch periodically to
+// stop rounding drift.
+
+namespace OptimisationAlgorithms {
+
+// X holds the starting point and receives the solution. Stops once
+// ||A.x - b|| < Options.Tolerance or after Options.MaxIterations steps.
+SolverResult SolveSteepestDescent(const LinearOperator& A, const std::vector<double>& B,
+                                  std::vector<double>& X, const SolverOptions& Options = SolverOptions());
+
+} // namespace OptimisationAlgorithms
+
+#endif // __SteepestDescent__
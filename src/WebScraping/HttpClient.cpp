@@ -0,0 +1,512 @@
+#include "WebScraping/HttpClient.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#ifdef LEARNSCRAPE_TLS
+#include <openssl/err.h>
+#include <openssl/ssl.h>
+#endif
+
+namespace WebScraping {
+
+namespace {
+
+// Refuse bodies and header lines beyond these sizes.
+const std::size_t MaxBodyBytes = std::size_t(256) << 20;
+const std::size_t MaxLineBytes = 64 << 10;
+const std::size_t ReceiveChunkBytes = 64 << 10;
+
+
+std::string ToLower(std::string Text)
+{
+	std::transform(Text.begin(), Text.end(), Text.begin(),
+	               [](unsigned char Character) { return static_cast<char>(std::tolower(Character)); });
+	return Text;
+}
+
+
+std::string TrimSpace(const std::string& Text)
+{
+	const std::size_t First = Text.find_first_not_of(" \t");
+	if (First == std::string::npos) {
+		return "";
+	}
+	return Text.substr(First, Text.find_last_not_of(" \t") - First + 1);
+}
+
+
+std::uint16_t DefaultPort(const std::string& Scheme)
+{
+	return (Scheme == "https") ? 443 : 80;
+}
+
+
+std::string SocketError(const std::string& What)
+{
+	return "HttpConnection: " + What + ": " + std::strerror(errno);
+}
+
+
+#ifdef LEARNSCRAPE_TLS
+std::string TlsError(const std::string& What)
+{
+	char Text[256];
+	ERR_error_string_n(ERR_get_error(), Text, sizeof(Text));
+	return "HttpConnection: " + What + ": " + Text;
+}
+
+
+SSL_CTX* GetTlsContext()
+{
+	static SSL_CTX* const Context = []() {
+		// OpenSSL writes with write(2), so a reset peer would raise SIGPIPE.
+		std::signal(SIGPIPE, SIG_IGN);
+
+		SSL_CTX* Created = SSL_CTX_new(TLS_client_method());
+		if (Created == nullptr) {
+			throw std::runtime_error(TlsError("cannot create TLS context"));
+		}
+		SSL_CTX_set_min_proto_version(Created, TLS1_2_VERSION);
+		SSL_CTX_set_default_verify_paths(Created);
+		SSL_CTX_set_verify(Created, SSL_VERIFY_PEER, nullptr);
+#ifdef SSL_OP_IGNORE_UNEXPECTED_EOF
+		// Close-delimited bodies end with a bare TCP close on many servers.
+		SSL_CTX_set_options(Created, SSL_OP_IGNORE_UNEXPECTED_EOF);
+#endif
+		return Created;
+	}();
+	return Context;
+}
+#endif
+
+
+int ConnectSocket(const std::string& Host, std::uint16_t Port, double TimeoutSeconds)
+{
+	addrinfo Hints{};
+	Hints.ai_family = AF_UNSPEC;
+	Hints.ai_socktype = SOCK_STREAM;
+	addrinfo* Addresses = nullptr;
+	const int Status = ::getaddrinfo(Host.c_str(), std::to_string(Port).c_str(), &Hints, &Addresses);
+	if (Status != 0) {
+		throw std::runtime_error("HttpConnection: cannot resolve " + Host + ": " + ::gai_strerror(Status));
+	}
+
+	const int TimeoutMilliseconds = static_cast<int>(TimeoutSeconds * 1000.0);
+	std::string LastError = "no addresses";
+	int Descriptor = -1;
+	for (addrinfo* Address = Addresses; Address != nullptr && Descriptor < 0; Address = Address->ai_next) {
+		Descriptor = ::socket(Address->ai_family, Address->ai_socktype | SOCK_CLOEXEC, Address->ai_protocol);
+		if (Descriptor < 0) {
+			LastError = std::strerror(errno);
+			continue;
+		}
+
+		// Non-blocking connect so the timeout applies, then back to blocking.
+		const int Flags = ::fcntl(Descriptor, F_GETFL, 0);
+		::fcntl(Descriptor, F_SETFL, Flags | O_NONBLOCK);
+		int Error = 0;
+		if (::connect(Descriptor, Address->ai_addr, Address->ai_addrlen) < 0) {
+			Error = errno;
+			if (Error == EINPROGRESS) {
+				pollfd Watch{Descriptor, POLLOUT, 0};
+				const int Ready = ::poll(&Watch, 1, TimeoutMilliseconds);
+				socklen_t Length = sizeof(Error);
+				if (Ready <= 0) {
+					Error = (Ready == 0) ? ETIMEDOUT : errno;
+				} else if (::getsockopt(Descriptor, SOL_SOCKET, SO_ERROR, &Error, &Length) < 0) {
+					Error = errno;
+				}
+			}
+		}
+		if (Error != 0) {
+			LastError = std::strerror(Error);
+			::close(Descriptor);
+			Descriptor = -1;
+			continue;
+		}
+		::fcntl(Descriptor, F_SETFL, Flags);
+	}
+	::freeaddrinfo(Addresses);
+
+	if (Descriptor < 0) {
+		throw std::runtime_error("HttpConnection: cannot connect to " + Host + ":" + std::to_string(Port) + ": " +
+		                         LastError);
+	}
+
+	timeval Timeout;
+	Timeout.tv_sec = static_cast<time_t>(TimeoutSeconds);
+	Timeout.tv_usec = static_cast<suseconds_t>((TimeoutSeconds - static_cast<double>(Timeout.tv_sec)) * 1.0e6);
+	::setsockopt(Descriptor, SOL_SOCKET, SO_RCVTIMEO, &Timeout, sizeof(Timeout));
+	::setsockopt(Descriptor, SOL_SOCKET, SO_SNDTIMEO, &Timeout, sizeof(Timeout));
+	const int NoDelay = 1;
+	::setsockopt(Descriptor, IPPROTO_TCP, TCP_NODELAY, &NoDelay, sizeof(NoDelay));
+	return Descriptor;
+}
+
+} // namespace
+
+
+/*============================================================================*/
+// URL
+/*============================================================================*/
+
+Url Url::Parse(const std::string& Text)
+{
+	const std::size_t SchemeEnd = Text.find("://");
+	if (SchemeEnd == std::string::npos) {
+		throw std::invalid_argument("Url: missing scheme in " + Text);
+	}
+
+	Url Parsed;
+	Parsed.Scheme = ToLower(Text.substr(0, SchemeEnd));
+	if (Parsed.Scheme != "http" && Parsed.Scheme != "https") {
+		throw std::invalid_argument("Url: unsupported scheme in " + Text);
+	}
+
+	const std::size_t AuthorityStart = SchemeEnd + 3;
+	const std::size_t AuthorityEnd = std::min(Text.find_first_of("/?#", AuthorityStart), Text.size());
+	std::string Authority = Text.substr(AuthorityStart, AuthorityEnd - AuthorityStart);
+	const std::size_t UserInfo = Authority.rfind('@');
+	if (UserInfo != std::string::npos) {
+		Authority.erase(0, UserInfo + 1);
+	}
+
+	// Host, [IPv6] host, optional :port.
+	std::size_t PortStart = std::string::npos;
+	if (!Authority.empty() && Authority[0] == '[') {
+		const std::size_t Close = Authority.find(']');
+		if (Close == std::string::npos) {
+			throw std::invalid_argument("Url: unterminated IPv6 host in " + Text);
+		}
+		Parsed.Host = Authority.substr(1, Close - 1);
+		PortStart = (Close + 1 < Authority.size() && Authority[Close + 1] == ':') ? Close + 2 : std::string::npos;
+	} else {
+		const std::size_t Colon = Authority.find(':');
+		Parsed.Host = Authority.substr(0, Colon);
+		PortStart = (Colon == std::string::npos) ? std::string::npos : Colon + 1;
+	}
+	if (Parsed.Host.empty()) {
+		throw std::invalid_argument("Url: missing host in " + Text);
+	}
+	Parsed.Host = ToLower(Parsed.Host);
+
+	Parsed.Port = DefaultPort(Parsed.Scheme);
+	if (PortStart != std::string::npos && PortStart < Authority.size()) {
+		char* End = nullptr;
+		const long Port = std::strtol(Authority.c_str() + PortStart, &End, 10);
+		if (*End != '\0' || Port <= 0 || Port > 65535) {
+			throw std::invalid_argument("Url: bad port in " + Text);
+		}
+		Parsed.Port = static_cast<std::uint16_t>(Port);
+	}
+
+	Parsed.Target = Text.substr(AuthorityEnd, Text.find('#', AuthorityEnd) - AuthorityEnd);
+	if (Parsed.Target.empty() || Parsed.Target[0] != '/') {
+		Parsed.Target.insert(0, "/");
+	}
+	return Parsed;
+}
+
+
+Url Url::Resolve(const std::string& Reference) const
+{
+	if (Reference.find("://") != std::string::npos) {
+		return Parse(Reference);
+	}
+	if (Reference.compare(0, 2, "//") == 0) {
+		return Parse(Scheme + ":" + Reference);
+	}
+
+	Url Resolved = *this;
+	const std::string Stripped = Reference.substr(0, Reference.find('#'));
+	if (!Stripped.empty() && Stripped[0] == '/') {
+		Resolved.Target = Stripped;
+	} else if (!Stripped.empty() && Stripped[0] == '?') {
+		Resolved.Target = Target.substr(0, Target.find('?')) + Stripped;
+	} else {
+		const std::string Path = Target.substr(0, Target.find('?'));
+		Resolved.Target = Path.substr(0, Path.rfind('/') + 1) + Stripped;
+	}
+	return Resolved;
+}
+
+
+std::string Url::GetOrigin() const
+{
+	return Scheme + "://" + Host + ":" + std::to_string(Port);
+}
+
+
+std::string Url::ToString() const
+{
+	std::string Text = Scheme + "://" + (Host.find(':') != std::string::npos ? "[" + Host + "]" : Host);
+	if (Port != DefaultPort(Scheme)) {
+		Text += ":" + std::to_string(Port);
+	}
+	return Text + Target;
+}
+
+
+const std::string* HttpResponse::FindHeader(const std::string& Name) const
+{
+	for (const auto& Header : Headers) {
+		if (Header.first == Name) {
+			return &Header.second;
+		}
+	}
+	return nullptr;
+}
+
+
+/*============================================================================*/
+// HTTP CONNECTION
+/*============================================================================*/
+
+HttpConnection::HttpConnection(const Url& InOrigin, double TimeoutSeconds)
+	: Origin(InOrigin), Descriptor(-1), Tls(nullptr), bReusable(true), bAwaitingResponse(false), bDroppedIdle(false)
+{
+#ifndef LEARNSCRAPE_TLS
+	if (Origin.Scheme == "https") {
+		throw std::runtime_error("HttpConnection: https needs a build with OpenSSL (LEARNSCRAPE_TLS)");
+	}
+#endif
+	Descriptor = ConnectSocket(Origin.Host, Origin.Port, TimeoutSeconds);
+
+#ifdef LEARNSCRAPE_TLS
+	if (Origin.Scheme == "https") {
+		SSL* Session = SSL_new(GetTlsContext());
+		if (Session == nullptr) {
+			::close(Descriptor);
+			throw std::runtime_error(TlsError("cannot create TLS session"));
+		}
+		Tls = Session;
+		SSL_set_fd(Session, Descriptor);
+		SSL_set_tlsext_host_name(Session, Origin.Host.c_str());
+		SSL_set1_host(Session, Origin.Host.c_str());
+		if (SSL_connect(Session) != 1) {
+			const std::string Error = TlsError("TLS handshake with " + Origin.Host + " failed");
+			SSL_free(Session);
+			::close(Descriptor);
+			throw std::runtime_error(Error);
+		}
+	}
+#endif
+}
+
+
+HttpConnection::~HttpConnection()
+{
+#ifdef LEARNSCRAPE_TLS
+	if (Tls != nullptr) {
+		SSL_shutdown(static_cast<SSL*>(Tls));
+		SSL_free(static_cast<SSL*>(Tls));
+	}
+#endif
+	if (Descriptor >= 0) {
+		::close(Descriptor);
+	}
+}
+
+
+void HttpConnection::SendAll(const std::string& Data)
+{
+	std::size_t Sent = 0;
+	while (Sent < Data.size()) {
+#ifdef LEARNSCRAPE_TLS
+		if (Tls != nullptr) {
+			const int Written = SSL_write(static_cast<SSL*>(Tls), Data.data() + Sent,
+			                              static_cast<int>(std::min<std::size_t>(Data.size() - Sent, 1 << 30)));
+			if (Written <= 0) {
+				throw std::runtime_error(TlsError("TLS write failed"));
+			}
+			Sent += static_cast<std::size_t>(Written);
+			continue;
+		}
+#endif
+		const ssize_t Written = ::send(Descriptor, Data.data() + Sent, Data.size() - Sent, MSG_NOSIGNAL);
+		if (Written < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			bDroppedIdle = bAwaitingResponse && (errno == EPIPE || errno == ECONNRESET);
+			throw std::runtime_error(SocketError("send failed"));
+		}
+		Sent += static_cast<std::size_t>(Written);
+	}
+}
+
+
+bool HttpConnection::Receive()
+{
+	char Buffer[ReceiveChunkBytes];
+	for (;;) {
+#ifdef LEARNSCRAPE_TLS
+		if (Tls != nullptr) {
+			SSL* Session = static_cast<SSL*>(Tls);
+			const int Read = SSL_read(Session, Buffer, sizeof(Buffer));
+			if (Read > 0) {
+				Pending.append(Buffer, static_cast<std::size_t>(Read));
+				bAwaitingResponse = false;
+				return true;
+			}
+			const int Error = SSL_get_error(Session, Read);
+			if (Error == SSL_ERROR_ZERO_RETURN || (Error == SSL_ERROR_SYSCALL && errno == 0)) {
+				bDroppedIdle = bAwaitingResponse;
+				return false;
+			}
+			bDroppedIdle = bAwaitingResponse && Error == SSL_ERROR_SYSCALL && errno == ECONNRESET;
+			throw std::runtime_error(TlsError("TLS read failed"));
+		}
+#endif
+		const ssize_t Read = ::recv(Descriptor, Buffer, sizeof(Buffer), 0);
+		if (Read > 0) {
+			Pending.append(Buffer, static_cast<std::size_t>(Read));
+			bAwaitingResponse = false;
+			return true;
+		}
+		if (Read == 0) {
+			bDroppedIdle = bAwaitingResponse;
+			return false;
+		}
+		if (errno == EINTR) {
+			continue;
+		}
+		if (errno == EAGAIN || errno == EWOULDBLOCK) {
+			throw std::runtime_error("HttpConnection: timed out waiting for " + Origin.Host);
+		}
+		bDroppedIdle = bAwaitingResponse && errno == ECONNRESET;
+		throw std::runtime_error(SocketError("recv failed"));
+	}
+}
+
+
+std::string HttpConnection::ReadLine()
+{
+	std::size_t Newline;
+	while ((Newline = Pending.find('\n')) == std::string::npos) {
+		if (Pending.size() > MaxLineBytes) {
+			throw std::runtime_error("HttpConnection: header line too long from " + Origin.Host);
+		}
+		if (!Receive()) {
+			throw std::runtime_error("HttpConnection: " + Origin.Host + " closed the connection mid-response");
+		}
+	}
+	const std::size_t End = (Newline > 0 && Pending[Newline - 1] == '\r') ? Newline - 1 : Newline;
+	std::string Line = Pending.substr(0, End);
+	Pending.erase(0, Newline + 1);
+	return Line;
+}
+
+
+void HttpConnection::ReadExactly(std::size_t Size, std::string& Out)
+{
+	if (Out.size() + Size > MaxBodyBytes) {
+		throw std::runtime_error("HttpConnection: response body from " + Origin.Host + " is too large");
+	}
+	while (Pending.size() < Size) {
+		if (!Receive()) {
+			throw std::runtime_error("HttpConnection: " + Origin.Host + " closed the connection mid-body");
+		}
+	}
+	Out.append(Pending, 0, Size);
+	Pending.erase(0, Size);
+}
+
+
+HttpResponse HttpConnection::Send(const std::string& Method, const Url& Target, const HeaderList& ExtraHeaders)
+{
+	// Only a response read to completion leaves the connection reusable.
+	bReusable = false;
+	bAwaitingResponse = Pending.empty();
+	bDroppedIdle = false;
+
+	std::string Request = Method + " " + Target.Target + " HTTP/1.1\r\nHost: " + Target.Host;
+	if (Target.Port != DefaultPort(Target.Scheme)) {
+		Request += ":" + std::to_string(Target.Port);
+	}
+	Request += "\r\nUser-Agent: learnscrape/0.0\r\nAccept-Encoding: identity\r\nConnection: keep-alive\r\n";
+	for (const auto& Header : ExtraHeaders) {
+		Request += Header.first + ": " + Header.second + "\r\n";
+	}
+	Request += "\r\n";
+	SendAll(Request);
+
+	HttpResponse Response;
+	bool bHttp11 = true;
+	do {
+		const std::string StatusLine = ReadLine();
+		if (StatusLine.compare(0, 5, "HTTP/") != 0 || StatusLine.size() < 12) {
+			throw std::runtime_error("HttpConnection: malformed status line from " + Origin.Host);
+		}
+		bHttp11 = StatusLine.compare(0, 8, "HTTP/1.0") != 0;
+		Response.StatusCode = std::atoi(StatusLine.c_str() + 9);
+		Response.Headers.clear();
+
+		for (std::string Line = ReadLine(); !Line.empty(); Line = ReadLine()) {
+			const std::size_t Colon = Line.find(':');
+			if (Colon != std::string::npos) {
+				Response.Headers.emplace_back(ToLower(TrimSpace(Line.substr(0, Colon))), TrimSpace(Line.substr(Colon + 1)));
+			}
+		}
+	} while (Response.StatusCode >= 100 && Response.StatusCode < 200);
+
+	const std::string* Connection = Response.FindHeader("connection");
+	const std::string ConnectionValue = Connection ? ToLower(*Connection) : "";
+	Response.bKeepAlive = (ConnectionValue.find("close") != std::string::npos) ? false
+		: (ConnectionValue.find("keep-alive") != std::string::npos) ? true : bHttp11;
+
+	const std::string* TransferEncoding = Response.FindHeader("transfer-encoding");
+	const std::string* ContentLength = Response.FindHeader("content-length");
+
+	if (Method == "HEAD" || Response.StatusCode == 204 || Response.StatusCode == 304) {
+		// No body.
+	} else if (TransferEncoding && ToLower(*TransferEncoding).find("chunked") != std::string::npos) {
+		for (;;) {
+			const std::string SizeLine = ReadLine();
+			char* End = nullptr;
+			const unsigned long long ChunkSize = std::strtoull(SizeLine.c_str(), &End, 16);
+			if (End == SizeLine.c_str()) {
+				throw std::runtime_error("HttpConnection: malformed chunk size from " + Origin.Host);
+			}
+			if (ChunkSize == 0) {
+				while (!ReadLine().empty()) {
+					// Trailer fields are ignored.
+				}
+				break;
+			}
+			ReadExactly(static_cast<std::size_t>(ChunkSize), Response.Body);
+			ReadLine();
+		}
+	} else if (ContentLength) {
+		ReadExactly(static_cast<std::size_t>(std::strtoull(ContentLength->c_str(), nullptr, 10)), Response.Body);
+	} else {
+		while (Receive()) {
+			if (Pending.size() > MaxBodyBytes) {
+				throw std::runtime_error("HttpConnection: response body from " + Origin.Host + " is too large");
+			}
+		}
+		Response.Body += Pending;
+		Pending.clear();
+		Response.bKeepAlive = false;
+	}
+
+	bReusable = Response.bKeepAlive;
+	return Response;
+}
+
+} // namespace WebScraping
@@ -0,0 +1,93 @@
+#ifndef __HttpClient__
+#define __HttpClient__
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+/* HTTP CLIENT */
+// Minimal blocking HTTP/1.1 client for the scraper: one HttpConnection is a
+// keep-alive socket to a single origin that sends requests in turn and
+// reads Content-Length, chunked and close-delimited bodies. https URLs need
+// the build to find OpenSSL (LEARNSCRAPE_TLS); peers are verified against
+// the system trust store. Responses are requested uncompressed.
+
+namespace WebScraping {
+
+using HeaderList = std::vector<std::pair<std::string, std::string>>;
+
+
+struct Url {
+	std::string Scheme;
+	std::string Host;
+	std::uint16_t Port = 0;
+	// Path and query, always starting with '/'.
+	std::string Target;
+
+	// Accepts http://host[:port][/target] and https://...; the fragment is
+	// dropped. Throws std::invalid_argument otherwise.
+	static Url Parse(const std::string& Text);
+
+	// Resolve a Location header (absolute, host-relative or path-relative).
+	Url Resolve(const std::string& Reference) const;
+
+	// "scheme://host:port": connections are pooled per origin.
+	std::string GetOrigin() const;
+	std::string ToString() const;
+};
+
+
+struct HttpResponse {
+	int StatusCode = 0;
+	// Header names are lower-cased; repeated headers keep every entry.
+	HeaderList Headers;
+	std::string Body;
+	// False when the server asked to close or the body ran to end of stream.
+	bool bKeepAlive = false;
+
+	// First value of the lower-case header Name, or nullptr.
+	const std::string* FindHeader(const std::string& Name) const;
+};
+
+
+class HttpConnection {
+private:
+	Url Origin;
+	int Descriptor;
+	void* Tls;
+	std::string Pending;
+	bool bReusable;
+	// No byte of the current response has arrived yet.
+	bool bAwaitingResponse;
+	bool bDroppedIdle;
+
+	void SendAll(const std::string& Data);
+	// Append more bytes to Pending; false at end of stream.
+	bool Receive();
+	std::string ReadLine();
+	void ReadExactly(std::size_t Size, std::string& Out);
+
+public:
+	// Connect to Origin's host and port, with TimeoutSeconds bounding the
+	// connect and every later read or write. Throws std::runtime_error.
+	HttpConnection(const Url& InOrigin, double TimeoutSeconds);
+	HttpConnection(const HttpConnection&) = delete;
+	HttpConnection& operator=(const HttpConnection&) = delete;
+	~HttpConnection();
+
+	// Send one request for Target (which must share this origin) and read
+	// the whole response. Throws std::runtime_error on network or protocol
+	// errors, after which the connection is not reusable.
+	HttpResponse Send(const std::string& Method, const Url& Target, const HeaderList& ExtraHeaders = {});
+
+	bool IsReusable() const { return bReusable; }
+	// True when the last Send failed because the peer had already closed
+	// the connection: end of stream or a reset came before any byte of the
+	// response. Resending on a fresh connection is then safe.
+	bool WasDroppedIdle() const { return bDroppedIdle; }
+};
+
+} // namespace WebScraping
+
+#endif // __HttpClient__
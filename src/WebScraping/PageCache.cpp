@@ -0,0 +1,601 @@
+#include "WebScraping/PageCache.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <unistd.h>
+
+#ifdef LEARNSCRAPE_ZLIB
+#include <zlib.h>
+#endif
+
+#include "CoreUtilities/ReportGeneration.h"
+
+namespace WebScraping {
+
+namespace {
+
+const char IndexMagic[] = "learnscrape-page-cache 1";
+const char ObjectMagic[8] = {'L', 'S', 'P', 'A', 'G', 'E', '1', '\0'};
+
+enum class Compression : std::uint8_t {
+	None = 0,
+	Zlib = 1
+};
+
+
+/*==============================================================================*/
+// SHA-256 (FIPS 180-4)
+/*==============================================================================*/
+const std::uint32_t RoundConstants[64] = {
+	0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+	0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+	0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+	0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+	0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+	0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+	0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+	0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+
+inline std::uint32_t RotateRight(std::uint32_t Value, unsigned Bits)
+{
+	return (Value >> Bits) | (Value << (32 - Bits));
+}
+
+
+void CompressBlock(std::array<std::uint32_t, 8>& State, const unsigned char* Block)
+{
+	std::uint32_t Schedule[64];
+	for (std::size_t Word = 0; Word < 16; Word++) {
+		Schedule[Word] = (std::uint32_t(Block[4 * Word]) << 24) | (std::uint32_t(Block[4 * Word + 1]) << 16) |
+		                 (std::uint32_t(Block[4 * Word + 2]) << 8) | std::uint32_t(Block[4 * Word + 3]);
+	}
+	for (std::size_t Word = 16; Word < 64; Word++) {
+		const std::uint32_t S0 = RotateRight(Schedule[Word - 15], 7) ^ RotateRight(Schedule[Word - 15], 18) ^ (Schedule[Word - 15] >> 3);
+		const std::uint32_t S1 = RotateRight(Schedule[Word - 2], 17) ^ RotateRight(Schedule[Word - 2], 19) ^ (Schedule[Word - 2] >> 10);
+		Schedule[Word] = Schedule[Word - 16] + S0 + Schedule[Word - 7] + S1;
+	}
+
+	std::uint32_t A = State[0], B = State[1], C = State[2], D = State[3];
+	std::uint32_t E = State[4], F = State[5], G = State[6], H = State[7];
+	for (std::size_t Round = 0; Round < 64; Round++) {
+		const std::uint32_t T1 = H + (RotateRight(E, 6) ^ RotateRight(E, 11) ^ RotateRight(E, 25)) + ((E & F) ^ (~E & G)) +
+		                         RoundConstants[Round] + Schedule[Round];
+		const std::uint32_t T2 = (RotateRight(A, 2) ^ RotateRight(A, 13) ^ RotateRight(A, 22)) + ((A & B) ^ (A & C) ^ (B & C));
+		H = G; G = F; F = E; E = D + T1;
+		D = C; C = B; B = A; A = T1 + T2;
+	}
+	State[0] += A; State[1] += B; State[2] += C; State[3] += D;
+	State[4] += E; State[5] += F; State[6] += G; State[7] += H;
+}
+
+
+/*==============================================================================*/
+// Object encoding
+/*==============================================================================*/
+void PutInteger(std::string& Out, std::uint64_t Value, std::size_t Bytes)
+{
+	for (std::size_t Byte = 0; Byte < Bytes; Byte++) {
+		Out.push_back(static_cast<char>((Value >> (8 * Byte)) & 0xff));
+	}
+}
+
+
+void PutString(std::string& Out, const std::string& Value)
+{
+	PutInteger(Out, Value.size(), 4);
+	Out += Value;
+}
+
+
+// Reads a little-endian object file, failing softly on truncation.
+class ObjectReader {
+private:
+	const std::string& Data;
+	std::size_t Position = 0;
+
+public:
+	explicit ObjectReader(const std::string& InData) : Data(InData) {}
+
+	bool Integer(std::uint64_t& Value, std::size_t Bytes)
+	{
+		if (Data.size() - Position < Bytes) {
+			return false;
+		}
+		Value = 0;
+		for (std::size_t Byte = 0; Byte < Bytes; Byte++) {
+			Value |= std::uint64_t(static_cast<unsigned char>(Data[Position++])) << (8 * Byte);
+		}
+		return true;
+	}
+
+	bool Bytes(std::string& Value, std::uint64_t Size)
+	{
+		if (Data.size() - Position < Size) {
+			return false;
+		}
+		Value.assign(Data, Position, static_cast<std::size_t>(Size));
+		Position += static_cast<std::size_t>(Size);
+		return true;
+	}
+
+	bool String(std::string& Value)
+	{
+		std::uint64_t Size;
+		return Integer(Size, 4) && Bytes(Value, Size);
+	}
+
+	bool Skip(std::uint64_t Size)
+	{
+		if (Data.size() - Position < Size) {
+			return false;
+		}
+		Position += static_cast<std::size_t>(Size);
+		return true;
+	}
+};
+
+
+bool ReadWholeFile(const std::string& Path, std::string& Data)
+{
+	std::ifstream File(Path, std::ios::binary);
+	if (!File) {
+		return false;
+	}
+	std::stringstream Buffer;
+	Buffer << File.rdbuf();
+	Data = Buffer.str();
+	return true;
+}
+
+
+// Write through a temporary file and rename it into place, so readers never
+// see a partial file.
+void WriteFileAtomically(const std::string& Path, const std::string& Data)
+{
+	static std::atomic<std::uint64_t> NextTemporary{0};
+	const std::string Temporary = Path + ".tmp" + std::to_string(::getpid()) + "." + std::to_string(NextTemporary++);
+	{
+		std::ofstream File(Temporary, std::ios::binary | std::ios::trunc);
+		File.write(Data.data(), static_cast<std::streamsize>(Data.size()));
+		if (!File) {
+			std::remove(Temporary.c_str());
+			throw std::runtime_error("PageCache: cannot write " + Temporary);
+		}
+	}
+	if (std::rename(Temporary.c_str(), Path.c_str()) != 0) {
+		std::remove(Temporary.c_str());
+		throw std::runtime_error("PageCache: cannot replace " + Path);
+	}
+}
+
+
+// Index fields are tab-separated, so values holding tabs or newlines are
+// not cached.
+bool IsIndexSafe(const std::string& Value)
+{
+	return Value.find_first_of("\t\r\n") == std::string::npos;
+}
+
+
+std::string HeaderOrEmpty(const HttpResponse& Response, const char* Name)
+{
+	const std::string* Value = Response.FindHeader(Name);
+	return Value ? *Value : std::string();
+}
+
+} // namespace
+
+
+std::string HashContent(const std::string& Data)
+{
+	std::array<std::uint32_t, 8> State = {
+		0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+	};
+	const unsigned char* Bytes = reinterpret_cast<const unsigned char*>(Data.data());
+	const std::size_t NumWhole = Data.size() / 64;
+	for (std::size_t Block = 0; Block < NumWhole; Block++) {
+		CompressBlock(State, Bytes + 64 * Block);
+	}
+
+	// Pad with 0x80, zeros and the bit length into one or two final blocks.
+	unsigned char Tail[128] = {};
+	const std::size_t Remainder = Data.size() - 64 * NumWhole;
+	std::memcpy(Tail, Bytes + 64 * NumWhole, Remainder);
+	Tail[Remainder] = 0x80;
+	const std::size_t TailSize = (Remainder < 56) ? 64 : 128;
+	const std::uint64_t BitLength = std::uint64_t(Data.size()) * 8;
+	for (std::size_t Byte = 0; Byte < 8; Byte++) {
+		Tail[TailSize - 1 - Byte] = static_cast<unsigned char>(BitLength >> (8 * Byte));
+	}
+	for (std::size_t Offset = 0; Offset < TailSize; Offset += 64) {
+		CompressBlock(State, Tail + Offset);
+	}
+
+	char Hex[65];
+	for (std::size_t Word = 0; Word < 8; Word++) {
+		std::snprintf(Hex + 8 * Word, 9, "%08x", State[Word]);
+	}
+	return std::string(Hex, 64);
+}
+
+
+PageCache::PageCache(std::string InDirectory, CacheOptions InOptions)
+	: Directory(std::move(InDirectory)), Options(InOptions)
+{
+	std::error_code Error;
+	std::filesystem::create_directories(Directory + "/objects", Error);
+	if (Error) {
+		throw std::runtime_error("PageCache: cannot create " + Directory + ": " + Error.message());
+	}
+	LoadIndex();
+}
+
+
+PageCache::~PageCache()
+{
+	try {
+		Flush();
+	} catch (const std::exception&) {
+		// The index is rebuilt from scratch next run at worst.
+	}
+}
+
+
+std::string PageCache::GetObjectPath(const std::string& ContentHash) const
+{
+	return Directory + "/objects/" + ContentHash.substr(0, 2) + "/" + ContentHash;
+}
+
+
+/*==============================================================================*/
+// Object store
+/*==============================================================================*/
+// Object file: magic, compression byte, raw and stored body sizes, the
+// stored body, then the field count and each field's name and value.
+void PageCache::WriteObject(const std::string& ContentHash, const std::string& Body, const ScrapedRecord& Record,
+                            std::uint64_t& Bytes) const
+{
+	Compression Method = Compression::None;
+	std::string Stored;
+#ifdef LEARNSCRAPE_ZLIB
+	uLongf StoredSize = compressBound(static_cast<uLong>(Body.size()));
+	Stored.resize(StoredSize);
+	if (compress2(reinterpret_cast<Bytef*>(&Stored[0]), &StoredSize, reinterpret_cast<const Bytef*>(Body.data()),
+	              static_cast<uLong>(Body.size()), 6) == Z_OK && StoredSize < Body.size()) {
+		Stored.resize(StoredSize);
+		Method = Compression::Zlib;
+	}
+#endif
+	if (Method == Compression::None) {
+		Stored = Body;
+	}
+
+	std::string Data(ObjectMagic, sizeof(ObjectMagic));
+	Data.push_back(static_cast<char>(Method));
+	PutInteger(Data, Body.size(), 8);
+	PutInteger(Data, Stored.size(), 8);
+	Data += Stored;
+	PutInteger(Data, Record.Fields.size(), 4);
+	for (const auto& Field : Record.Fields) {
+		PutString(Data, Field.first);
+		PutString(Data, Field.second);
+	}
+
+	const std::string Path = GetObjectPath(ContentHash);
+	std::error_code Error;
+	std::filesystem::create_directories(Path.substr(0, Path.rfind('/')), Error);
+	WriteFileAtomically(Path, Data);
+	Bytes = Data.size();
+}
+
+
+bool PageCache::ReadObject(const std::string& ContentHash, std::string* Body, ScrapedRecord* Record) const
+{
+	std::string Data;
+	if (!ReadWholeFile(GetObjectPath(ContentHash), Data) || Data.compare(0, sizeof(ObjectMagic), ObjectMagic, sizeof(ObjectMagic)) != 0) {
+		return false;
+	}
+	ObjectReader Reader(Data);
+	std::uint64_t Method, RawSize, StoredSize;
+	if (!Reader.Skip(sizeof(ObjectMagic)) || !Reader.Integer(Method, 1) || !Reader.Integer(RawSize, 8) ||
+	    !Reader.Integer(StoredSize, 8)) {
+		return false;
+	}
+
+	if (Body != nullptr) {
+		std::string Stored;
+		if (!Reader.Bytes(Stored, StoredSize)) {
+			return false;
+		}
+		if (Method == static_cast<std::uint64_t>(Compression::None)) {
+			*Body = std::move(Stored);
+		} else {
+#ifdef LEARNSCRAPE_ZLIB
+			Body->resize(static_cast<std::size_t>(RawSize));
+			uLongf Size = static_cast<uLongf>(RawSize);
+			if (Method != static_cast<std::uint64_t>(Compression::Zlib) ||
+			    uncompress(reinterpret_cast<Bytef*>(&(*Body)[0]), &Size, reinterpret_cast<const Bytef*>(Stored.data()),
+			               static_cast<uLong>(Stored.size())) != Z_OK || Size != RawSize) {
+				return false;
+			}
+#else
+			return false;
+#endif
+		}
+	} else if (!Reader.Skip(StoredSize)) {
+		return false;
+	}
+
+	if (Record != nullptr) {
+		std::uint64_t NumFields;
+		if (!Reader.Integer(NumFields, 4)) {
+			return false;
+		}
+		Record->Fields.clear();
+		for (std::uint64_t Field = 0; Field < NumFields; Field++) {
+			std::string Name, Value;
+			if (!Reader.String(Name) || !Reader.String(Value)) {
+				return false;
+			}
+			Record->Fields.emplace_back(std::move(Name), std::move(Value));
+		}
+		Record->Error.clear();
+	}
+	return true;
+}
+
+
+/*==============================================================================*/
+// Index
+/*==============================================================================*/
+// Index file: a magic line, then one tab-separated line per URL with its
+// content hash, final URL, content type, validators, store time and last
+// use. Entries whose object has gone are dropped.
+void PageCache::LoadIndex()
+{
+	std::ifstream File(Directory + "/index");
+	std::string Line;
+	if (!File || !std::getline(File, Line) || Line != IndexMagic) {
+		return;
+	}
+
+	while (std::getline(File, Line)) {
+		std::vector<std::string> Cells;
+		std::stringstream Fields(Line);
+		for (std::string Cell; std::getline(Fields, Cell, '\t');) {
+			Cells.push_back(Cell);
+		}
+		Cells.resize(std::max<std::size_t>(Cells.size(), 8));
+		if (Cells[0].empty() || Cells[1].size() != 64) {
+			continue;
+		}
+
+		Object& Stored = Objects[Cells[1]];
+		if (Stored.References == 0) {
+			std::error_code Error;
+			Stored.Bytes = std::filesystem::file_size(GetObjectPath(Cells[1]), Error);
+			if (Error) {
+				Objects.erase(Cells[1]);
+				continue;
+			}
+			StoredBytes += Stored.Bytes;
+		}
+		Stored.References++;
+
+		Entry& Loaded = Entries[Cells[0]];
+		Loaded.ContentHash = Cells[1];
+		Loaded.FinalUrl = Cells[2].empty() ? Cells[0] : Cells[2];
+		Loaded.ContentType = Cells[3];
+		Loaded.ETag = Cells[4];
+		Loaded.LastModified = Cells[5];
+		Loaded.StoredAt = std::atoll(Cells[6].c_str());
+		Loaded.LastUsed = std::strtoull(Cells[7].c_str(), nullptr, 10);
+		UseClock = std::max(UseClock, Loaded.LastUsed);
+	}
+	// The budget may have shrunk since the last run.
+	EvictToBudget();
+}
+
+
+void PageCache::Flush()
+{
+	std::lock_guard<std::mutex> Guard(Lock);
+	if (!bDirty) {
+		return;
+	}
+	std::string Data = std::string(IndexMagic) + "\n";
+	for (const auto& Cached : Entries) {
+		const Entry& Value = Cached.second;
+		Data += Cached.first + '\t' + Value.ContentHash + '\t' + Value.FinalUrl + '\t' + Value.ContentType + '\t' +
+		        Value.ETag + '\t' + Value.LastModified + '\t' + std::to_string(Value.StoredAt) + '\t' +
+		        std::to_string(Value.LastUsed) + '\n';
+	}
+	WriteFileAtomically(Directory + "/index", Data);
+	bDirty = false;
+}
+
+
+void PageCache::Touch(Entry& Found)
+{
+	Found.LastUsed = ++UseClock;
+	bDirty = true;
+}
+
+
+void PageCache::Release(const std::string& ContentHash)
+{
+	const auto Stored = Objects.find(ContentHash);
+	if (Stored == Objects.end() || --Stored->second.References > 0) {
+		return;
+	}
+	std::remove(GetObjectPath(ContentHash).c_str());
+	StoredBytes -= Stored->second.Bytes;
+	Objects.erase(Stored);
+}
+
+
+void PageCache::EvictToBudget()
+{
+	while (StoredBytes > Options.MaxBytes && !Entries.empty()) {
+		auto Oldest = Entries.begin();
+		for (auto Cached = Entries.begin(); Cached != Entries.end(); ++Cached) {
+			if (Cached->second.LastUsed < Oldest->second.LastUsed) {
+				Oldest = Cached;
+			}
+		}
+		Release(Oldest->second.ContentHash);
+		Entries.erase(Oldest);
+		bDirty = true;
+	}
+}
+
+
+/*==============================================================================*/
+// Pipeline stages
+/*==============================================================================*/
+bool PageCache::Fetch(PageFetcher& Fetcher, const std::string& Address, FetchedPage& Page, ScrapedRecord& Record)
+{
+	Entry Cached;
+	bool bFound;
+	{
+		std::lock_guard<std::mutex> Guard(Lock);
+		const auto Found = Entries.find(Address);
+		bFound = Found != Entries.end();
+		if (bFound) {
+			Cached = Found->second;
+		}
+	}
+
+	if (bFound) {
+		const std::int64_t Now = static_cast<std::int64_t>(std::time(nullptr));
+		if (static_cast<double>(Now - Cached.StoredAt) >= Options.FreshSeconds) {
+			HeaderList Validators;
+			if (!Cached.ETag.empty()) {
+				Validators.emplace_back("If-None-Match", Cached.ETag);
+			}
+			if (!Cached.LastModified.empty()) {
+				Validators.emplace_back("If-Modified-Since", Cached.LastModified);
+			}
+			if (Validators.empty()) {
+				Page = Fetcher.Fetch(Address);
+				return false;
+			}
+			Page = Fetcher.Fetch(Address, Validators);
+			if (Page.Response.StatusCode != 304) {
+				return false;
+			}
+		}
+
+		// The object may have been evicted since the lookup; then fall back
+		// to a full fetch.
+		if (ReadObject(Cached.ContentHash, nullptr, &Record)) {
+			Record.Url = Cached.FinalUrl;
+			{
+				std::lock_guard<std::mutex> Guard(Lock);
+				const auto Found = Entries.find(Address);
+				if (Found != Entries.end()) {
+					Found->second.StoredAt = (Page.Response.StatusCode == 304) ? Now : Found->second.StoredAt;
+					Touch(Found->second);
+				}
+			}
+			LEARNSCRAPE_COUNT(CoreUtilities::ReportCounter::CacheHits, 1);
+			return true;
+		}
+	}
+
+	Page = Fetcher.Fetch(Address);
+	return false;
+}
+
+
+ScrapedRecord PageCache::Extract(const FetchedPage& Page)
+{
+	if (!Page.IsOk()) {
+		return ExtractFields(Page);
+	}
+
+	const std::string ContentHash = HashContent(Page.Response.Body);
+	bool bKnown;
+	{
+		std::lock_guard<std::mutex> Guard(Lock);
+		bKnown = Objects.count(ContentHash) != 0;
+	}
+
+	ScrapedRecord Record;
+	std::uint64_t Bytes = 0;
+	if (bKnown && ReadObject(ContentHash, nullptr, &Record)) {
+		Record.Url = Page.FinalUrl;
+		LEARNSCRAPE_COUNT(CoreUtilities::ReportCounter::CacheHits, 1);
+	} else {
+		LEARNSCRAPE_COUNT(CoreUtilities::ReportCounter::CacheMisses, 1);
+		Record = ExtractFields(Page);
+		if (!Record.Error.empty()) {
+			return Record;
+		}
+		WriteObject(ContentHash, Page.Response.Body, Record, Bytes);
+	}
+
+	Entry Stored;
+	Stored.ContentHash = ContentHash;
+	Stored.FinalUrl = Page.FinalUrl;
+	Stored.ContentType = HeaderOrEmpty(Page.Response, "content-type");
+	Stored.ETag = HeaderOrEmpty(Page.Response, "etag");
+	Stored.LastModified = HeaderOrEmpty(Page.Response, "last-modified");
+	Stored.StoredAt = static_cast<std::int64_t>(std::time(nullptr));
+	if (!IsIndexSafe(Page.RequestedUrl) || !IsIndexSafe(Stored.FinalUrl) || !IsIndexSafe(Stored.ContentType) ||
+	    !IsIndexSafe(Stored.ETag) || !IsIndexSafe(Stored.LastModified)) {
+		return Record;
+	}
+
+	std::lock_guard<std::mutex> Guard(Lock);
+	auto Target = Objects.find(ContentHash);
+	if (Target == Objects.end()) {
+		if (Bytes == 0) {
+			// The object reused above was evicted meanwhile.
+			return Record;
+		}
+		// Otherwise a concurrent Extract of the same body may already have
+		// registered it.
+		Target = Objects.emplace(ContentHash, Object{Bytes, 0}).first;
+		StoredBytes += Bytes;
+	}
+	Target->second.References++;
+
+	const auto Previous = Entries.find(Page.RequestedUrl);
+	if (Previous != Entries.end()) {
+		Release(Previous->second.ContentHash);
+	}
+	Touch(Entries[Page.RequestedUrl] = Stored);
+	EvictToBudget();
+	return Record;
+}
+
+
+std::size_t PageCache::GetNumEntries() const
+{
+	std::lock_guard<std::mutex> Guard(Lock);
+	return Entries.size();
+}
+
+
+std::uint64_t PageCache::GetStoredBytes() const
+{
+	std::lock_guard<std::mutex> Guard(Lock);
+	return StoredBytes;
+}
+
+} // namespace WebScraping
@@ -0,0 +1,107 @@
+#ifndef __PageCache__
+#define __PageCache__
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+
+#include "WebScraping/PageFetcher.h"
+#include "WebScraping/RecordExtraction.h"
+
+/* PAGE CACHE */
+// On-disk cache that lets a repeated scrape skip unchanged pages. Two
+// layers:
+// - Per URL, the index keeps the ETag / Last-Modified validators and the
+//   SHA-256 of the body last seen there. A later fetch sends them as
+//   If-None-Match / If-Modified-Since, and a 304 reply is answered from
+//   disk without downloading or parsing the page.
+// - Per content hash, an object file holds the raw body (zlib-compressed
+//   when the build finds zlib) and the fields extracted from it. A page
+//   whose validators changed but whose body did not is still not
+//   re-parsed, and identical pages under several URLs are stored once.
+// Entries are evicted least recently used first once the objects exceed
+// CacheOptions::MaxBytes. One cache may be shared by every worker of a
+// ScrapePipeline.
+
+namespace WebScraping {
+
+struct CacheOptions {
+	std::uint64_t MaxBytes = std::uint64_t(1) << 30;
+	// Entries younger than this are used without asking the server at all.
+	double FreshSeconds = 0.0;
+};
+
+
+class PageCache {
+private:
+	struct Entry {
+		std::string ContentHash;
+		std::string FinalUrl;
+		std::string ContentType;
+		std::string ETag;
+		std::string LastModified;
+		std::int64_t StoredAt = 0;
+		std::uint64_t LastUsed = 0;
+	};
+
+	struct Object {
+		std::uint64_t Bytes = 0;
+		std::size_t References = 0;
+	};
+
+	std::string Directory;
+	CacheOptions Options;
+
+	mutable std::mutex Lock;
+	std::map<std::string, Entry> Entries;
+	std::map<std::string, Object> Objects;
+	std::uint64_t StoredBytes = 0;
+	std::uint64_t UseClock = 0;
+	bool bDirty = false;
+
+	std::string GetObjectPath(const std::string& ContentHash) const;
+	bool ReadObject(const std::string& ContentHash, std::string* Body, ScrapedRecord* Record) const;
+	void WriteObject(const std::string& ContentHash, const std::string& Body, const ScrapedRecord& Record,
+	                 std::uint64_t& Bytes) const;
+
+	// Callers hold Lock.
+	void Touch(Entry& Found);
+	void Release(const std::string& ContentHash);
+	void EvictToBudget();
+	void LoadIndex();
+
+public:
+	// Open or create the cache in Directory. Throws std::runtime_error if
+	// the directory cannot be created.
+	explicit PageCache(std::string InDirectory, CacheOptions InOptions = CacheOptions());
+	PageCache(const PageCache&) = delete;
+	PageCache& operator=(const PageCache&) = delete;
+	// Flushes the index.
+	~PageCache();
+
+	// Fetch stage: fetch Address through Fetcher, revalidating any cached
+	// copy. Returns true with Record filled when the cached record is still
+	// current (fresh, or the server answered 304); otherwise Page holds the
+	// fetched response for Extract.
+	bool Fetch(PageFetcher& Fetcher, const std::string& Address, FetchedPage& Page, ScrapedRecord& Record);
+
+	// Parse stage: the fields of Page, reused from the object store when the
+	// same body was parsed before and extracted (then stored) otherwise.
+	// Failed pages are not cached.
+	ScrapedRecord Extract(const FetchedPage& Page);
+
+	// Write the index so the next run sees this run's entries.
+	void Flush();
+
+	std::size_t GetNumEntries() const;
+	std::uint64_t GetStoredBytes() const;
+};
+
+// Lower-case hex SHA-256 of Data.
+std::string HashContent(const std::string& Data);
+
+} // namespace WebScraping
+
+#endif // __PageCache__
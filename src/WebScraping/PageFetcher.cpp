@@ -0,0 +1,155 @@
+#include "WebScraping/PageFetcher.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+#include "CoreUtilities/ReportGeneration.h"
+
+namespace WebScraping {
+
+namespace {
+
+bool IsRedirect(int StatusCode)
+{
+	return StatusCode == 301 || StatusCode == 302 || StatusCode == 303 || StatusCode == 307 || StatusCode == 308;
+}
+
+
+bool IsRetryable(int StatusCode)
+{
+	return StatusCode == 429 || (StatusCode >= 500 && StatusCode != 501);
+}
+
+} // namespace
+
+
+PageFetcher::PageFetcher(FetchOptions InOptions, unsigned Seed)
+	: Options(InOptions), Generator(Seed)
+{
+	if (Options.MaxAttempts == 0) {
+		throw std::invalid_argument("PageFetcher: need at least one attempt");
+	}
+}
+
+
+HttpResponse PageFetcher::SendOnce(const Url& Target, const HeaderList& ExtraHeaders)
+{
+	const std::string Origin = Target.GetOrigin();
+	std::unique_ptr<HttpConnection>& Connection = Connections[Origin];
+
+	if (Connection) {
+		try {
+			HttpResponse Response = Connection->Send("GET", Target, ExtraHeaders);
+			if (!Connection->IsReusable()) {
+				Connection.reset();
+			}
+			return Response;
+		} catch (const std::runtime_error&) {
+			// Only a connection the server dropped while idle is retried at
+			// once: it closed without answering, so resending is safe.
+			const bool bDroppedIdle = Connection->WasDroppedIdle();
+			Connection.reset();
+			if (!bDroppedIdle) {
+				throw;
+			}
+		}
+	}
+
+	Connection.reset(new HttpConnection(Target, Options.TimeoutSeconds));
+	try {
+		HttpResponse Response = Connection->Send("GET", Target, ExtraHeaders);
+		if (!Connection->IsReusable()) {
+			Connection.reset();
+		}
+		return Response;
+	} catch (...) {
+		Connection.reset();
+		throw;
+	}
+}
+
+
+double PageFetcher::BackoffSeconds(std::size_t Attempt, const HttpResponse* Response)
+{
+	if (Response != nullptr) {
+		const std::string* RetryAfter = Response->FindHeader("retry-after");
+		char* End = nullptr;
+		const double Seconds = RetryAfter ? std::strtod(RetryAfter->c_str(), &End) : 0.0;
+		if (RetryAfter && End != RetryAfter->c_str() && Seconds >= 0.0) {
+			return std::min(Seconds, Options.MaxBackoffSeconds);
+		}
+	}
+	// Full jitter over an exponentially growing window.
+	const double Window = std::min(Options.MaxBackoffSeconds,
+	                               Options.InitialBackoffSeconds * std::pow(2.0, static_cast<double>(Attempt - 1)));
+	return std::uniform_real_distribution<double>(0.5 * Window, Window)(Generator);
+}
+
+
+FetchedPage PageFetcher::Fetch(const std::string& Address, const HeaderList& ExtraHeaders)
+{
+	LEARNSCRAPE_SCOPED_TIMER(CoreUtilities::ReportPhase::Fetch);
+
+	FetchedPage Page;
+	Page.RequestedUrl = Address;
+	Page.FinalUrl = Address;
+
+	Url Target;
+	try {
+		Target = Url::Parse(Address);
+	} catch (const std::invalid_argument& Error) {
+		Page.Error = Error.what();
+		return Page;
+	}
+
+	std::size_t Redirects = 0;
+	while (Page.Attempts < Options.MaxAttempts) {
+		Page.Attempts++;
+		Page.Error.clear();
+		bool bRetry = false;
+
+		try {
+			Page.Response = SendOnce(Target, ExtraHeaders);
+			const std::string* Location = Page.Response.FindHeader("location");
+
+			if (IsRedirect(Page.Response.StatusCode) && Location != nullptr) {
+				if (Redirects++ == Options.MaxRedirects) {
+					Page.Error = "too many redirects";
+					return Page;
+				}
+				Target = Target.Resolve(*Location);
+				Page.FinalUrl = Target.ToString();
+				// A redirect is not a failed attempt.
+				Page.Attempts--;
+				continue;
+			}
+			bRetry = IsRetryable(Page.Response.StatusCode);
+			if (bRetry) {
+				Page.Error = "HTTP " + std::to_string(Page.Response.StatusCode);
+			}
+		} catch (const std::exception& Error) {
+			Page.Response = HttpResponse();
+			Page.Error = Error.what();
+			bRetry = true;
+		}
+
+		if (!bRetry) {
+			break;
+		}
+		if (Page.Attempts < Options.MaxAttempts) {
+			LEARNSCRAPE_COUNT(CoreUtilities::ReportCounter::FetchRetries, 1);
+			const double Delay = BackoffSeconds(Page.Attempts, Page.Response.StatusCode ? &Page.Response : nullptr);
+			std::this_thread::sleep_for(std::chrono::duration<double>(Delay));
+		}
+	}
+
+	LEARNSCRAPE_RECORD_VOLUME(CoreUtilities::ReportPhase::Fetch, 1, Page.Response.Body.size());
+	return Page;
+}
+
+} // namespace WebScraping
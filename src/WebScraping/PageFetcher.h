@@ -0,0 +1,67 @@
+#ifndef __PageFetcher__
+#define __PageFetcher__
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+
+#include "WebScraping/HttpClient.h"
+
+/* PAGE FETCHER */
+// Fetch stage of the scraper. A PageFetcher keeps one keep-alive connection
+// per origin and retries failed fetches: connection errors, 429 and 5xx
+// responses back off exponentially (with jitter, or as long as Retry-After
+// asks), and redirects are followed. A fetcher is used by one thread; the
+// pipeline bounds concurrency by running MaxConnections of them.
+
+namespace WebScraping {
+
+struct FetchOptions {
+	// Concurrent fetches, one worker and connection pool each.
+	std::size_t MaxConnections = 8;
+	std::size_t MaxAttempts = 4;
+	double InitialBackoffSeconds = 0.5;
+	double MaxBackoffSeconds = 30.0;
+	double TimeoutSeconds = 30.0;
+	std::size_t MaxRedirects = 5;
+};
+
+
+struct FetchedPage {
+	std::string RequestedUrl;
+	// After redirects.
+	std::string FinalUrl;
+	HttpResponse Response;
+	std::size_t Attempts = 0;
+	// Empty on success; otherwise why the last attempt failed.
+	std::string Error;
+
+	bool IsOk() const { return Error.empty() && Response.StatusCode >= 200 && Response.StatusCode < 300; }
+};
+
+
+class PageFetcher {
+private:
+	FetchOptions Options;
+	std::map<std::string, std::unique_ptr<HttpConnection>> Connections;
+	std::mt19937 Generator;
+
+	// One request on a pooled connection. A keep-alive connection the server
+	// closed while idle is replaced once before the failure counts as an
+	// attempt; any other failure, a timeout included, is thrown.
+	HttpResponse SendOnce(const Url& Target, const HeaderList& ExtraHeaders);
+	double BackoffSeconds(std::size_t Attempt, const HttpResponse* Response);
+
+public:
+	explicit PageFetcher(FetchOptions InOptions = FetchOptions(), unsigned Seed = 0);
+
+	// GET Address with redirects and retries. Never throws for network or
+	// HTTP failures; they are reported in the page's Error and StatusCode.
+	FetchedPage Fetch(const std::string& Address, const HeaderList& ExtraHeaders = {});
+};
+
+} // namespace WebScraping
+
+#endif // __PageFetcher__
@@ -0,0 +1,531 @@
+#include "WebScraping/RecordExtraction.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+#include "CoreUtilities/ReportGeneration.h"
+
+namespace WebScraping {
+
+namespace {
+
+const std::size_t MaxJsonDepth = 256;
+
+
+bool EqualsIgnoringCase(const std::string& Left, const char* Right, std::size_t Length)
+{
+	if (Left.size() < Length) {
+		return false;
+	}
+	for (std::size_t Index = 0; Index < Length; Index++) {
+		if (std::tolower(static_cast<unsigned char>(Left[Index])) != std::tolower(static_cast<unsigned char>(Right[Index]))) {
+			return false;
+		}
+	}
+	return true;
+}
+
+
+void AppendUtf8(std::uint32_t CodePoint, std::string& Out)
+{
+	if (CodePoint < 0x80) {
+		Out += static_cast<char>(CodePoint);
+	} else if (CodePoint < 0x800) {
+		Out += static_cast<char>(0xC0 | (CodePoint >> 6));
+		Out += static_cast<char>(0x80 | (CodePoint & 0x3F));
+	} else if (CodePoint < 0x10000) {
+		Out += static_cast<char>(0xE0 | (CodePoint >> 12));
+		Out += static_cast<char>(0x80 | ((CodePoint >> 6) & 0x3F));
+		Out += static_cast<char>(0x80 | (CodePoint & 0x3F));
+	} else {
+		Out += static_cast<char>(0xF0 | (CodePoint >> 18));
+		Out += static_cast<char>(0x80 | ((CodePoint >> 12) & 0x3F));
+		Out += static_cast<char>(0x80 | ((CodePoint >> 6) & 0x3F));
+		Out += static_cast<char>(0x80 | (CodePoint & 0x3F));
+	}
+}
+
+
+/*============================================================================*/
+// HTML
+/*============================================================================*/
+
+struct NamedEntity {
+	const char* Name;
+	std::uint32_t CodePoint;
+};
+
+const NamedEntity NamedEntities[] = {
+	{"amp", '&'}, {"lt", '<'}, {"gt", '>'}, {"quot", '"'}, {"apos", '\''}, {"nbsp", 0xA0},
+	{"minus", 0x2212}, {"times", 0xD7}, {"deg", 0xB0}, {"plusmn", 0xB1}, {"ndash", 0x2013}, {"mdash", 0x2014}
+};
+
+
+// Decode character references and collapse whitespace (including U+00A0).
+std::string NormaliseText(const std::string& Raw)
+{
+	std::string Decoded;
+	Decoded.reserve(Raw.size());
+	for (std::size_t Position = 0; Position < Raw.size(); Position++) {
+		const std::size_t Semicolon = (Raw[Position] == '&') ? Raw.find(';', Position) : std::string::npos;
+		if (Semicolon == std::string::npos || Semicolon - Position > 10) {
+			Decoded += Raw[Position];
+			continue;
+		}
+
+		const std::string Name = Raw.substr(Position + 1, Semicolon - Position - 1);
+		std::uint32_t CodePoint = 0;
+		if (!Name.empty() && Name[0] == '#') {
+			const bool bHex = Name.size() > 1 && (Name[1] == 'x' || Name[1] == 'X');
+			CodePoint = static_cast<std::uint32_t>(std::strtoul(Name.c_str() + (bHex ? 2 : 1), nullptr, bHex ? 16 : 10));
+		} else {
+			for (const NamedEntity& Entity : NamedEntities) {
+				if (Name == Entity.Name) {
+					CodePoint = Entity.CodePoint;
+				}
+			}
+		}
+		if (CodePoint == 0 || CodePoint > 0x10FFFF) {
+			Decoded += Raw[Position];
+			continue;
+		}
+		AppendUtf8(CodePoint, Decoded);
+		Position = Semicolon;
+	}
+
+	std::string Text;
+	Text.reserve(Decoded.size());
+	bool bSpace = false;
+	for (std::size_t Position = 0; Position < Decoded.size(); Position++) {
+		const bool bNoBreak = Decoded.compare(Position, 2, "\xC2\xA0") == 0;
+		if (bNoBreak || std::isspace(static_cast<unsigned char>(Decoded[Position]))) {
+			bSpace = !Text.empty();
+			Position += bNoBreak ? 1 : 0;
+			continue;
+		}
+		if (bSpace) {
+			Text += ' ';
+			bSpace = false;
+		}
+		Text += Decoded[Position];
+	}
+	return Text;
+}
+
+
+// Cells of the row being read in one (possibly nested) table.
+struct TableState {
+	std::vector<std::string> Cells;
+	bool bInCell = false;
+};
+
+
+void FinishRow(TableState& Table, ScrapedRecord& Record)
+{
+	if (Table.Cells.size() >= 2) {
+		std::string Name = NormaliseText(Table.Cells[0]);
+		std::string Value = NormaliseText(Table.Cells[1]);
+		if (!Name.empty() && !Value.empty()) {
+			Record.Fields.emplace_back(std::move(Name), std::move(Value));
+		}
+	}
+	Table.Cells.clear();
+	Table.bInCell = false;
+}
+
+
+// Position just past the '>' closing the tag that starts at Open, honouring
+// quoted attribute values.
+std::size_t FindTagEnd(const std::string& Html, std::size_t Open)
+{
+	char Quote = 0;
+	for (std::size_t Position = Open + 1; Position < Html.size(); Position++) {
+		const char Character = Html[Position];
+		if (Quote != 0) {
+			Quote = (Character == Quote) ? 0 : Quote;
+		} else if (Character == '"' || Character == '\'') {
+			Quote = Character;
+		} else if (Character == '>') {
+			return Position + 1;
+		}
+	}
+	return Html.size();
+}
+
+
+// Position of the closing tag </Name> at or after From (or the end).
+std::size_t FindClosingTag(const std::string& Html, std::size_t From, const std::string& Name)
+{
+	for (std::size_t Position = Html.find("</", From); Position != std::string::npos;
+	     Position = Html.find("</", Position + 2)) {
+		if (EqualsIgnoringCase(Html.substr(Position + 2, Name.size()), Name.c_str(), Name.size())) {
+			return Position;
+		}
+	}
+	return Html.size();
+}
+
+
+/*============================================================================*/
+// JSON
+/*============================================================================*/
+
+class JsonFlattener {
+private:
+	const std::string& Text;
+	std::size_t Position;
+	ScrapedRecord& Record;
+
+	[[noreturn]] void Fail(const std::string& What) const
+	{
+		throw std::invalid_argument("ExtractJsonFields: " + What + " at byte " + std::to_string(Position));
+	}
+
+	void SkipSpace()
+	{
+		while (Position < Text.size() && std::isspace(static_cast<unsigned char>(Text[Position]))) {
+			Position++;
+		}
+	}
+
+	bool Consume(char Expected)
+	{
+		SkipSpace();
+		if (Position < Text.size() && Text[Position] == Expected) {
+			Position++;
+			return true;
+		}
+		return false;
+	}
+
+	std::uint32_t ParseHex4()
+	{
+		if (Position + 4 > Text.size()) {
+			Fail("truncated \\u escape");
+		}
+		char* End = nullptr;
+		const std::string Digits = Text.substr(Position, 4);
+		const std::uint32_t Value = static_cast<std::uint32_t>(std::strtoul(Digits.c_str(), &End, 16));
+		if (End != Digits.c_str() + 4) {
+			Fail("bad \\u escape");
+		}
+		Position += 4;
+		return Value;
+	}
+
+	std::string ParseString()
+	{
+		if (!Consume('"')) {
+			Fail("expected string");
+		}
+		std::string Value;
+		while (Position < Text.size() && Text[Position] != '"') {
+			const char Character = Text[Position++];
+			if (Character != '\\') {
+				Value += Character;
+				continue;
+			}
+			if (Position >= Text.size()) {
+				Fail("truncated escape");
+			}
+			const char Escape = Text[Position++];
+			switch (Escape) {
+			case 'b': Value += '\b'; break;
+			case 'f': Value += '\f'; break;
+			case 'n': Value += '\n'; break;
+			case 'r': Value += '\r'; break;
+			case 't': Value += '\t'; break;
+			case 'u': {
+				std::uint32_t CodePoint = ParseHex4();
+				if (CodePoint >= 0xD800 && CodePoint < 0xDC00 && Text.compare(Position, 2, "\\u") == 0) {
+					Position += 2;
+					const std::uint32_t Low = ParseHex4();
+					CodePoint = 0x10000 + ((CodePoint - 0xD800) << 10) + (Low - 0xDC00);
+				}
+				AppendUtf8(CodePoint, Value);
+				break;
+			}
+			default: Value += Escape; break;
+			}
+		}
+		if (Position >= Text.size()) {
+			Fail("unterminated string");
+		}
+		Position++;
+		return Value;
+	}
+
+	void ParseValue(const std::string& Path, std::size_t Depth)
+	{
+		if (Depth > MaxJsonDepth) {
+			Fail("nesting too deep");
+		}
+		SkipSpace();
+		if (Position >= Text.size()) {
+			Fail("unexpected end");
+		}
+
+		const char Character = Text[Position];
+		if (Character == '{') {
+			Position++;
+			if (Consume('}')) {
+				return;
+			}
+			do {
+				const std::string Key = ParseString();
+				if (!Consume(':')) {
+					Fail("expected ':'");
+				}
+				ParseValue(Path.empty() ? Key : Path + "." + Key, Depth + 1);
+			} while (Consume(','));
+			if (!Consume('}')) {
+				Fail("expected '}'");
+			}
+		} else if (Character == '[') {
+			Position++;
+			if (Consume(']')) {
+				return;
+			}
+			std::size_t Element = 0;
+			do {
+				ParseValue(Path + "[" + std::to_string(Element++) + "]", Depth + 1);
+			} while (Consume(','));
+			if (!Consume(']')) {
+				Fail("expected ']'");
+			}
+		} else if (Character == '"') {
+			Record.Fields.emplace_back(Path.empty() ? "value" : Path, ParseString());
+		} else {
+			// Number, true, false or null: kept as written.
+			const std::size_t Start = Position;
+			while (Position < Text.size() && std::strchr(",]} \t\r\n", Text[Position]) == nullptr) {
+				Position++;
+			}
+			if (Position == Start) {
+				Fail("expected value");
+			}
+			Record.Fields.emplace_back(Path.empty() ? "value" : Path, Text.substr(Start, Position - Start));
+		}
+	}
+
+public:
+	JsonFlattener(const std::string& InText, ScrapedRecord& InRecord)
+		: Text(InText), Position(0), Record(InRecord)
+	{
+	}
+
+	void Run()
+	{
+		ParseValue("", 0);
+		SkipSpace();
+		if (Position != Text.size()) {
+			Fail("trailing characters");
+		}
+	}
+};
+
+} // namespace
+
+
+const std::string* ScrapedRecord::Find(const std::string& Name) const
+{
+	for (const auto& Field : Fields) {
+		if (Field.first.size() == Name.size() && EqualsIgnoringCase(Field.first, Name.c_str(), Name.size())) {
+			return &Field.second;
+		}
+	}
+	for (const auto& Field : Fields) {
+		if (Field.first.size() > Name.size() && EqualsIgnoringCase(Field.first, Name.c_str(), Name.size())
+		    && (Field.first[Name.size()] == ' ' || Field.first[Name.size()] == '(')) {
+			return &Field.second;
+		}
+	}
+	return nullptr;
+}
+
+
+ScrapedRecord ExtractHtmlFields(const std::string& Html)
+{
+	ScrapedRecord Record;
+	std::vector<TableState> Tables;
+
+	std::size_t Position = 0;
+	while (Position < Html.size()) {
+		const std::size_t Open = Html.find('<', Position);
+		const std::size_t TextEnd = (Open == std::string::npos) ? Html.size() : Open;
+		if (!Tables.empty() && Tables.back().bInCell && !Tables.back().Cells.empty()) {
+			Tables.back().Cells.back().append(Html, Position, TextEnd - Position);
+		}
+		if (Open == std::string::npos) {
+			break;
+		}
+
+		if (Html.compare(Open, 4, "<!--") == 0) {
+			const std::size_t Close = Html.find("-->", Open + 4);
+			Position = (Close == std::string::npos) ? Html.size() : Close + 3;
+			continue;
+		}
+
+		const bool bClosing = Open + 1 < Html.size() && Html[Open + 1] == '/';
+		std::size_t NameEnd = Open + (bClosing ? 2 : 1);
+		while (NameEnd < Html.size() && std::isalnum(static_cast<unsigned char>(Html[NameEnd]))) {
+			NameEnd++;
+		}
+		std::string Name = Html.substr(Open + (bClosing ? 2 : 1), NameEnd - Open - (bClosing ? 2 : 1));
+		std::transform(Name.begin(), Name.end(), Name.begin(),
+		               [](unsigned char Character) { return static_cast<char>(std::tolower(Character)); });
+		const std::size_t TagEnd = FindTagEnd(Html, Open);
+		Position = TagEnd;
+
+		if (bClosing) {
+			if (Name == "table" && !Tables.empty()) {
+				FinishRow(Tables.back(), Record);
+				Tables.pop_back();
+			} else if (Name == "tr" && !Tables.empty()) {
+				FinishRow(Tables.back(), Record);
+			} else if ((Name == "td" || Name == "th") && !Tables.empty()) {
+				Tables.back().bInCell = false;
+			} else if ((Name == "p" || Name == "li" || Name == "div") && !Tables.empty() && Tables.back().bInCell) {
+				Tables.back().Cells.back() += ' ';
+			}
+			continue;
+		}
+
+		const std::string Tag = Html.substr(Open, TagEnd - Open);
+		if (Name == "script" || Name == "style") {
+			Position = FindTagEnd(Html, FindClosingTag(Html, TagEnd, Name));
+		} else if (Name == "sup" && Tag.find("reference") != std::string::npos) {
+			Position = FindTagEnd(Html, FindClosingTag(Html, TagEnd, "sup"));
+		} else if (Name == "title" && Record.Find("title") == nullptr) {
+			const std::size_t Close = FindClosingTag(Html, TagEnd, "title");
+			Record.Fields.emplace_back("title", NormaliseText(Html.substr(TagEnd, Close - TagEnd)));
+			Position = FindTagEnd(Html, Close);
+		} else if (Name == "table") {
+			Tables.emplace_back();
+		} else if (Name == "tr" && !Tables.empty()) {
+			FinishRow(Tables.back(), Record);
+		} else if ((Name == "td" || Name == "th") && !Tables.empty()) {
+			Tables.back().Cells.emplace_back();
+			Tables.back().bInCell = true;
+		} else if (Name == "br" && !Tables.empty() && Tables.back().bInCell) {
+			Tables.back().Cells.back() += ' ';
+		}
+	}
+
+	while (!Tables.empty()) {
+		FinishRow(Tables.back(), Record);
+		Tables.pop_back();
+	}
+	return Record;
+}
+
+
+ScrapedRecord ExtractJsonFields(const std::string& Json)
+{
+	ScrapedRecord Record;
+	JsonFlattener(Json, Record).Run();
+	return Record;
+}
+
+
+ScrapedRecord ExtractFields(const FetchedPage& Page)
+{
+	LEARNSCRAPE_SCOPED_TIMER(CoreUtilities::ReportPhase::Extraction);
+
+	ScrapedRecord Record;
+	if (!Page.IsOk()) {
+		Record.Error = Page.Error.empty() ? "HTTP " + std::to_string(Page.Response.StatusCode) : Page.Error;
+	} else {
+		const std::string* ContentType = Page.Response.FindHeader("content-type");
+		const std::string& Body = Page.Response.Body;
+		bool bJson;
+		if (ContentType != nullptr && ContentType->find("json") != std::string::npos) {
+			bJson = true;
+		} else if (ContentType != nullptr && ContentType->find("html") != std::string::npos) {
+			bJson = false;
+		} else {
+			const std::size_t First = Body.find_first_not_of(" \t\r\n");
+			bJson = First != std::string::npos && (Body[First] == '{' || Body[First] == '[');
+		}
+
+		try {
+			Record = bJson ? ExtractJsonFields(Body) : ExtractHtmlFields(Body);
+		} catch (const std::invalid_argument& Error) {
+			Record.Error = Error.what();
+		}
+		LEARNSCRAPE_RECORD_VOLUME(CoreUtilities::ReportPhase::Extraction, 1, Body.size());
+	}
+	Record.Url = Page.FinalUrl;
+	return Record;
+}
+
+
+bool ParseLeadingNumber(const std::string& Text, double& Value)
+{
+	// Find the first digit, keeping a sign or point directly in front of it.
+	std::size_t Start = 0;
+	bool bNegative = false;
+	for (; Start < Text.size(); Start++) {
+		if (std::isdigit(static_cast<unsigned char>(Text[Start]))) {
+			break;
+		}
+	}
+	if (Start == Text.size()) {
+		return false;
+	}
+	if (Start > 0 && Text[Start - 1] == '.') {
+		Start--;
+	}
+	if (Start > 0 && Text[Start - 1] == '-') {
+		bNegative = true;
+	} else if (Start >= 3 && Text.compare(Start - 3, 3, "\xE2\x88\x92") == 0) {
+		bNegative = true;
+	}
+
+	// Copy the number without thousands separators: a comma followed by
+	// exactly three digits, before any decimal point.
+	std::string Number = bNegative ? "-" : "";
+	std::size_t Position = Start;
+	bool bPoint = false;
+	while (Position < Text.size()) {
+		const char Character = Text[Position];
+		if (std::isdigit(static_cast<unsigned char>(Character))) {
+			Number += Character;
+		} else if (Character == '.' && !bPoint) {
+			bPoint = true;
+			Number += Character;
+		} else if (Character == ',' && !bPoint && Position + 3 < Text.size()
+		           && std::isdigit(static_cast<unsigned char>(Text[Position + 1]))
+		           && std::isdigit(static_cast<unsigned char>(Text[Position + 2]))
+		           && std::isdigit(static_cast<unsigned char>(Text[Position + 3]))
+		           && (Position + 4 >= Text.size() || !std::isdigit(static_cast<unsigned char>(Text[Position + 4])))) {
+			// Thousands separator.
+		} else {
+			break;
+		}
+		Position++;
+	}
+	// Exponent: e-5 / E+3.
+	if (Position + 1 < Text.size() && (Text[Position] == 'e' || Text[Position] == 'E')) {
+		std::size_t Exponent = Position + 1;
+		if (Text[Exponent] == '+' || Text[Exponent] == '-') {
+			Exponent++;
+		}
+		if (Exponent < Text.size() && std::isdigit(static_cast<unsigned char>(Text[Exponent]))) {
+			while (Exponent < Text.size() && std::isdigit(static_cast<unsigned char>(Text[Exponent]))) {
+				Exponent++;
+			}
+			Number += Text.substr(Position, Exponent - Position);
+		}
+	}
+
+	char* End = nullptr;
+	Value = std::strtod(Number.c_str(), &End);
+	return End != Number.c_str() && *End == '\0';
+}
+
+} // namespace WebScraping
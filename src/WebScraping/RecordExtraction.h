@@ -0,0 +1,50 @@
+#ifndef __RecordExtraction__
+#define __RecordExtraction__
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "WebScraping/PageFetcher.h"
+
+/* RECORD EXTRACTION */
+// Extraction stage of the scraper: flattens one page into named text
+// fields. HTML pages yield every two-cell table row, label then value (the
+// layout of Wikipedia infoboxes), plus the <title>; citation superscripts,
+// scripts and styles are dropped. JSON documents yield each scalar under
+// its dotted path, e.g. "elements[2].density". Values stay text until a
+// consumer asks for a number.
+
+namespace WebScraping {
+
+struct ScrapedRecord {
+	// Position of the page in the scrape's URL list.
+	std::size_t Index = 0;
+	std::string Url;
+	std::vector<std::pair<std::string, std::string>> Fields;
+	// Empty unless the page could not be fetched or parsed.
+	std::string Error;
+
+	// Value of field Name, compared case-insensitively. Failing an exact
+	// match, the first field named Name followed by a space or '(' is used,
+	// so "Density" finds "Density (at STP)".
+	const std::string* Find(const std::string& Name) const;
+};
+
+
+ScrapedRecord ExtractHtmlFields(const std::string& Html);
+
+// Throws std::invalid_argument on malformed JSON.
+ScrapedRecord ExtractJsonFields(const std::string& Json);
+
+// Pick the extractor by Content-Type, or by sniffing the body when the
+// type is missing. Failed fetches and parse errors come back in Error.
+ScrapedRecord ExtractFields(const FetchedPage& Page);
+
+// The first number in Text: 0.08988 from "0.08988 g/L (0 °C)". Accepts a
+// Unicode minus sign and comma thousands separators. False if none.
+bool ParseLeadingNumber(const std::string& Text, double& Value);
+
+} // namespace WebScraping
+
+#endif // __RecordExtraction__
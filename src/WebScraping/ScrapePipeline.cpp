@@ -0,0 +1,241 @@
+#include "WebScraping/ScrapePipeline.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+#include "CoreUtilities/ConcurrentQueue.h"
+
+namespace WebScraping {
+
+using ModelRepresentation::GeneralisedFeature;
+using ModelRepresentation::TrainingSet;
+
+namespace {
+
+struct PageItem {
+	std::size_t Index = 0;
+	FetchedPage Page;
+	// Set when the cache answered for the page; Record is then final.
+	bool bCached = false;
+	ScrapedRecord Record;
+};
+
+
+std::vector<GeneralisedFeature> SchemaFeatures(const RecordSchema& Schema)
+{
+	std::vector<GeneralisedFeature> Features;
+	for (const std::string& Field : Schema.FeatureFields) {
+		Features.emplace_back(Field);
+	}
+	return Features;
+}
+
+
+// First exception raised by any stage; raising it stops the others.
+class StageFailure {
+private:
+	std::mutex Lock;
+	std::exception_ptr Error;
+	std::atomic<bool> bFailed{false};
+
+public:
+	void Capture()
+	{
+		std::lock_guard<std::mutex> Guard(Lock);
+		if (!Error) {
+			Error = std::current_exception();
+		}
+		bFailed.store(true, std::memory_order_release);
+	}
+
+	bool HasFailed() const { return bFailed.load(std::memory_order_acquire); }
+
+	void Rethrow()
+	{
+		if (Error) {
+			std::rethrow_exception(Error);
+		}
+	}
+};
+
+
+// Push with back-off; false if the pipeline failed meanwhile.
+template <typename ElementType>
+bool PushWaiting(CoreUtilities::BoundedQueue<ElementType>& Queue, ElementType&& Value, const StageFailure& Failure)
+{
+	CoreUtilities::QueueBackoff Backoff;
+	while (!Queue.TryPush(std::move(Value))) {
+		if (Failure.HasFailed()) {
+			return false;
+		}
+		Backoff.Wait();
+	}
+	return true;
+}
+
+} // namespace
+
+
+TrainingSetBuilder::TrainingSetBuilder(RecordSchema InSchema)
+	: Schema(std::move(InSchema)), Set(SchemaFeatures(Schema), Schema.OutputField), Row(Schema.FeatureFields.size())
+{
+	if (Schema.FeatureFields.empty() || Schema.OutputField.empty()) {
+		throw std::invalid_argument("TrainingSetBuilder: the schema needs feature fields and an output field");
+	}
+}
+
+
+bool TrainingSetBuilder::Add(const ScrapedRecord& Record)
+{
+	for (std::size_t Feature = 0; Feature < Schema.FeatureFields.size(); Feature++) {
+		const std::string* Text = Record.Find(Schema.FeatureFields[Feature]);
+		if (Text == nullptr || !ParseLeadingNumber(*Text, Row[Feature])) {
+			return false;
+		}
+	}
+	const std::string* OutputText = Record.Find(Schema.OutputField);
+	double Output;
+	if (OutputText == nullptr || !ParseLeadingNumber(*OutputText, Output)) {
+		return false;
+	}
+	Set.AddExample(Row.data(), Output);
+	return true;
+}
+
+
+ScrapePipeline::ScrapePipeline(RecordSchema InSchema, ScrapeOptions InOptions)
+	: Schema(std::move(InSchema)), Options(InOptions)
+{
+	if (Options.Fetch.MaxConnections == 0 || Options.NumParsers == 0) {
+		throw std::invalid_argument("ScrapePipeline: need at least one fetch and one parse worker");
+	}
+}
+
+
+TrainingSet ScrapePipeline::Run(const std::vector<std::string>& Urls)
+{
+	Summary = ScrapeSummary();
+	TrainingSetBuilder Builder(Schema);
+
+	CoreUtilities::BoundedQueue<PageItem> Pages(Options.QueueCapacity);
+	CoreUtilities::BoundedQueue<ScrapedRecord> Records(Options.QueueCapacity);
+	std::atomic<std::size_t> NextUrl{0};
+	// Fetchers stay within Window URLs of the next row to ingest, so one
+	// slow page cannot make the reorder buffer below grow without bound.
+	std::atomic<std::size_t> RowsIngested{0};
+	const std::size_t Window = std::max<std::size_t>(1, Options.QueueCapacity);
+	const std::size_t NumFetchers = std::min(Options.Fetch.MaxConnections, std::max<std::size_t>(1, Urls.size()));
+	std::atomic<std::size_t> FetchersRunning{NumFetchers};
+	StageFailure Failure;
+
+	std::vector<std::thread> Workers;
+	for (std::size_t Worker = 0; Worker < NumFetchers; Worker++) {
+		Workers.emplace_back([&, Worker]() {
+			try {
+				PageFetcher Fetcher(Options.Fetch, static_cast<unsigned>(Worker));
+				CoreUtilities::QueueBackoff Backoff;
+				for (std::size_t Index = NextUrl++; Index < Urls.size() && !Failure.HasFailed(); Index = NextUrl++) {
+					// The fetcher holding the next row is never held here, so
+					// the window always moves on.
+					while (Index >= RowsIngested.load(std::memory_order_acquire) + Window && !Failure.HasFailed()) {
+						Backoff.Wait();
+					}
+					Backoff.Reset();
+					PageItem Item;
+					Item.Index = Index;
+					if (Options.Cache != nullptr) {
+						Item.bCached = Options.Cache->Fetch(Fetcher, Urls[Index], Item.Page, Item.Record);
+					} else {
+						Item.Page = Fetcher.Fetch(Urls[Index]);
+					}
+					if (!PushWaiting(Pages, std::move(Item), Failure)) {
+						break;
+					}
+				}
+			} catch (...) {
+				Failure.Capture();
+			}
+			FetchersRunning.fetch_sub(1, std::memory_order_release);
+		});
+	}
+
+	for (std::size_t Worker = 0; Worker < Options.NumParsers; Worker++) {
+		Workers.emplace_back([&]() {
+			try {
+				CoreUtilities::QueueBackoff Backoff;
+				PageItem Item;
+				while (!Failure.HasFailed()) {
+					// Check for finished fetchers before popping, so a page pushed
+					// just before the last fetcher exits is still drained.
+					const bool bFetchersDone = FetchersRunning.load(std::memory_order_acquire) == 0;
+					if (!Pages.TryPop(Item)) {
+						if (bFetchersDone) {
+							break;
+						}
+						Backoff.Wait();
+						continue;
+					}
+					Backoff.Reset();
+					ScrapedRecord Record;
+					if (Item.bCached) {
+						Record = std::move(Item.Record);
+					} else {
+						Record = Options.Cache ? Options.Cache->Extract(Item.Page) : ExtractFields(Item.Page);
+					}
+					Record.Index = Item.Index;
+					if (!PushWaiting(Records, std::move(Record), Failure)) {
+						break;
+					}
+				}
+			} catch (...) {
+				Failure.Capture();
+			}
+		});
+	}
+
+	// Ingest on this thread, restoring URL order.
+	try {
+		std::map<std::size_t, ScrapedRecord> OutOfOrder;
+		CoreUtilities::QueueBackoff Backoff;
+		ScrapedRecord Record;
+		std::size_t NextRow = 0;
+		while (NextRow < Urls.size() && !Failure.HasFailed()) {
+			if (!Records.TryPop(Record)) {
+				Backoff.Wait();
+				continue;
+			}
+			Backoff.Reset();
+			OutOfOrder.emplace(Record.Index, std::move(Record));
+
+			for (auto Ready = OutOfOrder.find(NextRow); Ready != OutOfOrder.end(); Ready = OutOfOrder.find(++NextRow)) {
+				const ScrapedRecord& Current = Ready->second;
+				Summary.NumPages++;
+				if (!Current.Error.empty()) {
+					Summary.Skipped.emplace_back(Current.Url, Current.Error);
+				} else if (Builder.Add(Current)) {
+					Summary.NumRows++;
+				} else {
+					Summary.Skipped.emplace_back(Current.Url, "missing or non-numeric schema field");
+				}
+				OutOfOrder.erase(Ready);
+			}
+			RowsIngested.store(NextRow, std::memory_order_release);
+		}
+	} catch (...) {
+		Failure.Capture();
+	}
+
+	for (std::thread& Worker : Workers) {
+		Worker.join();
+	}
+	Failure.Rethrow();
+	return Builder.Release();
+}
+
+} // namespace WebScraping
@@ -0,0 +1,93 @@
+#ifndef __ScrapePipeline__
+#define __ScrapePipeline__
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "MachineLearning/ModelRepresentation/TrainingSet.h"
+#include "WebScraping/PageCache.h"
+#include "WebScraping/PageFetcher.h"
+#include "WebScraping/RecordExtraction.h"
+
+/* SCRAPE PIPELINE */
+// Runs fetch, extraction and ingest concurrently instead of as three serial
+// steps. Fetch workers (FetchOptions::MaxConnections, each owning a
+// PageFetcher) claim URLs from a shared cursor and push pages into a
+// bounded lock-free queue; parse workers turn pages into records and push
+// them into a second queue; the calling thread drains that into a
+// TrainingSetBuilder. The queue bounds keep memory flat when one stage is
+// slower than the others, and fetchers never run more than QueueCapacity
+// URLs ahead of the next row to ingest, so a slow page holds back at most
+// that many finished records. Stages run on their own threads rather than the
+// TaskScheduler, whose workers must not block on the network. Rows land in
+// URL-list order whatever order the pages finish in.
+
+namespace WebScraping {
+
+// Which record fields become the TrainingSet's features and output.
+struct RecordSchema {
+	std::vector<std::string> FeatureFields;
+	std::string OutputField;
+};
+
+
+// Consumer stage: turns records into TrainingSet rows through a schema.
+class TrainingSetBuilder {
+private:
+	RecordSchema Schema;
+	ModelRepresentation::TrainingSet Set;
+	std::vector<double> Row;
+
+public:
+	explicit TrainingSetBuilder(RecordSchema InSchema);
+
+	// Append Record as one example. Returns false, appending nothing, when a
+	// schema field is missing or holds no number.
+	bool Add(const ScrapedRecord& Record);
+
+	const ModelRepresentation::TrainingSet& GetSet() const { return Set; }
+	ModelRepresentation::TrainingSet Release() { return std::move(Set); }
+};
+
+
+struct ScrapeOptions {
+	FetchOptions Fetch;
+	std::size_t NumParsers = 2;
+	// Capacity of each hand-over queue, and how far fetching may run ahead
+	// of ingest.
+	std::size_t QueueCapacity = 256;
+	// Optional; unchanged pages are then neither downloaded nor re-parsed.
+	PageCache* Cache = nullptr;
+};
+
+
+struct ScrapeSummary {
+	std::size_t NumPages = 0;
+	std::size_t NumRows = 0;
+	// (URL, reason) for pages that failed or lacked a schema field.
+	std::vector<std::pair<std::string, std::string>> Skipped;
+};
+
+
+class ScrapePipeline {
+private:
+	RecordSchema Schema;
+	ScrapeOptions Options;
+	ScrapeSummary Summary;
+
+public:
+	explicit ScrapePipeline(RecordSchema InSchema, ScrapeOptions InOptions = ScrapeOptions());
+
+	// Scrape every URL into a TrainingSet of raw (unstandardised) values.
+	// Per-page failures are recorded in the summary; other errors in a
+	// stage are rethrown here once all stages have stopped.
+	ModelRepresentation::TrainingSet Run(const std::vector<std::string>& Urls);
+
+	const ScrapeSummary& GetSummary() const { return Summary; }
+};
+
+} // namespace WebScraping
+
+#endif // __ScrapePipeline__
@@ -1,4 +1,37 @@
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
 #include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "CoreUtilities/InferenceServer.h"
+#include "CoreUtilities/PlotCreation.h"
+#include "CoreUtilities/ReportGeneration.h"
+#include "CoreUtilities/RingAllReduce.h"
+#include "MachineLearning/DistributedTraining/DataParallelTraining.h"
+#include "MachineLearning/LinearRegression/CostFunction.h"
+#include "MachineLearning/LinearRegression/LinearModel.h"
+#include "MachineLearning/LinearRegression/NormalEquation.h"
+#include "MachineLearning/LinearRegression/PredictionHypothesis.h"
+#include "MachineLearning/LogisticRegression/LogisticModel.h"
+#include "MachineLearning/LogisticRegression/PredictionHypothesis.h"
+#include "MachineLearning/MeansClustering/CentroidAssignment.h"
+#include "MachineLearning/ModelRepresentation/CrossValidation.h"
+#include "MachineLearning/ModelRepresentation/ModelFile.h"
+#include "MachineLearning/ModelRepresentation/PolynomialTerms.h"
+#include "MachineLearning/ModelRepresentation/TrainingSet.h"
+#include "MachineLearning/ModelSelection/HyperparameterSearch.h"
+#include "MachineLearning/SupportVector/SupportVectorModel.h"
+#include "WebScraping/ScrapePipeline.h"
 
 /* DESIGN PATTERNS */
 // 1. Singletons
@@ -7,39 +40,533 @@
 // 4. Strategies
 // 5. Observers
 
+using namespace ModelRepresentation;
+using namespace ModelSelection;
+
+
+void PrintVersion(int VersionMajor, int VersionMinor, int VersionStage) {
+  printf ("learnscrape version %d.%d,%d\n", VersionMajor, VersionMinor, VersionStage);
+}
 
-class GeneralFeature {
-private:
-	char* VariableName;
-	char* StandardUnit;	
-	int DataType;
-	double ScalingMetric;
-public:
-};
 
+GeneralisedFeature::DataType ParseStorageType(const std::string& Name) {
+  if (Name == "float32") {
+    return GeneralisedFeature::DataType::Float32;
+  }
+  if (Name == "bfloat16") {
+    return GeneralisedFeature::DataType::BFloat16;
+  }
+  if (Name == "sparse") {
+    return GeneralisedFeature::DataType::Sparse;
+  }
+  if (Name != "float64") {
+    throw std::invalid_argument("unknown storage type " + Name + " (float64, float32, bfloat16 or sparse)");
+  }
+  return GeneralisedFeature::DataType::Float64;
+}
 
-class ExampleDatum {
-private:
-public:
-};
 
+/* learnscrape search <data.csv> <linear|logistic|svm> [halving]
+   Default grid search for one model family on a 80/20 holdout split. */
+int RunSearch(int argc, char **argv) {
+  if (argc < 2) {
+    std::cerr << "ERROR|Usage: learnscrape search <data.csv> <linear|logistic|svm> [halving]" << std::endl;
+    return 1;
+  }
+  const std::string Family = argv[1];
 
-class TrainingSet {
-private:
-	generalFeature* featureList;
-	dataEntry** inputArray;
-	dataEntry* outputArray;
-public:
-};
+  TrainingSet Set = TrainingSet::LoadCsv(argv[0]);
+  Set.Standardise();
 
+  std::vector<std::size_t> TrainRows, ValidationRows;
+  SplitHoldout(Set.GetNumExamples(), 0.2, 0, TrainRows, ValidationRows);
 
+  SearchOptions Options;
+  Options.bSuccessiveHalving = (argc >= 3 && std::string(argv[2]) == "halving");
 
+  ModelFactory Factory;
+  std::vector<Hyperparameters> Candidates;
+  if (Family == "linear" || Family == "logistic") {
+    Candidates = GridCandidates({{"alpha", {0.01, 0.03, 0.1, 0.3}}, {"lambda", {0.0, 0.1, 1.0, 10.0}}});
+    Factory = [Family](const Hyperparameters& Parameters) -> std::unique_ptr<LearningModel> {
+      if (Family == "linear") {
+        return std::make_unique<LinearRegression::LinearModel>(Parameters.at("alpha"), Parameters.at("lambda"));
+      }
+      return std::make_unique<LogisticRegression::LogisticModel>(Parameters.at("alpha"), Parameters.at("lambda"));
+    };
+  } else if (Family == "svm") {
+    Candidates = GridCandidates({{"lambda", {1.0e-4, 1.0e-3, 1.0e-2}}, {"sigma", {0.3, 1.0, 3.0}}});
+    Factory = [](const Hyperparameters& Parameters) -> std::unique_ptr<LearningModel> {
+      return std::make_unique<SupportVector::SupportVectorModel>(Parameters.at("lambda"), Parameters.at("sigma"));
+    };
+    Options.Budget = 2000;
+    Options.MinimumBudget = 100;
+  } else {
+    std::cerr << "ERROR|Search: unknown model family " << Family << std::endl;
+    return 1;
+  }
 
+  const std::vector<SearchResult> Results =
+    HyperparameterSearch(Factory, Options).Run(Candidates, TrainingView(Set, TrainRows), TrainingView(Set, ValidationRows));
 
-void PrintVersion(int VersionMajor, int VersionMinor, int VersionStage) {
-  printf ("learnscrape version %d.%d,%d\n", VersionMajor, VersionMinor, VersionStage);
+  for (const SearchResult& Result : Results) {
+    printf("%-40s loss %-12.6g iterations %-6zu%s\n", Result.Description.c_str(), Result.ValidationLoss,
+           Result.IterationsTrained, Result.bTerminatedEarly ? " (terminated)" : "");
+  }
+  return 0;
+}
+
+
+/* learnscrape crossvalidate <data.csv> <folds> <normal|linear|logistic> [storage [tolerance]]
+   K-fold cross-validation; "normal" uses the closed-form fit. The descent
+   methods run up to 500 steps per fold and stop once the relative change
+   in cost falls below tolerance (default 1e-6; 0 always runs all 500).
+   With a tolerance each fold is warm-started from a fit on the other half
+   of the folds; that pays off only when the folds settle within the
+   budget. */
+int RunCrossValidation(int argc, char **argv) {
+  if (argc < 3) {
+    std::cerr << "ERROR|Usage: learnscrape crossvalidate <data.csv> <folds> <normal|linear|logistic> [storage [tolerance]]" << std::endl;
+    return 1;
+  }
+  const std::string Method = argv[2];
+  const double Tolerance = (argc >= 5) ? std::stod(argv[4]) : 1.0e-6;
+
+  TrainingSet Set = TrainingSet::LoadCsv(argv[0], ParseStorageType(argc >= 4 ? argv[3] : "float64"));
+  Set.Standardise();
+  const FoldPartition Folds(Set, std::stoul(argv[1]), 0);
+
+  CrossValidationResult Result;
+  if (Method == "normal") {
+    Result = CrossValidateNormalEquation(Folds, 0.0);
+  } else if (Method == "linear") {
+    Result = CrossValidate(Folds, []() { return std::make_unique<LinearRegression::LinearModel>(0.1, 0.0); }, 500,
+                           Tolerance);
+  } else if (Method == "logistic") {
+    Result = CrossValidate(Folds, []() { return std::make_unique<LogisticRegression::LogisticModel>(0.1, 0.0); }, 500,
+                           Tolerance);
+  } else {
+    std::cerr << "ERROR|CrossValidation: unknown method " << Method << std::endl;
+    return 1;
+  }
+
+  for (std::size_t Fold = 0; Fold < Result.FoldLoss.size(); Fold++) {
+    printf("fold %-3zu loss %-12.6g iterations %zu\n", Fold, Result.FoldLoss[Fold], Result.FoldIterations[Fold]);
+  }
+  if (Result.WarmStartIterations > 0) {
+    printf("warm starts fitted in %zu iterations\n", Result.WarmStartIterations);
+  }
+  printf("mean loss %.6g (deviation %.3g)\n", Result.MeanLoss, Result.DeviationLoss);
+  return 0;
+}
+
+
+/* learnscrape cluster <data.csv> <clusters> [storage]
+   K-means over the standardised feature columns. */
+int RunClustering(int argc, char **argv) {
+  if (argc < 2) {
+    std::cerr << "ERROR|Usage: learnscrape cluster <data.csv> <clusters> [float64|float32|bfloat16|sparse]" << std::endl;
+    return 1;
+  }
+
+  TrainingSet Set = TrainingSet::LoadCsv(argv[0], ParseStorageType(argc >= 3 ? argv[2] : "float64"));
+  Set.Standardise();
+
+  const std::size_t NumClusters = std::stoul(argv[1]);
+  const MeansClustering::ClusteringResult Result =
+    MeansClustering::RunMeansClustering(TrainingView(Set), NumClusters, 100, 0);
+
+  printf("distortion %.6g after %zu iterations (%zu bytes of feature storage)\n",
+         Result.Distortion, Result.Iterations, Set.GetStorageBytes());
+  for (std::size_t Cluster = 0; Cluster < NumClusters; Cluster++) {
+    printf("centroid %zu:", Cluster);
+    for (std::size_t Feature = 0; Feature < Set.GetNumFeatures(); Feature++) {
+      printf(" %.4g", Result.Centroids[Cluster * Set.GetNumFeatures() + Feature]);
+    }
+    printf("\n");
+  }
+  return 0;
+}
+
+
+/* Stream one pass of predictions through the residual histogram and the
+   prediction-vs-truth sample, then write both next to the convergence curve. */
+void WriteFitPlots(const std::string& Prefix, CoreUtilities::PlotFormat Format, const TrainingView& View,
+                   ModelKind Kind, const std::vector<double>& Theta, const CoreUtilities::ConvergenceCurve& Curve) {
+  CoreUtilities::ResidualHistogram Histogram;
+  CoreUtilities::ScatterSample Scatter;
+  double Prediction[KernelBlockSize];
+  double Output[KernelBlockSize];
+
+  for (std::size_t Block = 0; Block < View.GetNumExamples(); Block += KernelBlockSize) {
+    const std::size_t BlockEnd = std::min(View.GetNumExamples(), Block + KernelBlockSize);
+    if (Kind == ModelKind::Linear) {
+      LinearRegression::EvaluateHypothesis(View, Theta, Block, BlockEnd, Prediction);
+    } else {
+      LogisticRegression::EvaluateHypothesis(View, Theta, Block, BlockEnd, Prediction);
+    }
+    View.GatherOutputs(Block, BlockEnd, Output);
+    Scatter.Add(Output, Prediction, BlockEnd - Block);
+    for (std::size_t Index = 0; Index < BlockEnd - Block; Index++) {
+      Histogram.Add(Prediction[Index] - Output[Index]);
+    }
+  }
+
+  const std::string Extension = (Format == CoreUtilities::PlotFormat::Csv) ? ".csv" : ".bin";
+  if (Curve.GetNumPoints() > 0) {
+    CoreUtilities::PlotWriter Writer(Prefix + "_convergence" + Extension, Format, {"iteration", "min", "max", "last"});
+    Curve.Write(Writer);
+    Writer.Flush();
+  }
+  CoreUtilities::PlotWriter HistogramWriter(Prefix + "_residuals" + Extension, Format, {"lower", "upper", "count"});
+  Histogram.Write(HistogramWriter);
+  HistogramWriter.Flush();
+  CoreUtilities::PlotWriter ScatterWriter(Prefix + "_scatter" + Extension, Format, {"truth", "prediction"});
+  Scatter.Write(ScatterWriter);
+  ScatterWriter.Flush();
+
+  printf("wrote %s_*%s: %llu iterations, %llu residuals, %zu scatter points\n", Prefix.c_str(), Extension.c_str(),
+         static_cast<unsigned long long>(Curve.GetNumPoints()),
+         static_cast<unsigned long long>(Histogram.GetNumValues()), Scatter.GetNumSampled());
+}
+
+
+/* learnscrape fit <data.csv> <linear|logistic> <degree> <model.bin> [plot-prefix [csv|binary]]
+   Fit a polynomial model of the given degree and write its model file, and
+   optionally the convergence, residual and scatter plot data. */
+int RunFit(int argc, char **argv) {
+  if (argc < 4) {
+    std::cerr << "ERROR|Usage: learnscrape fit <data.csv> <linear|logistic> <degree> <model.bin> [plot-prefix [csv|binary]]" << std::endl;
+    return 1;
+  }
+  const std::string Family = argv[1];
+  const CoreUtilities::PlotFormat Format = (argc >= 6 && std::string(argv[5]) == "binary")
+    ? CoreUtilities::PlotFormat::Binary : CoreUtilities::PlotFormat::Csv;
+
+  TrainingSet Set = TrainingSet::LoadCsv(argv[0]);
+  Set.Standardise();
+  const PolynomialTerms Terms(Set.GetNumFeatures(), std::stoul(argv[2]));
+  const TrainingSet Expanded = Terms.ExpandTrainingSet(Set);
+  const TrainingView View(Expanded);
+
+  std::vector<double> Theta;
+  ModelKind Kind;
+  CoreUtilities::ConvergenceCurve Curve;
+  if (Family == "linear") {
+    Kind = ModelKind::Linear;
+    Theta = LinearRegression::NormalEquationSystem::Accumulate(View).Solve(1.0e-6);
+  } else if (Family == "logistic") {
+    Kind = ModelKind::Logistic;
+    LogisticRegression::LogisticModel Model(0.1, 0.0);
+    Model.SetIterationObserver([&Curve](std::size_t, double Cost) { Curve.Add(Cost); });
+    Model.Train(View, 2000);
+    Theta = Model.GetTheta();
+  } else {
+    std::cerr << "ERROR|Fit: unknown model family " << Family << std::endl;
+    return 1;
+  }
+
+  WriteModelFile(argv[3], Kind, Set.GetFeatures(), Terms, Theta);
+  printf("wrote %s: %zu features, %zu terms\n", argv[3], Set.GetNumFeatures(), Terms.GetNumTerms());
+
+  if (argc >= 5) {
+    WriteFitPlots(argv[4], Format, View, Kind, Theta, Curve);
+  }
+  return 0;
+}
+
+
+/* learnscrape follow <data.csv> <linear|logistic|cluster> <poll-seconds> [rounds [clusters]]
+   Train on the file as it stands, then poll it for rows appended by the
+   scraper and fold each batch into the model instead of retraining. Each
+   batch's loss is measured before the update; rounds 0 polls forever.
+   A malformed appended row is reported and skipped. */
+int RunFollow(int argc, char **argv) {
+  if (argc < 3) {
+    std::cerr << "ERROR|Usage: learnscrape follow <data.csv> <linear|logistic|cluster> <poll-seconds> [rounds [clusters]]" << std::endl;
+    return 1;
+  }
+  const std::string Path = argv[0];
+  const std::string Family = argv[1];
+  const std::chrono::duration<double> Interval(std::stod(argv[2]));
+  const std::size_t Rounds = (argc >= 4) ? std::stoul(argv[3]) : 0;
+  const std::size_t NumClusters = (argc >= 5) ? std::stoul(argv[4]) : 4;
+  if (Family != "linear" && Family != "logistic" && Family != "cluster") {
+    std::cerr << "ERROR|Follow: unknown model family " << Family << std::endl;
+    return 1;
+  }
+
+  std::uint64_t Offset = 0;
+  TrainingSet Set = TrainingSet::LoadCsv(Path, GeneralisedFeature::DataType::Float64, &Offset);
+  Set.Standardise();
+  const TrainingView All(Set);
+
+  LinearRegression::NormalEquationSystem System;
+  std::vector<double> Theta;
+  LogisticRegression::LogisticModel Logistic(0.1, 0.0);
+  MeansClustering::ClusteringResult Clusters;
+  std::vector<std::size_t> ClusterCounts;
+
+  if (Family == "linear") {
+    System.Update(All);
+    Theta = System.Solve(1.0e-6);
+  } else if (Family == "logistic") {
+    Logistic.Train(All, 2000);
+  } else {
+    Clusters = MeansClustering::RunMeansClustering(All, NumClusters, 100, 0);
+    ClusterCounts = MeansClustering::CountAssignments(Clusters.Assignment, NumClusters);
+  }
+  printf("trained on %zu rows\n", Set.GetNumExamples());
+  fflush(stdout);
+
+  for (std::size_t Round = 0; Rounds == 0 || Round < Rounds; Round++) {
+    std::this_thread::sleep_for(Interval);
+    const std::size_t Previous = Set.GetNumExamples();
+    try {
+      Set.AppendCsv(Path, Offset);
+    } catch (const std::runtime_error& Error) {
+      // The bad row is skipped; rows before it were still appended.
+      std::cerr << "WARNING|" << Error.what() << std::endl;
+    }
+    if (Set.GetNumExamples() == Previous) {
+      continue;
+    }
+    const std::vector<std::size_t> NewRows = RowRange(Previous, Set.GetNumExamples());
+    const TrainingView Delta(Set, NewRows);
+
+    double Loss;
+    if (Family == "linear") {
+      Loss = 2.0 * LinearRegression::ComputeCost(Delta, Theta, 0.0);
+      System.Update(Delta);
+      Theta = System.Solve(1.0e-6);
+    } else if (Family == "logistic") {
+      Loss = Logistic.ValidationLoss(Delta);
+      Logistic.TrainIncremental(Delta, Previous, 200);
+    } else {
+      Loss = MeansClustering::UpdateCentroidsOnline(Delta, NumClusters, Clusters.Centroids, ClusterCounts)
+        / static_cast<double>(Delta.GetNumExamples());
+    }
+    printf("rows %zu (+%zu) batch loss %.6g\n", Set.GetNumExamples(), Delta.GetNumExamples(), Loss);
+    fflush(stdout);
+  }
+  return 0;
+}
+
+
+/* learnscrape scrape <urls.txt> <out.csv> <output-field> <feature-field>...
+   Fetch every URL listed one per line ('#' starts a comment), extract the
+   named fields from each page and write the rows as a CSV that fit,
+   crossvalidate and follow read. Pages that fail or lack a field are
+   reported and skipped. LEARNSCRAPE_CACHE=<dir> keeps pages between runs
+   (LEARNSCRAPE_CACHE_MB bounds it, default 1024) so unchanged pages are
+   revalidated instead of downloaded and parsed again. */
+int RunScrape(int argc, char **argv) {
+  if (argc < 4) {
+    std::cerr << "ERROR|Usage: learnscrape scrape <urls.txt> <out.csv> <output-field> <feature-field>..." << std::endl;
+    return 1;
+  }
+
+  std::ifstream UrlFile(argv[0]);
+  if (!UrlFile) {
+    std::cerr << "ERROR|Scrape: cannot open " << argv[0] << std::endl;
+    return 1;
+  }
+  std::vector<std::string> Urls;
+  for (std::string Line; std::getline(UrlFile, Line);) {
+    const std::size_t First = Line.find_first_not_of(" \t\r");
+    if (First != std::string::npos && Line[First] != '#') {
+      Urls.push_back(Line.substr(First, Line.find_last_not_of(" \t\r") - First + 1));
+    }
+  }
+
+  WebScraping::RecordSchema Schema;
+  Schema.OutputField = argv[2];
+  Schema.FeatureFields.assign(argv + 3, argv + argc);
+
+  std::unique_ptr<WebScraping::PageCache> Cache;
+  WebScraping::ScrapeOptions Options;
+  if (const char* CacheDirectory = std::getenv("LEARNSCRAPE_CACHE")) {
+    WebScraping::CacheOptions Limits;
+    if (const char* Megabytes = std::getenv("LEARNSCRAPE_CACHE_MB")) {
+      Limits.MaxBytes = std::stoull(Megabytes) << 20;
+    }
+    Cache.reset(new WebScraping::PageCache(CacheDirectory, Limits));
+    Options.Cache = Cache.get();
+  }
+
+  WebScraping::ScrapePipeline Pipeline(Schema, Options);
+  const TrainingSet Set = Pipeline.Run(Urls);
+  if (Cache) {
+    Cache->Flush();
+  }
+  Set.WriteCsv(argv[1]);
+
+  const WebScraping::ScrapeSummary& Summary = Pipeline.GetSummary();
+  for (const auto& Skipped : Summary.Skipped) {
+    std::cerr << "WARNING|" << Skipped.first << ": " << Skipped.second << std::endl;
+  }
+  printf("scraped %zu pages into %zu rows of %s\n", Summary.NumPages, Summary.NumRows, argv[1]);
+  return 0;
+}
+
+
+CoreUtilities::InferenceServer* ActiveServer = nullptr;
+
+void StopServer(int) {
+  if (ActiveServer) {
+    ActiveServer->Stop();
+  }
+}
+
+
+/* learnscrape serve <model.bin> <socket>
+   Answer batched prediction requests on a Unix socket until interrupted. */
+int RunServe(int argc, char **argv) {
+  if (argc < 2) {
+    std::cerr << "ERROR|Usage: learnscrape serve <model.bin> <socket>" << std::endl;
+    return 1;
+  }
+
+  const MappedModel Model(argv[0]);
+  CoreUtilities::InferenceServer Server(Model, argv[1]);
+
+  ActiveServer = &Server;
+  std::signal(SIGINT, StopServer);
+  std::signal(SIGTERM, StopServer);
+
+  printf("serving %s on %s\n", argv[0], argv[1]);
+  fflush(stdout);
+  Server.Serve();
+
+  ActiveServer = nullptr;
+  return 0;
+}
+
+
+/* learnscrape coordinate <endpoint> <workers> <linear|linear-descent|logistic> [iterations [tolerance]]
+   Run a data-parallel training job: wait on <endpoint> (unix:<path> or
+   tcp:<host>:<port>) for that many workers, referee convergence and print
+   the model. linear solves the normal equation from every shard's Gram
+   partials; the descent methods all-reduce gradients each step. */
+int RunCoordinate(int argc, char **argv) {
+  if (argc < 3) {
+    std::cerr << "ERROR|Usage: learnscrape coordinate <endpoint> <workers> <linear|linear-descent|logistic> [iterations [tolerance]]" << std::endl;
+    return 1;
+  }
+  const std::string Method = argv[2];
+  DistributedTraining::DistributedOptions Options;
+  if (Method == "linear") {
+    Options.Method = DistributedTraining::TrainingMethod::NormalEquation;
+    Options.Lambda = 1.0e-6;
+  } else if (Method == "linear-descent") {
+    Options.Method = DistributedTraining::TrainingMethod::LinearDescent;
+  } else if (Method == "logistic") {
+    Options.Method = DistributedTraining::TrainingMethod::LogisticDescent;
+  } else {
+    std::cerr << "ERROR|Coordinate: unknown training method " << Method << std::endl;
+    return 1;
+  }
+  if (argc >= 4) {
+    Options.MaxIterations = std::stoul(argv[3]);
+  }
+  if (argc >= 5) {
+    Options.Tolerance = std::stod(argv[4]);
+  }
+
+  DistributedTraining::TrainingCoordinator Coordinator(CoreUtilities::SocketEndpoint::Parse(argv[0]),
+    std::stoul(argv[1]), Options);
+  Coordinator.SetIterationObserver([](std::size_t Steps, double Cost) {
+    if (Steps % 100 == 0) {
+      printf("step %zu cost %.10g\n", Steps, Cost);
+      fflush(stdout);
+    }
+  });
+  printf("coordinating %s workers on %s\n", argv[1], Coordinator.GetEndpoint().ToString().c_str());
+  fflush(stdout);
+
+  const DistributedTraining::DistributedResult Result = Coordinator.Run();
+  printf("trained on %zu rows across %zu workers: %zu steps, cost %.10g\n", Result.NumExamples,
+         Result.NumWorkers, Result.Iterations, Result.Cost);
+  for (std::size_t Index = 0; Index < Result.Theta.size(); Index++) {
+    printf("theta[%zu] = %.10g\n", Index, Result.Theta[Index]);
+  }
+  return 0;
+}
+
+
+/* learnscrape worker <coordinator-endpoint> <shard.csv> <ring-endpoint> [model.bin]
+   Join a coordinate job with this process's shard of the data, listening
+   for its ring neighbour on <ring-endpoint>. The rank 0 worker writes the
+   finished model, standardised with the whole data set's statistics, to
+   model.bin for serve. */
+int RunWorker(int argc, char **argv) {
+  if (argc < 3) {
+    std::cerr << "ERROR|Usage: learnscrape worker <coordinator-endpoint> <shard.csv> <ring-endpoint> [model.bin]" << std::endl;
+    return 1;
+  }
+
+  TrainingSet Shard = TrainingSet::LoadCsv(argv[1]);
+  std::size_t Rank = 0;
+  const DistributedTraining::DistributedResult Result = DistributedTraining::TrainShard(Shard,
+    CoreUtilities::SocketEndpoint::Parse(argv[0]), CoreUtilities::SocketEndpoint::Parse(argv[2]), 300.0, &Rank);
+  printf("worker %zu of %zu: %zu of %zu rows, cost %.10g\n", Rank, Result.NumWorkers, Shard.GetNumExamples(),
+         Result.NumExamples, Result.Cost);
+
+  if (argc >= 4 && Rank == 0) {
+    const ModelKind Kind = (Result.Method == DistributedTraining::TrainingMethod::LogisticDescent)
+      ? ModelKind::Logistic : ModelKind::Linear;
+    const PolynomialTerms Terms(Shard.GetNumFeatures(), 1);
+    WriteModelFile(argv[3], Kind, Shard.GetFeatures(), Terms, Result.Theta);
+    printf("wrote %s\n", argv[3]);
+  }
+  return 0;
+}
+
+
+int RunCommand(int argc, char **argv) {
+  if (argc >= 2 && std::string(argv[1]) == "search") {
+    return RunSearch(argc - 2, argv + 2);
+  }
+  if (argc >= 2 && std::string(argv[1]) == "crossvalidate") {
+    return RunCrossValidation(argc - 2, argv + 2);
+  }
+  if (argc >= 2 && std::string(argv[1]) == "cluster") {
+    return RunClustering(argc - 2, argv + 2);
+  }
+  if (argc >= 2 && std::string(argv[1]) == "fit") {
+    return RunFit(argc - 2, argv + 2);
+  }
+  if (argc >= 2 && std::string(argv[1]) == "follow") {
+    return RunFollow(argc - 2, argv + 2);
+  }
+  if (argc >= 2 && std::string(argv[1]) == "scrape") {
+    return RunScrape(argc - 2, argv + 2);
+  }
+  if (argc >= 2 && std::string(argv[1]) == "serve") {
+    return RunServe(argc - 2, argv + 2);
+  }
+  if (argc >= 2 && std::string(argv[1]) == "coordinate") {
+    return RunCoordinate(argc - 2, argv + 2);
+  }
+  if (argc >= 2 && std::string(argv[1]) == "worker") {
+    return RunWorker(argc - 2, argv + 2);
+  }
+  return 0;
 }
 
 int main(int argc, char **argv) {
   PrintVersion(0,0,0);
+
+  try {
+    const int Status = RunCommand(argc, argv);
+
+    // LEARNSCRAPE_REPORT=<path>.json|.html writes the run's timing report.
+    if (const char* ReportPath = std::getenv("LEARNSCRAPE_REPORT")) {
+      CoreUtilities::WriteReport(ReportPath);
+    }
+    return Status;
+  } catch (const std::exception& Error) {
+    std::cerr << "ERROR|" << Error.what() << std::endl;
+    return 1;
+  }
 }
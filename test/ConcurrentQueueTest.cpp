@@ -0,0 +1,85 @@
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "CoreUtilities/ConcurrentQueue.h"
+
+using CoreUtilities::BoundedQueue;
+using CoreUtilities::QueueBackoff;
+
+
+TEST(ConcurrentQueue, RoundsCapacityUpAndReportsFullAndEmpty)
+{
+	BoundedQueue<int> Queue(5);
+	EXPECT_EQ(Queue.GetCapacity(), 8u);
+
+	int Value = -1;
+	EXPECT_FALSE(Queue.TryPop(Value));
+	for (int Index = 0; Index < 8; Index++) {
+		int Pushed = Index;
+		ASSERT_TRUE(Queue.TryPush(std::move(Pushed)));
+	}
+	int Extra = 99;
+	EXPECT_FALSE(Queue.TryPush(std::move(Extra)));
+	EXPECT_EQ(Extra, 99);
+
+	for (int Index = 0; Index < 8; Index++) {
+		ASSERT_TRUE(Queue.TryPop(Value));
+		EXPECT_EQ(Value, Index);
+	}
+	EXPECT_FALSE(Queue.TryPop(Value));
+}
+
+
+TEST(ConcurrentQueue, DeliversEveryItemExactlyOnceAcrossProducersAndConsumers)
+{
+	const std::size_t NumProducers = 4;
+	const std::size_t NumConsumers = 4;
+	const std::size_t ItemsPerProducer = 20000;
+	BoundedQueue<std::size_t> Queue(64);
+
+	std::vector<std::atomic<int>> Seen(NumProducers * ItemsPerProducer);
+	for (std::atomic<int>& Count : Seen) {
+		Count.store(0);
+	}
+	std::atomic<std::size_t> Popped{0};
+
+	std::vector<std::thread> Threads;
+	for (std::size_t Producer = 0; Producer < NumProducers; Producer++) {
+		Threads.emplace_back([&, Producer]() {
+			QueueBackoff Backoff;
+			for (std::size_t Item = 0; Item < ItemsPerProducer; Item++) {
+				std::size_t Value = Producer * ItemsPerProducer + Item;
+				while (!Queue.TryPush(std::move(Value))) {
+					Backoff.Wait();
+				}
+				Backoff.Reset();
+			}
+		});
+	}
+	for (std::size_t Consumer = 0; Consumer < NumConsumers; Consumer++) {
+		Threads.emplace_back([&]() {
+			QueueBackoff Backoff;
+			std::size_t Value;
+			while (Popped.load() < Seen.size()) {
+				if (!Queue.TryPop(Value)) {
+					Backoff.Wait();
+					continue;
+				}
+				Backoff.Reset();
+				Seen[Value].fetch_add(1);
+				Popped.fetch_add(1);
+			}
+		});
+	}
+	for (std::thread& Thread : Threads) {
+		Thread.join();
+	}
+
+	for (std::size_t Value = 0; Value < Seen.size(); Value++) {
+		ASSERT_EQ(Seen[Value].load(), 1) << "item " << Value;
+	}
+}
@@ -0,0 +1,159 @@
+#include <cstddef>
+#include <memory>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "MachineLearning/LinearRegression/CostFunction.h"
+#include "MachineLearning/LinearRegression/LinearModel.h"
+#include "MachineLearning/LinearRegression/NormalEquation.h"
+#include "MachineLearning/ModelRepresentation/CrossValidation.h"
+
+using ModelRepresentation::CrossValidate;
+using ModelRepresentation::CrossValidateNormalEquation;
+using ModelRepresentation::CrossValidationResult;
+using ModelRepresentation::FoldPartition;
+using ModelRepresentation::GeneralisedFeature;
+using ModelRepresentation::LearningModel;
+using ModelRepresentation::TrainingSet;
+using ModelRepresentation::TrainingView;
+
+namespace {
+
+// y = 1 + 2 a - b + noise over standard normal features.
+TrainingSet MakeLinearSet(std::size_t NumRows)
+{
+	std::mt19937 Generator(7);
+	std::normal_distribution<double> Normal;
+	std::vector<std::vector<double>> Columns(2, std::vector<double>(NumRows));
+	std::vector<double> Outputs(NumRows);
+	for (std::size_t Row = 0; Row < NumRows; Row++) {
+		Columns[0][Row] = Normal(Generator);
+		Columns[1][Row] = Normal(Generator);
+		Outputs[Row] = 1.0 + 2.0 * Columns[0][Row] - Columns[1][Row] + 0.1 * Normal(Generator);
+	}
+	return TrainingSet({GeneralisedFeature("a"), GeneralisedFeature("b")}, std::move(Columns), std::move(Outputs));
+}
+
+
+std::set<std::size_t> RowsOf(const TrainingView& View)
+{
+	std::set<std::size_t> Rows;
+	for (std::size_t Position = 0; Position < View.GetNumExamples(); Position++) {
+		Rows.insert(View.GetRow(Position));
+	}
+	return Rows;
+}
+
+
+// Its parameters are the rows it was trained on, so a warm-started copy
+// knows which rows shaped its start point. Its validation loss is 1 if
+// any of those rows is being scored, or if they reach beyond the rows the
+// fold trains on.
+class RowRecordingModel : public LearningModel {
+private:
+	std::set<std::size_t> StartRows;
+	std::set<std::size_t> TrainedRows;
+	std::size_t IterationsTrained = 0;
+
+public:
+	void Train(const TrainingView& View, std::size_t Iterations) override
+	{
+		TrainedRows = RowsOf(View);
+		IterationsTrained += Iterations;
+	}
+
+	double ValidationLoss(const TrainingView& View) const override
+	{
+		for (const std::size_t Row : RowsOf(View)) {
+			if (StartRows.count(Row) != 0) {
+				return 1.0;
+			}
+		}
+		for (const std::size_t Row : StartRows) {
+			if (TrainedRows.count(Row) == 0) {
+				return 1.0;
+			}
+		}
+		return 0.0;
+	}
+
+	std::size_t GetIterationsTrained() const override { return IterationsTrained; }
+	std::string Describe() const override { return "rows"; }
+	std::vector<double> GetParameters() const override
+	{
+		return std::vector<double>(TrainedRows.begin(), TrainedRows.end());
+	}
+	void WarmStart(const std::vector<double>& Parameters) override
+	{
+		for (const double Row : Parameters) {
+			StartRows.insert(static_cast<std::size_t>(Row));
+		}
+	}
+};
+
+} // namespace
+
+
+TEST(CrossValidation, WarmStartsNeverSeeTheRowsTheyAreScoredOn)
+{
+	const TrainingSet Set = MakeLinearSet(103);
+	for (const std::size_t NumFolds : {2u, 3u, 5u, 10u}) {
+		const FoldPartition Folds(Set, NumFolds, 1);
+		const CrossValidationResult Result =
+			CrossValidate(Folds, []() { return std::make_unique<RowRecordingModel>(); }, 10, 1.0e-6);
+		EXPECT_EQ(Result.MeanLoss, 0.0) << NumFolds << " folds";
+		EXPECT_EQ(Result.WarmStartIterations, 20u);
+	}
+}
+
+
+TEST(CrossValidation, RunsTheFullBudgetColdWithoutATolerance)
+{
+	const TrainingSet Set = MakeLinearSet(200);
+	const FoldPartition Folds(Set, 4, 1);
+	const CrossValidationResult Result =
+		CrossValidate(Folds, []() { return std::make_unique<LinearRegression::LinearModel>(0.1, 0.0); }, 300);
+	EXPECT_EQ(Result.WarmStartIterations, 0u);
+	for (const std::size_t Iterations : Result.FoldIterations) {
+		EXPECT_EQ(Iterations, 300u);
+	}
+}
+
+
+TEST(CrossValidation, WarmStartedFoldsStopEarlyWithTheSameEstimate)
+{
+	const TrainingSet Set = MakeLinearSet(400);
+	const FoldPartition Folds(Set, 5, 1);
+	const auto Builder = []() { return std::make_unique<LinearRegression::LinearModel>(0.1, 0.0); };
+	const CrossValidationResult Cold = CrossValidate(Folds, Builder, 2000);
+	const CrossValidationResult Warm = CrossValidate(Folds, Builder, 2000, 1.0e-9);
+
+	std::size_t FoldIterations = 0;
+	for (const std::size_t Iterations : Warm.FoldIterations) {
+		EXPECT_LT(Iterations, 200u);
+		FoldIterations += Iterations;
+	}
+	EXPECT_GT(Warm.WarmStartIterations, 0u);
+	EXPECT_LT(FoldIterations + Warm.WarmStartIterations, 2000u);
+	EXPECT_NEAR(Warm.MeanLoss, Cold.MeanLoss, 1.0e-4 * Cold.MeanLoss);
+}
+
+
+TEST(CrossValidation, NormalEquationFoldsMatchDirectSolves)
+{
+	const TrainingSet Set = MakeLinearSet(157);
+	const FoldPartition Folds(Set, 4, 3);
+	const CrossValidationResult Result = CrossValidateNormalEquation(Folds, 1.0e-3);
+
+	ASSERT_EQ(Result.FoldLoss.size(), 4u);
+	for (std::size_t Fold = 0; Fold < 4; Fold++) {
+		const std::vector<double> Theta =
+			LinearRegression::NormalEquationSystem::Accumulate(Folds.Training(Fold)).Solve(1.0e-3);
+		const double Expected = 2.0 * LinearRegression::ComputeCost(Folds.HeldOut(Fold), Theta, 0.0);
+		EXPECT_NEAR(Result.FoldLoss[Fold], Expected, 1.0e-9 * Expected) << "fold " << Fold;
+	}
+}
@@ -0,0 +1,330 @@
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <fcntl.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/wait.h>
+
+#include "LoopbackHttpServer.h"
+#include "MachineLearning/DistributedTraining/DataParallelTraining.h"
+#include "MachineLearning/LinearRegression/LinearModel.h"
+#include "MachineLearning/LinearRegression/NormalEquation.h"
+
+extern char** environ;
+
+using namespace LearnscrapeTest;
+using CoreUtilities::SocketEndpoint;
+using DistributedTraining::DistributedOptions;
+using DistributedTraining::DistributedResult;
+using DistributedTraining::TrainingCoordinator;
+using DistributedTraining::TrainingMethod;
+using ModelRepresentation::TrainingSet;
+using ModelRepresentation::TrainingView;
+
+namespace {
+
+const std::size_t NumRows = 24;
+
+
+// Row Row of the test data. Every feature is +1 or -1 on exactly half the
+// rows and every output is an integer, so the means, deviations and the
+// X^T X / X^T y sums are exact in any order: splitting the rows across
+// workers cannot change the normal equation by a single bit.
+std::string DataRow(std::size_t Row)
+{
+	const int X0 = (Row % 2) ? 1 : -1;
+	const int X1 = ((Row / 2) % 2) ? 1 : -1;
+	const int X2 = ((Row / 3) % 2) ? 1 : -1;
+	const int Y = 5 + 2 * X0 - 3 * X1 + X2 + static_cast<int>(Row % 3) - 1;
+	return std::to_string(X0) + "," + std::to_string(X1) + "," + std::to_string(X2) + "," + std::to_string(Y) + "\n";
+}
+
+
+// Write rows [Begin, End) to Path; the header alone when the range is empty.
+std::string WriteShard(const std::string& Path, std::size_t Begin, std::size_t End)
+{
+	std::ofstream File(Path, std::ios::trunc);
+	File << "a,b,c,y\n";
+	for (std::size_t Row = Begin; Row < End; Row++) {
+		File << DataRow(Row);
+	}
+	return Path;
+}
+
+
+// The single-process reference: the whole data set, standardised.
+TrainingSet LoadStandardised(const std::string& Path)
+{
+	TrainingSet Set = TrainingSet::LoadCsv(Path);
+	Set.Standardise();
+	return Set;
+}
+
+
+// Launches `learnscrape worker` processes and kills whatever is left of
+// them when it goes out of scope.
+class WorkerProcesses {
+private:
+	std::string Directory;
+	std::vector<pid_t> Running;
+
+public:
+	explicit WorkerProcesses(std::string InDirectory) : Directory(std::move(InDirectory)) {}
+	WorkerProcesses(const WorkerProcesses&) = delete;
+	WorkerProcesses& operator=(const WorkerProcesses&) = delete;
+
+	~WorkerProcesses()
+	{
+		for (const pid_t Process : Running) {
+			::kill(Process, SIGKILL);
+			::waitpid(Process, nullptr, 0);
+		}
+	}
+
+	// Join the job at Coordinator with Shard; output goes to a log file.
+	pid_t Launch(const SocketEndpoint& Coordinator, const std::string& Shard)
+	{
+		const std::size_t Number = Running.size();
+		const std::string Ring = "unix:" + Directory + "/ring" + std::to_string(Number);
+		const std::string Log = Directory + "/worker" + std::to_string(Number) + ".log";
+		const std::string CoordinatorText = Coordinator.ToString();
+		std::vector<std::string> Arguments = {LEARNSCRAPE_EXECUTABLE, "worker", CoordinatorText, Shard, Ring};
+		std::vector<char*> Argv;
+		for (std::string& Argument : Arguments) {
+			Argv.push_back(&Argument[0]);
+		}
+		Argv.push_back(nullptr);
+
+		posix_spawn_file_actions_t Actions;
+		posix_spawn_file_actions_init(&Actions);
+		posix_spawn_file_actions_addopen(&Actions, 1, Log.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+		posix_spawn_file_actions_adddup2(&Actions, 1, 2);
+		pid_t Process;
+		const int Error = posix_spawn(&Process, LEARNSCRAPE_EXECUTABLE, &Actions, nullptr, Argv.data(), environ);
+		posix_spawn_file_actions_destroy(&Actions);
+		if (Error != 0) {
+			throw std::runtime_error("cannot launch " + std::string(LEARNSCRAPE_EXECUTABLE));
+		}
+		Running.push_back(Process);
+		return Process;
+	}
+
+	pid_t GetProcess(std::size_t Number) const { return Running[Number]; }
+
+	// Wait for every worker and expect each to have exited cleanly.
+	void ExpectSuccess()
+	{
+		for (const pid_t Process : Running) {
+			int Status = 0;
+			ASSERT_EQ(::waitpid(Process, &Status, 0), Process);
+			EXPECT_TRUE(WIFEXITED(Status) && WEXITSTATUS(Status) == 0) << "worker status " << Status;
+		}
+		Running.clear();
+	}
+};
+
+
+struct JobDirectory {
+	std::string Path = MakeTemporaryDirectory();
+	~JobDirectory() { std::filesystem::remove_all(Path); }
+
+	SocketEndpoint Coordinator() const { return SocketEndpoint::Parse("unix:" + Path + "/coordinator"); }
+};
+
+
+// Split the rows into NumWorkers contiguous shards of near-equal size.
+std::vector<std::string> SplitRows(const std::string& Directory, std::size_t NumWorkers)
+{
+	std::vector<std::string> Shards;
+	for (std::size_t Worker = 0; Worker < NumWorkers; Worker++) {
+		Shards.push_back(WriteShard(Directory + "/shard" + std::to_string(Worker) + ".csv",
+		                            NumRows * Worker / NumWorkers, NumRows * (Worker + 1) / NumWorkers));
+	}
+	return Shards;
+}
+
+
+DistributedResult RunJob(const JobDirectory& Job, const std::vector<std::string>& Shards, DistributedOptions Options)
+{
+	TrainingCoordinator Coordinator(Job.Coordinator(), Shards.size(), Options);
+	WorkerProcesses Workers(Job.Path);
+	for (const std::string& Shard : Shards) {
+		Workers.Launch(Coordinator.GetEndpoint(), Shard);
+	}
+	const DistributedResult Result = Coordinator.Run();
+	Workers.ExpectSuccess();
+	return Result;
+}
+
+
+DistributedOptions NormalEquationOptions()
+{
+	DistributedOptions Options;
+	Options.Method = TrainingMethod::NormalEquation;
+	Options.Lambda = 1.0e-6;
+	Options.TimeoutSeconds = 10.0;
+	return Options;
+}
+
+
+DistributedOptions DescentOptions(std::size_t Iterations)
+{
+	DistributedOptions Options;
+	Options.Method = TrainingMethod::LinearDescent;
+	Options.LearningRate = 0.05;
+	Options.MaxIterations = Iterations;
+	Options.TimeoutSeconds = 10.0;
+	return Options;
+}
+
+} // namespace
+
+
+TEST(DataParallelTraining, NormalEquationMatchesOneProcessBitForBit)
+{
+	JobDirectory Job;
+	const TrainingSet Whole = LoadStandardised(WriteShard(Job.Path + "/all.csv", 0, NumRows));
+	const std::vector<double> Expected =
+		LinearRegression::NormalEquationSystem::Accumulate(TrainingView(Whole)).Solve(NormalEquationOptions().Lambda);
+
+	for (const std::size_t NumWorkers : {1u, 3u, 4u}) {
+		const DistributedResult Result = RunJob(Job, SplitRows(Job.Path, NumWorkers), NormalEquationOptions());
+		EXPECT_EQ(Result.NumWorkers, NumWorkers);
+		EXPECT_EQ(Result.NumExamples, NumRows);
+		EXPECT_EQ(Result.Theta, Expected) << NumWorkers << " workers";
+	}
+}
+
+
+TEST(DataParallelTraining, OneWorkerDescentMatchesOneProcessBitForBit)
+{
+	JobDirectory Job;
+	const TrainingSet Whole = LoadStandardised(WriteShard(Job.Path + "/all.csv", 0, NumRows));
+	const DistributedOptions Options = DescentOptions(60);
+	LinearRegression::LinearModel Model(Options.LearningRate, 0.0);
+	Model.Train(TrainingView(Whole), Options.MaxIterations);
+
+	const DistributedResult Result = RunJob(Job, SplitRows(Job.Path, 1), Options);
+	EXPECT_EQ(Result.Iterations, Options.MaxIterations);
+	EXPECT_EQ(Result.Theta, Model.GetTheta());
+}
+
+
+TEST(DataParallelTraining, ShardedDescentMatchesOneProcessToRounding)
+{
+	// With several shards each step's gradient is a sum of per-shard terms,
+	// added in ring order rather than row order, so it can differ from the
+	// single-process gradient in the last bits; the coordinator has already
+	// checked that every rank holds the same theta.
+	JobDirectory Job;
+	const TrainingSet Whole = LoadStandardised(WriteShard(Job.Path + "/all.csv", 0, NumRows));
+	const DistributedOptions Options = DescentOptions(60);
+	LinearRegression::LinearModel Model(Options.LearningRate, 0.0);
+	Model.Train(TrainingView(Whole), Options.MaxIterations);
+
+	for (const std::size_t NumWorkers : {3u, 4u}) {
+		const DistributedResult Result = RunJob(Job, SplitRows(Job.Path, NumWorkers), Options);
+		EXPECT_EQ(Result.Iterations, Options.MaxIterations);
+		ASSERT_EQ(Result.Theta.size(), Model.GetTheta().size());
+		for (std::size_t Index = 0; Index < Result.Theta.size(); Index++) {
+			EXPECT_NEAR(Result.Theta[Index], Model.GetTheta()[Index], 1.0e-12 * (1.0 + std::fabs(Model.GetTheta()[Index])))
+				<< NumWorkers << " workers, theta[" << Index << "]";
+		}
+	}
+}
+
+
+TEST(DataParallelTraining, AcceptsAnEmptyShard)
+{
+	JobDirectory Job;
+	const TrainingSet Whole = LoadStandardised(WriteShard(Job.Path + "/all.csv", 0, NumRows));
+	const std::vector<double> Expected =
+		LinearRegression::NormalEquationSystem::Accumulate(TrainingView(Whole)).Solve(NormalEquationOptions().Lambda);
+
+	const std::vector<std::string> Shards = {WriteShard(Job.Path + "/first.csv", 0, 10),
+	                                         WriteShard(Job.Path + "/empty.csv", 10, 10),
+	                                         WriteShard(Job.Path + "/last.csv", 10, NumRows)};
+	const DistributedResult Result = RunJob(Job, Shards, NormalEquationOptions());
+	EXPECT_EQ(Result.NumExamples, NumRows);
+	EXPECT_EQ(Result.Theta, Expected);
+}
+
+
+TEST(DataParallelTraining, RejectsShardsWithoutRows)
+{
+	JobDirectory Job;
+	const std::vector<std::string> Shards = {WriteShard(Job.Path + "/empty0.csv", 0, 0),
+	                                         WriteShard(Job.Path + "/empty1.csv", 0, 0)};
+	TrainingCoordinator Coordinator(Job.Coordinator(), Shards.size(), NormalEquationOptions());
+	WorkerProcesses Workers(Job.Path);
+	for (const std::string& Shard : Shards) {
+		Workers.Launch(Coordinator.GetEndpoint(), Shard);
+	}
+	try {
+		Coordinator.Run();
+		FAIL() << "a job without rows ran";
+	} catch (const std::runtime_error& Error) {
+		EXPECT_NE(std::string(Error.what()).find("the shards hold no rows"), std::string::npos) << Error.what();
+	}
+}
+
+
+TEST(DataParallelTraining, RejectsShardsWithDifferentFeatures)
+{
+	JobDirectory Job;
+	const std::string Narrow = Job.Path + "/narrow.csv";
+	{
+		std::ofstream File(Narrow);
+		File << "a,b,y\n1,-1,3\n-1,1,4\n";
+	}
+	const std::vector<std::string> Shards = {WriteShard(Job.Path + "/wide.csv", 0, NumRows), Narrow};
+	TrainingCoordinator Coordinator(Job.Coordinator(), Shards.size(), NormalEquationOptions());
+	WorkerProcesses Workers(Job.Path);
+	for (const std::string& Shard : Shards) {
+		Workers.Launch(Coordinator.GetEndpoint(), Shard);
+	}
+	try {
+		Coordinator.Run();
+		FAIL() << "shards of different widths were trained together";
+	} catch (const std::runtime_error& Error) {
+		EXPECT_NE(std::string(Error.what()).find("features"), std::string::npos) << Error.what();
+	}
+}
+
+
+TEST(DataParallelTraining, FailsWhenAWorkerDiesOrStalls)
+{
+	// Descent that would run for a long time; the observer takes a worker
+	// down part-way. A killed worker closes its connection at once, a
+	// stopped one stays silent until the coordinator's timeout.
+	for (const int Signal : {SIGKILL, SIGSTOP}) {
+		JobDirectory Job;
+		const std::vector<std::string> Shards = SplitRows(Job.Path, 3);
+		DistributedOptions Options = DescentOptions(100000000);
+		Options.TimeoutSeconds = 1.0;
+		TrainingCoordinator Coordinator(Job.Coordinator(), Shards.size(), Options);
+		WorkerProcesses Workers(Job.Path);
+		for (const std::string& Shard : Shards) {
+			Workers.Launch(Coordinator.GetEndpoint(), Shard);
+		}
+		Coordinator.SetIterationObserver([&Workers, Signal](std::size_t Steps, double) {
+			if (Steps == 20) {
+				::kill(Workers.GetProcess(1), Signal);
+			}
+		});
+
+		const auto Start = std::chrono::steady_clock::now();
+		EXPECT_THROW(Coordinator.Run(), std::runtime_error) << "signal " << Signal;
+		const double Elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+		EXPECT_LT(Elapsed, 5.0) << "signal " << Signal;
+	}
+}
@@ -0,0 +1,166 @@
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "LoopbackHttpServer.h"
+#include "WebScraping/HttpClient.h"
+
+using namespace LearnscrapeTest;
+using WebScraping::HttpConnection;
+using WebScraping::HttpResponse;
+using WebScraping::Url;
+
+
+TEST(HttpClient, ParsesAndResolvesUrls)
+{
+	const Url Page = Url::Parse("HTTP://Example.org:8080/wiki/Hydrogen?action=raw#History");
+	EXPECT_EQ(Page.Scheme, "http");
+	EXPECT_EQ(Page.Host, "example.org");
+	EXPECT_EQ(Page.Port, 8080);
+	EXPECT_EQ(Page.Target, "/wiki/Hydrogen?action=raw");
+	EXPECT_EQ(Page.GetOrigin(), "http://example.org:8080");
+
+	EXPECT_EQ(Page.Resolve("Helium").ToString(), "http://example.org:8080/wiki/Helium");
+	EXPECT_EQ(Page.Resolve("/w/index.php").ToString(), "http://example.org:8080/w/index.php");
+	EXPECT_EQ(Page.Resolve("?action=edit").ToString(), "http://example.org:8080/wiki/Hydrogen?action=edit");
+	EXPECT_EQ(Page.Resolve("//other.org/x").ToString(), "http://other.org/x");
+	EXPECT_EQ(Url::Parse("https://[::1]/").Host, "::1");
+
+	EXPECT_THROW(Url::Parse("ftp://example.org/"), std::invalid_argument);
+	EXPECT_THROW(Url::Parse("example.org/"), std::invalid_argument);
+	EXPECT_THROW(Url::Parse("http://example.org:99999/"), std::invalid_argument);
+}
+
+
+TEST(HttpClient, ReadsContentLengthBodiesAndReusesTheConnection)
+{
+	const std::string Page = ReadFixture("Hydrogen.html");
+	LoopbackHttpServer Server([&Page](const LoopbackRequest& Request) {
+		return ContentLengthReply(200, Request.Target == "/wiki/Hydrogen" ? Page : "second",
+		                          {"Content-Type: text/html", "ETag: \"v1\""});
+	});
+
+	const Url Target = Url::Parse(Server.GetUrl("/wiki/Hydrogen"));
+	HttpConnection Connection(Target, 5.0);
+	const HttpResponse First = Connection.Send("GET", Target, {{"X-Probe", "1"}});
+	EXPECT_EQ(First.StatusCode, 200);
+	EXPECT_EQ(First.Body, Page);
+	ASSERT_NE(First.FindHeader("etag"), nullptr);
+	EXPECT_EQ(*First.FindHeader("etag"), "\"v1\"");
+	EXPECT_TRUE(Connection.IsReusable());
+
+	const HttpResponse Second = Connection.Send("GET", Target.Resolve("/other"));
+	EXPECT_EQ(Second.Body, "second");
+
+	EXPECT_EQ(Server.GetNumConnections(), 1u);
+	const std::vector<LoopbackRequest> Requests = Server.GetRequests();
+	ASSERT_EQ(Requests.size(), 2u);
+	ASSERT_NE(Requests[0].FindHeader("x-probe"), nullptr);
+	EXPECT_EQ(*Requests[0].FindHeader("host"), "127.0.0.1:" + std::to_string(Server.GetPort()));
+	EXPECT_EQ(Requests[1].Connection, Requests[0].Connection);
+}
+
+
+TEST(HttpClient, ReadsChunkedBodies)
+{
+	LoopbackHttpServer Server([](const LoopbackRequest&) {
+		return ChunkedReply(200, {"<html><title>Chunked", "</title>", std::string(70000, 'x'), "</html>"});
+	});
+
+	const Url Target = Url::Parse(Server.GetUrl("/chunked"));
+	HttpConnection Connection(Target, 5.0);
+	const HttpResponse Response = Connection.Send("GET", Target);
+	EXPECT_EQ(Response.StatusCode, 200);
+	EXPECT_EQ(Response.Body, "<html><title>Chunked</title>" + std::string(70000, 'x') + "</html>");
+	EXPECT_TRUE(Connection.IsReusable());
+
+	// The trailer was consumed, so the next response parses cleanly.
+	EXPECT_EQ(Connection.Send("GET", Target).Body.size(), Response.Body.size());
+	EXPECT_EQ(Server.GetNumConnections(), 1u);
+}
+
+
+TEST(HttpClient, ReadsCloseDelimitedBodiesAndDropsTheConnection)
+{
+	LoopbackHttpServer Server([](const LoopbackRequest&) {
+		return CloseDelimitedReply(200, "until the end", {"Content-Type: text/plain"});
+	});
+
+	const Url Target = Url::Parse(Server.GetUrl("/legacy"));
+	HttpConnection Connection(Target, 5.0);
+	const HttpResponse Response = Connection.Send("GET", Target);
+	EXPECT_EQ(Response.Body, "until the end");
+	EXPECT_FALSE(Response.bKeepAlive);
+	EXPECT_FALSE(Connection.IsReusable());
+}
+
+
+TEST(HttpClient, HonoursConnectionCloseAndSkipsInterimResponses)
+{
+	LoopbackHttpServer Server([](const LoopbackRequest& Request) {
+		LoopbackReply Reply = ContentLengthReply(200, "done", {"Connection: close"});
+		if (Request.Target == "/continue") {
+			Reply.Bytes = "HTTP/1.1 100 Continue\r\n\r\n" + Reply.Bytes;
+		}
+		return Reply;
+	});
+
+	const Url Target = Url::Parse(Server.GetUrl("/continue"));
+	HttpConnection Connection(Target, 5.0);
+	const HttpResponse Response = Connection.Send("GET", Target);
+	EXPECT_EQ(Response.StatusCode, 200);
+	EXPECT_EQ(Response.Body, "done");
+	EXPECT_FALSE(Connection.IsReusable());
+}
+
+
+TEST(HttpClient, ReportsTruncatedBodiesAndTimeouts)
+{
+	LoopbackHttpServer Server([](const LoopbackRequest& Request) {
+		LoopbackReply Reply;
+		if (Request.Target == "/truncated") {
+			Reply.Bytes = "HTTP/1.1 200 OK\r\nContent-Length: 100\r\n\r\nshort";
+			Reply.bClose = true;
+		} else {
+			Reply = ContentLengthReply(200, "late");
+			Reply.DelaySeconds = 2.0;
+		}
+		return Reply;
+	});
+
+	const Url Truncated = Url::Parse(Server.GetUrl("/truncated"));
+	HttpConnection First(Truncated, 5.0);
+	EXPECT_THROW(First.Send("GET", Truncated), std::runtime_error);
+	EXPECT_FALSE(First.IsReusable());
+	EXPECT_FALSE(First.WasDroppedIdle());
+
+	const Url Slow = Url::Parse(Server.GetUrl("/slow"));
+	HttpConnection Second(Slow, 0.2);
+	EXPECT_THROW(Second.Send("GET", Slow), std::runtime_error);
+	EXPECT_FALSE(Second.WasDroppedIdle());
+}
+
+
+TEST(HttpClient, FlagsAConnectionTheServerDroppedWhileIdle)
+{
+	// Answers once, without announcing the close, then hangs up.
+	LoopbackHttpServer Server([](const LoopbackRequest&) {
+		LoopbackReply Reply = ContentLengthReply(200, "once");
+		Reply.bClose = true;
+		return Reply;
+	});
+
+	const Url Target = Url::Parse(Server.GetUrl("/once"));
+	HttpConnection Connection(Target, 5.0);
+	EXPECT_EQ(Connection.Send("GET", Target).Body, "once");
+	ASSERT_TRUE(Connection.IsReusable());
+
+	while (Server.GetRequests().empty() || Server.GetRequests()[0].Replied < 0.0) {
+		std::this_thread::yield();
+	}
+	EXPECT_THROW(Connection.Send("GET", Target), std::runtime_error);
+	EXPECT_TRUE(Connection.WasDroppedIdle());
+}
@@ -0,0 +1,337 @@
+#include "LoopbackHttpServer.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace LearnscrapeTest {
+
+namespace {
+
+const int PollMilliseconds = 20;
+
+
+std::string ToLower(std::string Text)
+{
+	std::transform(Text.begin(), Text.end(), Text.begin(),
+	               [](unsigned char Character) { return static_cast<char>(std::tolower(Character)); });
+	return Text;
+}
+
+
+std::string TrimSpace(const std::string& Text)
+{
+	const std::size_t First = Text.find_first_not_of(" \t");
+	if (First == std::string::npos) {
+		return "";
+	}
+	return Text.substr(First, Text.find_last_not_of(" \t") - First + 1);
+}
+
+
+std::string ReasonPhrase(int StatusCode)
+{
+	switch (StatusCode) {
+	case 200: return "OK";
+	case 301: return "Moved Permanently";
+	case 302: return "Found";
+	case 304: return "Not Modified";
+	case 404: return "Not Found";
+	case 429: return "Too Many Requests";
+	case 500: return "Internal Server Error";
+	case 503: return "Service Unavailable";
+	default: return "Status";
+	}
+}
+
+
+std::string StatusAndHeaders(const std::string& Version, int StatusCode, const std::vector<std::string>& Headers)
+{
+	std::string Text = Version + " " + std::to_string(StatusCode) + " " + ReasonPhrase(StatusCode) + "\r\n";
+	for (const std::string& Header : Headers) {
+		Text += Header + "\r\n";
+	}
+	return Text;
+}
+
+
+bool SendAll(int Descriptor, const std::string& Data)
+{
+	std::size_t Sent = 0;
+	while (Sent < Data.size()) {
+		const ssize_t Written = ::send(Descriptor, Data.data() + Sent, Data.size() - Sent, MSG_NOSIGNAL);
+		if (Written < 0 && errno == EINTR) {
+			continue;
+		}
+		if (Written <= 0) {
+			return false;
+		}
+		Sent += static_cast<std::size_t>(Written);
+	}
+	return true;
+}
+
+
+// Parse the request head in Head (without the blank line).
+LoopbackRequest ParseRequest(const std::string& Head)
+{
+	LoopbackRequest Request;
+	std::istringstream Lines(Head);
+	std::string Line;
+	std::getline(Lines, Line);
+	std::istringstream RequestLine(Line);
+	RequestLine >> Request.Method >> Request.Target;
+	while (std::getline(Lines, Line)) {
+		if (!Line.empty() && Line.back() == '\r') {
+			Line.pop_back();
+		}
+		const std::size_t Colon = Line.find(':');
+		if (Colon != std::string::npos) {
+			Request.Headers.emplace_back(ToLower(TrimSpace(Line.substr(0, Colon))), TrimSpace(Line.substr(Colon + 1)));
+		}
+	}
+	return Request;
+}
+
+} // namespace
+
+
+const std::string* LoopbackRequest::FindHeader(const std::string& Name) const
+{
+	for (const auto& Header : Headers) {
+		if (Header.first == Name) {
+			return &Header.second;
+		}
+	}
+	return nullptr;
+}
+
+
+/*============================================================================*/
+// LOOPBACK HTTP SERVER
+/*============================================================================*/
+
+LoopbackHttpServer::LoopbackHttpServer(Handler InRespond)
+	: Respond(std::move(InRespond)),
+	  ListenDescriptor(-1),
+	  Port(0),
+	  Started(std::chrono::steady_clock::now()),
+	  bStopping(false),
+	  NumConnections(0)
+{
+	ListenDescriptor = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	sockaddr_in Address;
+	std::memset(&Address, 0, sizeof(Address));
+	Address.sin_family = AF_INET;
+	Address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	socklen_t Length = sizeof(Address);
+	if (ListenDescriptor < 0 || ::bind(ListenDescriptor, reinterpret_cast<sockaddr*>(&Address), sizeof(Address)) != 0 ||
+	    ::listen(ListenDescriptor, 64) != 0 ||
+	    ::getsockname(ListenDescriptor, reinterpret_cast<sockaddr*>(&Address), &Length) != 0) {
+		if (ListenDescriptor >= 0) {
+			::close(ListenDescriptor);
+		}
+		throw std::runtime_error(std::string("LoopbackHttpServer: cannot listen: ") + std::strerror(errno));
+	}
+	Port = ntohs(Address.sin_port);
+	Acceptor = std::thread([this]() { AcceptLoop(); });
+}
+
+
+LoopbackHttpServer::~LoopbackHttpServer()
+{
+	bStopping.store(true);
+	Acceptor.join();
+	std::vector<std::thread> Running;
+	{
+		std::lock_guard<std::mutex> Guard(Lock);
+		Running.swap(Threads);
+	}
+	for (std::thread& Thread : Running) {
+		Thread.join();
+	}
+	::close(ListenDescriptor);
+}
+
+
+std::string LoopbackHttpServer::GetUrl(const std::string& Target) const
+{
+	return "http://127.0.0.1:" + std::to_string(Port) + Target;
+}
+
+
+std::vector<LoopbackRequest> LoopbackHttpServer::GetRequests() const
+{
+	std::lock_guard<std::mutex> Guard(Lock);
+	return Requests;
+}
+
+
+std::size_t LoopbackHttpServer::CountRequests(const std::string& Target) const
+{
+	std::lock_guard<std::mutex> Guard(Lock);
+	return static_cast<std::size_t>(std::count_if(Requests.begin(), Requests.end(),
+		[&Target](const LoopbackRequest& Request) { return Request.Target == Target; }));
+}
+
+
+std::size_t LoopbackHttpServer::GetNumConnections() const
+{
+	std::lock_guard<std::mutex> Guard(Lock);
+	return NumConnections;
+}
+
+
+double LoopbackHttpServer::Now() const
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - Started).count();
+}
+
+
+void LoopbackHttpServer::Pause(double Seconds) const
+{
+	const double Until = Now() + Seconds;
+	while (!bStopping.load() && Now() < Until) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(5));
+	}
+}
+
+
+void LoopbackHttpServer::AcceptLoop()
+{
+	while (!bStopping.load()) {
+		pollfd Watch{ListenDescriptor, POLLIN, 0};
+		if (::poll(&Watch, 1, PollMilliseconds) <= 0) {
+			continue;
+		}
+		const int Descriptor = ::accept4(ListenDescriptor, nullptr, nullptr, SOCK_CLOEXEC);
+		if (Descriptor < 0) {
+			continue;
+		}
+		std::lock_guard<std::mutex> Guard(Lock);
+		const std::size_t Connection = NumConnections++;
+		Threads.emplace_back([this, Descriptor, Connection]() { ServeConnection(Descriptor, Connection); });
+	}
+}
+
+
+void LoopbackHttpServer::ServeConnection(int Descriptor, std::size_t Connection)
+{
+	std::string Pending;
+	char Buffer[4096];
+
+	while (!bStopping.load()) {
+		const std::size_t HeadEnd = Pending.find("\r\n\r\n");
+		if (HeadEnd == std::string::npos) {
+			pollfd Watch{Descriptor, POLLIN, 0};
+			if (::poll(&Watch, 1, PollMilliseconds) <= 0) {
+				continue;
+			}
+			const ssize_t Read = ::recv(Descriptor, Buffer, sizeof(Buffer), 0);
+			if (Read <= 0) {
+				break;
+			}
+			Pending.append(Buffer, static_cast<std::size_t>(Read));
+			continue;
+		}
+
+		LoopbackRequest Request = ParseRequest(Pending.substr(0, HeadEnd));
+		Pending.erase(0, HeadEnd + 4);
+		Request.Connection = Connection;
+		Request.Arrived = Now();
+		std::size_t Slot;
+		{
+			std::lock_guard<std::mutex> Guard(Lock);
+			Slot = Requests.size();
+			Requests.push_back(Request);
+		}
+
+		const LoopbackReply Reply = Respond(Request);
+		Pause(Reply.DelaySeconds);
+		if (bStopping.load() || (!Reply.Bytes.empty() && !SendAll(Descriptor, Reply.Bytes))) {
+			break;
+		}
+		{
+			std::lock_guard<std::mutex> Guard(Lock);
+			Requests[Slot].Replied = Now();
+		}
+		if (Reply.bClose) {
+			break;
+		}
+	}
+	::close(Descriptor);
+}
+
+
+/*============================================================================*/
+// REPLIES
+/*============================================================================*/
+
+LoopbackReply ContentLengthReply(int StatusCode, const std::string& Body, const std::vector<std::string>& Headers)
+{
+	LoopbackReply Reply;
+	Reply.Bytes = StatusAndHeaders("HTTP/1.1", StatusCode, Headers) + "Content-Length: " +
+	              std::to_string(Body.size()) + "\r\n\r\n" + Body;
+	return Reply;
+}
+
+
+LoopbackReply ChunkedReply(int StatusCode, const std::vector<std::string>& Chunks, const std::vector<std::string>& Headers)
+{
+	LoopbackReply Reply;
+	Reply.Bytes = StatusAndHeaders("HTTP/1.1", StatusCode, Headers) + "Transfer-Encoding: chunked\r\n\r\n";
+	for (const std::string& Chunk : Chunks) {
+		std::ostringstream Size;
+		Size << std::hex << Chunk.size();
+		// A chunk extension, which readers must skip.
+		Reply.Bytes += Size.str() + ";note=x\r\n" + Chunk + "\r\n";
+	}
+	Reply.Bytes += "0\r\nX-Trailer: ignored\r\n\r\n";
+	return Reply;
+}
+
+
+LoopbackReply CloseDelimitedReply(int StatusCode, const std::string& Body, const std::vector<std::string>& Headers)
+{
+	LoopbackReply Reply;
+	Reply.Bytes = StatusAndHeaders("HTTP/1.0", StatusCode, Headers) + "\r\n" + Body;
+	Reply.bClose = true;
+	return Reply;
+}
+
+
+std::string ReadFixture(const std::string& Name)
+{
+	const std::string Path = std::string(LEARNSCRAPE_TEST_FIXTURES) + "/" + Name;
+	std::ifstream File(Path, std::ios::binary);
+	if (!File) {
+		throw std::runtime_error("ReadFixture: cannot open " + Path);
+	}
+	std::stringstream Buffer;
+	Buffer << File.rdbuf();
+	return Buffer.str();
+}
+
+
+std::string MakeTemporaryDirectory()
+{
+	const char* Base = std::getenv("TMPDIR");
+	std::string Template = std::string(Base && *Base ? Base : "/tmp") + "/learnscrape_test_XXXXXX";
+	if (::mkdtemp(&Template[0]) == nullptr) {
+		throw std::runtime_error("MakeTemporaryDirectory: cannot create " + Template);
+	}
+	return Template;
+}
+
+} // namespace LearnscrapeTest
@@ -0,0 +1,106 @@
+#ifndef __LoopbackHttpServer__
+#define __LoopbackHttpServer__
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "WebScraping/HttpClient.h"
+
+/* LOOPBACK HTTP SERVER */
+// Stand-in web server for the scraper tests. It listens on 127.0.0.1 at a
+// free port and serves each connection on its own thread, passing every
+// request to a handler. Handlers return the raw reply bytes, so a test
+// controls framing (Content-Length, chunked, close-delimited), delays and
+// dropped connections exactly. Saved pages live in test/fixtures.
+
+namespace LearnscrapeTest {
+
+struct LoopbackRequest {
+	std::string Method;
+	std::string Target;
+	// Names lower-cased.
+	WebScraping::HeaderList Headers;
+	// Serial number of the connection the request arrived on.
+	std::size_t Connection = 0;
+	// Seconds since the server started; Replied stays negative until the
+	// reply has been written.
+	double Arrived = 0.0;
+	double Replied = -1.0;
+
+	const std::string* FindHeader(const std::string& Name) const;
+};
+
+
+struct LoopbackReply {
+	// Written as-is; empty with bClose drops the connection unanswered.
+	std::string Bytes;
+	double DelaySeconds = 0.0;
+	bool bClose = false;
+};
+
+
+class LoopbackHttpServer {
+public:
+	using Handler = std::function<LoopbackReply(const LoopbackRequest&)>;
+
+private:
+	Handler Respond;
+	int ListenDescriptor;
+	std::uint16_t Port;
+	std::chrono::steady_clock::time_point Started;
+	std::atomic<bool> bStopping;
+
+	mutable std::mutex Lock;
+	std::vector<LoopbackRequest> Requests;
+	std::vector<std::thread> Threads;
+	std::size_t NumConnections;
+	std::thread Acceptor;
+
+	double Now() const;
+	void AcceptLoop();
+	void ServeConnection(int Descriptor, std::size_t Connection);
+	// Sleep Seconds unless the server stops first.
+	void Pause(double Seconds) const;
+
+public:
+	// Throws std::runtime_error if no loopback port can be bound.
+	explicit LoopbackHttpServer(Handler InRespond);
+	LoopbackHttpServer(const LoopbackHttpServer&) = delete;
+	LoopbackHttpServer& operator=(const LoopbackHttpServer&) = delete;
+	~LoopbackHttpServer();
+
+	std::uint16_t GetPort() const { return Port; }
+	std::string GetUrl(const std::string& Target) const;
+
+	// Every request so far, in arrival order.
+	std::vector<LoopbackRequest> GetRequests() const;
+	std::size_t CountRequests(const std::string& Target) const;
+	std::size_t GetNumConnections() const;
+};
+
+
+// Replies framed by Content-Length, by chunks, or by closing the
+// connection (HTTP/1.0 style). Extra headers are "Name: value" lines.
+LoopbackReply ContentLengthReply(int StatusCode, const std::string& Body,
+                                 const std::vector<std::string>& Headers = {});
+LoopbackReply ChunkedReply(int StatusCode, const std::vector<std::string>& Chunks,
+                           const std::vector<std::string>& Headers = {});
+LoopbackReply CloseDelimitedReply(int StatusCode, const std::string& Body,
+                                  const std::vector<std::string>& Headers = {});
+
+// Contents of test/fixtures/<Name>; throws std::runtime_error if missing.
+std::string ReadFixture(const std::string& Name);
+
+// Fresh empty directory under the system temp directory.
+std::string MakeTemporaryDirectory();
+
+} // namespace LearnscrapeTest
+
+#endif // __LoopbackHttpServer__
@@ -0,0 +1,225 @@
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "LoopbackHttpServer.h"
+#include "WebScraping/PageCache.h"
+
+using namespace LearnscrapeTest;
+using WebScraping::CacheOptions;
+using WebScraping::FetchedPage;
+using WebScraping::FetchOptions;
+using WebScraping::HashContent;
+using WebScraping::PageCache;
+using WebScraping::PageFetcher;
+using WebScraping::ScrapedRecord;
+
+namespace {
+
+// A fresh cache directory, removed with everything in it afterwards.
+struct ScopedDirectory {
+	std::string Path = MakeTemporaryDirectory();
+	~ScopedDirectory() { std::filesystem::remove_all(Path); }
+};
+
+
+std::size_t CountObjects(const std::string& Directory)
+{
+	std::size_t Count = 0;
+	for (const auto& File : std::filesystem::recursive_directory_iterator(Directory + "/objects")) {
+		Count += File.is_regular_file() ? 1 : 0;
+	}
+	return Count;
+}
+
+
+// Serves a copy of the Hydrogen page per target, tagged with the target so
+// each has its own body and ETag, and answers 304 to a matching
+// If-None-Match. "/same/..." targets all share one body and ETag.
+LoopbackReply ServeTagged(const LoopbackRequest& Request)
+{
+	static const std::string Page = ReadFixture("Hydrogen.html");
+	const bool bShared = Request.Target.compare(0, 6, "/same/") == 0;
+	const std::string Tag = bShared ? "/same" : Request.Target;
+	const std::string ETag = "\"" + Tag + "\"";
+	const std::string* Match = Request.FindHeader("if-none-match");
+	if (Match != nullptr && *Match == ETag) {
+		return ContentLengthReply(304, "", {"ETag: " + ETag});
+	}
+	return ContentLengthReply(200, Page + "<!-- " + Tag + " -->\n", {"Content-Type: text/html", "ETag: " + ETag});
+}
+
+
+// Fetch Address through Cache the way ScrapePipeline does; true when the
+// cached record was reused.
+bool FetchThrough(PageCache& Cache, PageFetcher& Fetcher, const std::string& Address, ScrapedRecord& Record)
+{
+	FetchedPage Page;
+	if (Cache.Fetch(Fetcher, Address, Page, Record)) {
+		return true;
+	}
+	Record = Cache.Extract(Page);
+	return false;
+}
+
+} // namespace
+
+
+TEST(PageCache, HashesFips180Vectors)
+{
+	EXPECT_EQ(HashContent(""), "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+	EXPECT_EQ(HashContent("abc"), "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+	// 56 bytes, so the length spills into a second padding block.
+	EXPECT_EQ(HashContent("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq"),
+	          "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+	EXPECT_EQ(HashContent(std::string(1000000, 'a')),
+	          "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+}
+
+
+TEST(PageCache, AnswersARevalidatedPageFromDisk)
+{
+	LoopbackHttpServer Server(ServeTagged);
+	ScopedDirectory Directory;
+	PageCache Cache(Directory.Path);
+	PageFetcher Fetcher;
+	const std::string Address = Server.GetUrl("/wiki/Hydrogen");
+
+	ScrapedRecord First;
+	EXPECT_FALSE(FetchThrough(Cache, Fetcher, Address, First));
+	ASSERT_TRUE(First.Error.empty()) << First.Error;
+	EXPECT_EQ(Cache.GetNumEntries(), 1u);
+
+	ScrapedRecord Second;
+	EXPECT_TRUE(FetchThrough(Cache, Fetcher, Address, Second));
+	EXPECT_EQ(Second.Fields, First.Fields);
+	EXPECT_EQ(Second.Url, Address);
+	ASSERT_NE(Second.Find("Atomic number"), nullptr);
+	EXPECT_EQ(*Second.Find("Atomic number"), "1");
+
+	const std::vector<LoopbackRequest> Requests = Server.GetRequests();
+	ASSERT_EQ(Requests.size(), 2u);
+	EXPECT_EQ(Requests[0].FindHeader("if-none-match"), nullptr);
+	ASSERT_NE(Requests[1].FindHeader("if-none-match"), nullptr);
+	EXPECT_EQ(*Requests[1].FindHeader("if-none-match"), "\"/wiki/Hydrogen\"");
+}
+
+
+TEST(PageCache, SkipsTheServerWhileAnEntryIsFresh)
+{
+	LoopbackHttpServer Server(ServeTagged);
+	ScopedDirectory Directory;
+	CacheOptions Options;
+	Options.FreshSeconds = 3600.0;
+	PageCache Cache(Directory.Path, Options);
+	PageFetcher Fetcher;
+	const std::string Address = Server.GetUrl("/wiki/Hydrogen");
+
+	ScrapedRecord Record;
+	EXPECT_FALSE(FetchThrough(Cache, Fetcher, Address, Record));
+	EXPECT_TRUE(FetchThrough(Cache, Fetcher, Address, Record));
+	EXPECT_EQ(Server.GetRequests().size(), 1u);
+}
+
+
+TEST(PageCache, StoresIdenticalBodiesOnce)
+{
+	LoopbackHttpServer Server(ServeTagged);
+	ScopedDirectory Directory;
+	PageCache Cache(Directory.Path);
+	PageFetcher Fetcher;
+
+	ScrapedRecord Record;
+	FetchThrough(Cache, Fetcher, Server.GetUrl("/same/a"), Record);
+	const std::uint64_t OneObject = Cache.GetStoredBytes();
+	FetchThrough(Cache, Fetcher, Server.GetUrl("/same/b"), Record);
+	EXPECT_EQ(Record.Url, Server.GetUrl("/same/b"));
+
+	EXPECT_EQ(Cache.GetNumEntries(), 2u);
+	EXPECT_EQ(Cache.GetStoredBytes(), OneObject);
+	EXPECT_EQ(CountObjects(Directory.Path), 1u);
+}
+
+
+TEST(PageCache, EvictsTheLeastRecentlyUsedEntriesToMaxBytes)
+{
+	LoopbackHttpServer Server(ServeTagged);
+	PageFetcher Fetcher;
+	ScrapedRecord Record;
+
+	// The tagged pages differ only in their tag, so their objects are
+	// about the same size; leave room for two of them.
+	std::uint64_t ObjectBytes;
+	{
+		ScopedDirectory Probe;
+		PageCache Cache(Probe.Path);
+		FetchThrough(Cache, Fetcher, Server.GetUrl("/page/0"), Record);
+		ObjectBytes = Cache.GetStoredBytes();
+	}
+	ASSERT_GT(ObjectBytes, 0u);
+
+	ScopedDirectory Directory;
+	CacheOptions Options;
+	Options.MaxBytes = ObjectBytes * 5 / 2;
+	PageCache Cache(Directory.Path, Options);
+	FetchThrough(Cache, Fetcher, Server.GetUrl("/page/1"), Record);
+	FetchThrough(Cache, Fetcher, Server.GetUrl("/page/2"), Record);
+	// Using /page/1 again leaves /page/2 the least recently used.
+	EXPECT_TRUE(FetchThrough(Cache, Fetcher, Server.GetUrl("/page/1"), Record));
+	FetchThrough(Cache, Fetcher, Server.GetUrl("/page/3"), Record);
+
+	EXPECT_EQ(Cache.GetNumEntries(), 2u);
+	EXPECT_LE(Cache.GetStoredBytes(), Options.MaxBytes);
+	EXPECT_EQ(CountObjects(Directory.Path), 2u);
+	EXPECT_TRUE(FetchThrough(Cache, Fetcher, Server.GetUrl("/page/1"), Record));
+	EXPECT_TRUE(FetchThrough(Cache, Fetcher, Server.GetUrl("/page/3"), Record));
+
+	// The evicted page is fetched in full, without validators.
+	const std::size_t Before = Server.GetRequests().size();
+	EXPECT_FALSE(FetchThrough(Cache, Fetcher, Server.GetUrl("/page/2"), Record));
+	const std::vector<LoopbackRequest> Requests = Server.GetRequests();
+	ASSERT_EQ(Requests.size(), Before + 1);
+	EXPECT_EQ(Requests.back().FindHeader("if-none-match"), nullptr);
+}
+
+
+TEST(PageCache, ReloadsItsIndexWhenReopened)
+{
+	LoopbackHttpServer Server(ServeTagged);
+	ScopedDirectory Directory;
+	PageFetcher Fetcher;
+	ScrapedRecord Record;
+
+	std::uint64_t StoredBytes;
+	{
+		PageCache Cache(Directory.Path);
+		FetchThrough(Cache, Fetcher, Server.GetUrl("/page/0"), Record);
+		FetchThrough(Cache, Fetcher, Server.GetUrl("/page/1"), Record);
+		FetchThrough(Cache, Fetcher, Server.GetUrl("/same/a"), Record);
+		FetchThrough(Cache, Fetcher, Server.GetUrl("/same/b"), Record);
+		StoredBytes = Cache.GetStoredBytes();
+	}
+
+	{
+		PageCache Cache(Directory.Path);
+		EXPECT_EQ(Cache.GetNumEntries(), 4u);
+		EXPECT_EQ(Cache.GetStoredBytes(), StoredBytes);
+		EXPECT_TRUE(FetchThrough(Cache, Fetcher, Server.GetUrl("/page/0"), Record));
+		EXPECT_EQ(Record.Url, Server.GetUrl("/page/0"));
+		EXPECT_TRUE(FetchThrough(Cache, Fetcher, Server.GetUrl("/same/b"), Record));
+	}
+
+	// Reopening under half the budget evicts down to it straight away, in
+	// the use order the index recorded: of the three objects only the one
+	// behind /same/b, used last, survives.
+	CacheOptions Options;
+	Options.MaxBytes = StoredBytes / 2;
+	PageCache Cache(Directory.Path, Options);
+	EXPECT_EQ(Cache.GetNumEntries(), 1u);
+	EXPECT_LE(Cache.GetStoredBytes(), Options.MaxBytes);
+	EXPECT_EQ(CountObjects(Directory.Path), 1u);
+	EXPECT_TRUE(FetchThrough(Cache, Fetcher, Server.GetUrl("/same/b"), Record));
+}
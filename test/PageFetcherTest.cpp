@@ -0,0 +1,196 @@
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "LoopbackHttpServer.h"
+#include "WebScraping/PageFetcher.h"
+
+using namespace LearnscrapeTest;
+using WebScraping::FetchedPage;
+using WebScraping::FetchOptions;
+using WebScraping::PageFetcher;
+
+namespace {
+
+// Short backoff so retries cost the tests little time.
+FetchOptions QuickOptions()
+{
+	FetchOptions Options;
+	Options.MaxAttempts = 3;
+	Options.InitialBackoffSeconds = 0.01;
+	Options.MaxBackoffSeconds = 2.0;
+	Options.TimeoutSeconds = 5.0;
+	return Options;
+}
+
+
+double SecondsSince(std::chrono::steady_clock::time_point Start)
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+}
+
+} // namespace
+
+
+TEST(PageFetcher, FollowsRedirectsWithoutSpendingAttempts)
+{
+	const std::string Page = ReadFixture("Helium.html");
+	LoopbackHttpServer Server([&Page](const LoopbackRequest& Request) {
+		if (Request.Target == "/Helium") {
+			return ContentLengthReply(301, "", {"Location: /wiki/Helium"});
+		}
+		if (Request.Target == "/wiki/Helium") {
+			return ContentLengthReply(302, "", {"Location: Helium_(element)"});
+		}
+		return ContentLengthReply(200, Page, {"Content-Type: text/html"});
+	});
+
+	PageFetcher Fetcher(QuickOptions());
+	const FetchedPage Fetched = Fetcher.Fetch(Server.GetUrl("/Helium"));
+	EXPECT_TRUE(Fetched.IsOk()) << Fetched.Error;
+	EXPECT_EQ(Fetched.RequestedUrl, Server.GetUrl("/Helium"));
+	EXPECT_EQ(Fetched.FinalUrl, Server.GetUrl("/wiki/Helium_(element)"));
+	EXPECT_EQ(Fetched.Attempts, 1u);
+	EXPECT_EQ(Fetched.Response.Body, Page);
+	// All three hops share the keep-alive connection.
+	EXPECT_EQ(Server.GetNumConnections(), 1u);
+}
+
+
+TEST(PageFetcher, StopsARedirectLoop)
+{
+	LoopbackHttpServer Server([](const LoopbackRequest& Request) {
+		return ContentLengthReply(302, "", {Request.Target == "/a" ? "Location: /b" : "Location: /a"});
+	});
+
+	FetchOptions Options = QuickOptions();
+	Options.MaxRedirects = 3;
+	PageFetcher Fetcher(Options);
+	const FetchedPage Fetched = Fetcher.Fetch(Server.GetUrl("/a"));
+	EXPECT_FALSE(Fetched.IsOk());
+	EXPECT_EQ(Fetched.Error, "too many redirects");
+	EXPECT_EQ(Server.GetRequests().size(), 4u);
+}
+
+
+TEST(PageFetcher, RetriesServerErrorsAndHonoursRetryAfter)
+{
+	std::atomic<int> Calls{0};
+	LoopbackHttpServer Server([&Calls](const LoopbackRequest&) {
+		if (Calls++ == 0) {
+			return ContentLengthReply(503, "busy", {"Retry-After: 0.3"});
+		}
+		return ContentLengthReply(200, "<html><title>ok</title></html>");
+	});
+
+	PageFetcher Fetcher(QuickOptions());
+	const auto Start = std::chrono::steady_clock::now();
+	const FetchedPage Fetched = Fetcher.Fetch(Server.GetUrl("/busy"));
+	EXPECT_TRUE(Fetched.IsOk()) << Fetched.Error;
+	EXPECT_EQ(Fetched.Attempts, 2u);
+	// The backoff window alone would have been 10 ms at most.
+	EXPECT_GE(SecondsSince(Start), 0.3);
+}
+
+
+TEST(PageFetcher, GivesUpAfterMaxAttemptsOnTooManyRequests)
+{
+	LoopbackHttpServer Server([](const LoopbackRequest&) {
+		return ContentLengthReply(429, "slow down", {"Retry-After: 0"});
+	});
+
+	PageFetcher Fetcher(QuickOptions());
+	const FetchedPage Fetched = Fetcher.Fetch(Server.GetUrl("/limited"));
+	EXPECT_FALSE(Fetched.IsOk());
+	EXPECT_EQ(Fetched.Attempts, 3u);
+	EXPECT_EQ(Fetched.Response.StatusCode, 429);
+	EXPECT_EQ(Fetched.Error, "HTTP 429");
+	EXPECT_EQ(Server.GetRequests().size(), 3u);
+}
+
+
+TEST(PageFetcher, DoesNotRetryClientErrors)
+{
+	LoopbackHttpServer Server([](const LoopbackRequest&) { return ContentLengthReply(404, "missing"); });
+
+	PageFetcher Fetcher(QuickOptions());
+	const FetchedPage Fetched = Fetcher.Fetch(Server.GetUrl("/missing"));
+	EXPECT_FALSE(Fetched.IsOk());
+	EXPECT_TRUE(Fetched.Error.empty());
+	EXPECT_EQ(Fetched.Response.StatusCode, 404);
+	EXPECT_EQ(Fetched.Attempts, 1u);
+}
+
+
+TEST(PageFetcher, ReconnectsSilentlyWhenAnIdleConnectionWasDropped)
+{
+	// Every reply hangs up afterwards without saying so.
+	LoopbackHttpServer Server([](const LoopbackRequest&) {
+		LoopbackReply Reply = ContentLengthReply(200, "<html></html>");
+		Reply.bClose = true;
+		return Reply;
+	});
+
+	PageFetcher Fetcher(QuickOptions());
+	ASSERT_TRUE(Fetcher.Fetch(Server.GetUrl("/first")).IsOk());
+	while (Server.GetRequests()[0].Replied < 0.0) {
+		std::this_thread::yield();
+	}
+	const FetchedPage Second = Fetcher.Fetch(Server.GetUrl("/second"));
+	EXPECT_TRUE(Second.IsOk()) << Second.Error;
+	EXPECT_EQ(Second.Attempts, 1u);
+	EXPECT_EQ(Server.GetNumConnections(), 2u);
+}
+
+
+TEST(PageFetcher, CountsATimeoutOnAReusedConnectionAsAnAttempt)
+{
+	std::atomic<int> SlowCalls{0};
+	LoopbackHttpServer Server([&SlowCalls](const LoopbackRequest& Request) {
+		LoopbackReply Reply = ContentLengthReply(200, "<html></html>");
+		if (Request.Target == "/slow" && SlowCalls++ == 0) {
+			Reply.DelaySeconds = 1.0;
+		}
+		return Reply;
+	});
+
+	FetchOptions Options = QuickOptions();
+	Options.TimeoutSeconds = 0.3;
+	PageFetcher Fetcher(Options);
+	ASSERT_TRUE(Fetcher.Fetch(Server.GetUrl("/warm")).IsOk());
+
+	const auto Start = std::chrono::steady_clock::now();
+	const FetchedPage Fetched = Fetcher.Fetch(Server.GetUrl("/slow"));
+	EXPECT_TRUE(Fetched.IsOk()) << Fetched.Error;
+	// The timeout went through retry and backoff instead of an immediate,
+	// uncounted resend.
+	EXPECT_EQ(Fetched.Attempts, 2u);
+	EXPECT_EQ(Server.CountRequests("/slow"), 2u);
+	EXPECT_LT(SecondsSince(Start), 1.0);
+}
+
+
+TEST(PageFetcher, ReportsUnreachableHostsAndBadUrls)
+{
+	FetchOptions Options = QuickOptions();
+	Options.MaxAttempts = 2;
+	PageFetcher Fetcher(Options);
+
+	// Bind and release a port so nothing listens on it.
+	std::string Unused;
+	{
+		LoopbackHttpServer Server([](const LoopbackRequest&) { return LoopbackReply(); });
+		Unused = Server.GetUrl("/");
+	}
+	const FetchedPage Refused = Fetcher.Fetch(Unused);
+	EXPECT_FALSE(Refused.IsOk());
+	EXPECT_EQ(Refused.Attempts, 2u);
+	EXPECT_NE(Refused.Error.find("cannot connect"), std::string::npos) << Refused.Error;
+
+	const FetchedPage Malformed = Fetcher.Fetch("gopher://example.org/");
+	EXPECT_FALSE(Malformed.IsOk());
+	EXPECT_EQ(Malformed.Attempts, 0u);
+}
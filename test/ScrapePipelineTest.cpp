@@ -0,0 +1,163 @@
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "LoopbackHttpServer.h"
+#include "WebScraping/ScrapePipeline.h"
+
+using namespace LearnscrapeTest;
+using ModelRepresentation::TrainingSet;
+using WebScraping::RecordSchema;
+using WebScraping::ScrapeOptions;
+using WebScraping::ScrapePipeline;
+
+namespace {
+
+const std::vector<std::string> ElementNames = {"Hydrogen", "Helium", "Lithium", "Beryllium", "Boron", "Carbon"};
+const std::vector<double> AtomicWeights = {1.008, 4.0026, 6.94, 9.0122, 10.81, 12.011};
+
+
+RecordSchema ElementSchema()
+{
+	RecordSchema Schema;
+	Schema.FeatureFields = {"Atomic number", "Density"};
+	Schema.OutputField = "Standard atomic weight";
+	return Schema;
+}
+
+
+// "/page/<n>" serves the saved page of element n mod 6.
+std::size_t PageNumber(const std::string& Target)
+{
+	return std::stoul(Target.substr(Target.rfind('/') + 1));
+}
+
+
+LoopbackReply ServeElement(std::size_t Number)
+{
+	return ContentLengthReply(200, ReadFixture(ElementNames[Number % ElementNames.size()] + ".html"),
+	                          {"Content-Type: text/html; charset=UTF-8"});
+}
+
+} // namespace
+
+
+TEST(ScrapePipeline, KeepsUrlOrderWhenPagesFinishOutOfOrder)
+{
+	// Earlier pages answer later, so completion order is the reverse of
+	// the URL list.
+	const std::size_t NumUrls = 12;
+	LoopbackHttpServer Server([NumUrls](const LoopbackRequest& Request) {
+		const std::size_t Number = PageNumber(Request.Target);
+		LoopbackReply Reply = ServeElement(Number);
+		Reply.DelaySeconds = 0.02 * static_cast<double>(NumUrls - Number);
+		return Reply;
+	});
+
+	std::vector<std::string> Urls;
+	for (std::size_t Number = 0; Number < NumUrls; Number++) {
+		Urls.push_back(Server.GetUrl("/page/" + std::to_string(Number)));
+	}
+
+	ScrapeOptions Options;
+	Options.Fetch.MaxConnections = NumUrls;
+	Options.NumParsers = 3;
+	ScrapePipeline Pipeline(ElementSchema(), Options);
+	const TrainingSet Set = Pipeline.Run(Urls);
+
+	ASSERT_EQ(Set.GetNumExamples(), NumUrls);
+	ASSERT_EQ(Set.GetNumFeatures(), 2u);
+	for (std::size_t Row = 0; Row < NumUrls; Row++) {
+		EXPECT_DOUBLE_EQ(Set.GetOutputs()[Row], AtomicWeights[Row % AtomicWeights.size()]) << "row " << Row;
+		EXPECT_DOUBLE_EQ(Set.GetColumn(0).Get(Row), static_cast<double>(Row % ElementNames.size() + 1));
+	}
+	EXPECT_EQ(Pipeline.GetSummary().NumPages, NumUrls);
+	EXPECT_EQ(Pipeline.GetSummary().NumRows, NumUrls);
+	EXPECT_TRUE(Pipeline.GetSummary().Skipped.empty());
+}
+
+
+TEST(ScrapePipeline, SkipsFailedPagesAndPagesMissingAField)
+{
+	LoopbackHttpServer Server([](const LoopbackRequest& Request) {
+		if (Request.Target == "/missing") {
+			return ContentLengthReply(404, "<html><title>Not found</title></html>", {"Content-Type: text/html"});
+		}
+		if (Request.Target == "/stub") {
+			return ContentLengthReply(200, "<html><title>Stub</title><p>No infobox.</p></html>",
+			                          {"Content-Type: text/html"});
+		}
+		return ServeElement(PageNumber(Request.Target));
+	});
+
+	const std::vector<std::string> Urls = {Server.GetUrl("/page/0"), Server.GetUrl("/missing"),
+	                                       Server.GetUrl("/page/2"), Server.GetUrl("/stub")};
+	ScrapeOptions Options;
+	Options.Fetch.MaxAttempts = 1;
+	ScrapePipeline Pipeline(ElementSchema(), Options);
+	const TrainingSet Set = Pipeline.Run(Urls);
+
+	ASSERT_EQ(Set.GetNumExamples(), 2u);
+	EXPECT_DOUBLE_EQ(Set.GetOutputs()[0], AtomicWeights[0]);
+	EXPECT_DOUBLE_EQ(Set.GetOutputs()[1], AtomicWeights[2]);
+
+	const WebScraping::ScrapeSummary& Summary = Pipeline.GetSummary();
+	EXPECT_EQ(Summary.NumPages, 4u);
+	ASSERT_EQ(Summary.Skipped.size(), 2u);
+	EXPECT_EQ(Summary.Skipped[0].first, Urls[1]);
+	EXPECT_EQ(Summary.Skipped[0].second, "HTTP 404");
+	EXPECT_EQ(Summary.Skipped[1].first, Urls[3]);
+}
+
+
+TEST(ScrapePipeline, FetchesStayWithinTheWindowBehindASlowPage)
+{
+	// Page 0 stalls; with a window of two, nothing past page 1 may be
+	// requested until page 0 has been answered and ingested.
+	const std::size_t NumUrls = 10;
+	LoopbackHttpServer Server([](const LoopbackRequest& Request) {
+		LoopbackReply Reply = ServeElement(PageNumber(Request.Target));
+		if (PageNumber(Request.Target) == 0) {
+			Reply.DelaySeconds = 0.4;
+		}
+		return Reply;
+	});
+
+	std::vector<std::string> Urls;
+	for (std::size_t Number = 0; Number < NumUrls; Number++) {
+		Urls.push_back(Server.GetUrl("/page/" + std::to_string(Number)));
+	}
+	ScrapeOptions Options;
+	Options.Fetch.MaxConnections = 4;
+	Options.NumParsers = 1;
+	Options.QueueCapacity = 2;
+	ScrapePipeline Pipeline(ElementSchema(), Options);
+	const TrainingSet Set = Pipeline.Run(Urls);
+	ASSERT_EQ(Set.GetNumExamples(), NumUrls);
+
+	const std::vector<LoopbackRequest> Requests = Server.GetRequests();
+	double SlowReplied = -1.0;
+	for (const LoopbackRequest& Request : Requests) {
+		if (PageNumber(Request.Target) == 0) {
+			SlowReplied = Request.Replied;
+		}
+	}
+	ASSERT_GE(SlowReplied, 0.0);
+	for (const LoopbackRequest& Request : Requests) {
+		if (PageNumber(Request.Target) >= 2) {
+			EXPECT_GE(Request.Arrived, SlowReplied) << Request.Target;
+		}
+	}
+}
+
+
+TEST(ScrapePipeline, RejectsAnEmptySchemaOrNoWorkers)
+{
+	EXPECT_THROW(WebScraping::TrainingSetBuilder{RecordSchema()}, std::invalid_argument);
+
+	ScrapeOptions Options;
+	Options.NumParsers = 0;
+	EXPECT_THROW(ScrapePipeline(ElementSchema(), Options).Run({}), std::invalid_argument);
+}